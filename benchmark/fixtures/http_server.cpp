@@ -0,0 +1,204 @@
+#include "http_server.hpp"
+
+#include <mbgl/util/string.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace mbgl {
+namespace benchmark {
+
+namespace {
+
+const std::string etagValue = "\"fixture\"";
+
+// Clients may hang up before a response is complete, which must not raise SIGPIPE. macOS doesn't
+// have MSG_NOSIGNAL; accepted sockets set SO_NOSIGPIPE there instead.
+#ifdef MSG_NOSIGNAL
+const int sendFlags = MSG_NOSIGNAL;
+#else
+const int sendFlags = 0;
+#endif
+
+// Returns the value of the header, or an empty string if the request doesn't have it.
+std::string header(const std::string& request, std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    std::size_t start = request.find("\r\n");
+    while (start != std::string::npos && start + 2 < request.size()) {
+        start += 2;
+        const std::size_t end = request.find("\r\n", start);
+        const std::size_t colon = request.find(':', start);
+        if (end == std::string::npos || end == start) {
+            break;
+        }
+
+        if (colon != std::string::npos && colon < end) {
+            std::string key = request.substr(start, colon - start);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            if (key == name) {
+                std::size_t value = colon + 1;
+                while (value < end && request[value] == ' ') {
+                    value++;
+                }
+                return request.substr(value, end - value);
+            }
+        }
+
+        start = end;
+    }
+
+    return "";
+}
+
+bool sendAll(int connection, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t result = ::send(connection, data.data() + sent, data.size() - sent, sendFlags);
+        if (result <= 0) {
+            return false;
+        }
+        sent += result;
+    }
+    return true;
+}
+
+} // namespace
+
+HTTPServer::HTTPServer(std::string body_, Options options_)
+    : body(std::move(body_)), options(options_) {
+    listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error("can't create socket");
+    }
+
+    // Let the system pick a free port.
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t length = sizeof(address);
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 64) != 0 ||
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(listener);
+        throw std::runtime_error("can't listen on the loopback interface");
+    }
+
+    port = ntohs(address.sin_port);
+    acceptor = std::thread([this] { accept(); });
+}
+
+HTTPServer::~HTTPServer() {
+    stopping = true;
+
+    // Unblocks accept() and recv() in the other threads.
+    ::shutdown(listener, SHUT_RDWR);
+    acceptor.join();
+    ::close(listener);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const int connection : connections) {
+            ::shutdown(connection, SHUT_RDWR);
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const int connection : connections) {
+        ::close(connection);
+    }
+}
+
+std::string HTTPServer::url(const std::string& path) const {
+    return "http://127.0.0.1:" + util::toString(port) + path;
+}
+
+void HTTPServer::accept() {
+    while (!stopping) {
+        const int connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            continue;
+        }
+
+#ifdef SO_NOSIGPIPE
+        const int noSigPipe = 1;
+        ::setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            ::close(connection);
+            break;
+        }
+        connections.push_back(connection);
+        workers.emplace_back([this, connection] { serve(connection); });
+    }
+}
+
+void HTTPServer::serve(int connection) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (!stopping) {
+        const std::size_t end = buffer.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            const ssize_t received = ::recv(connection, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                break;
+            }
+            buffer.append(chunk, received);
+            continue;
+        }
+
+        // GET requests don't have a body, so the request ends with the headers.
+        const std::string request = buffer.substr(0, end + 4);
+        buffer.erase(0, end + 4);
+
+        if (options.latency > Duration::zero()) {
+            std::this_thread::sleep_for(options.latency);
+        }
+
+        if (!sendAll(connection, respond(request))) {
+            break;
+        }
+    }
+
+    // The descriptor is closed by the destructor, after it can no longer be shut down.
+    ::shutdown(connection, SHUT_RDWR);
+}
+
+std::string HTTPServer::respond(const std::string& request) {
+    requests++;
+
+    std::string headers;
+    if (options.etag) {
+        headers += "ETag: " + etagValue + "\r\n";
+    }
+    if (options.maxAge > 0) {
+        headers += "Cache-Control: max-age=" + util::toString(options.maxAge) + "\r\n";
+    } else {
+        headers += "Cache-Control: must-revalidate\r\n";
+    }
+
+    if (options.etag && header(request, "If-None-Match") == etagValue) {
+        notModified++;
+        return "HTTP/1.1 304 Not Modified\r\n" + headers + "\r\n";
+    }
+
+    return "HTTP/1.1 200 OK\r\n" + headers +
+           "Content-Length: " + util::toString(body.size()) + "\r\n\r\n" + body;
+}
+
+}
+}
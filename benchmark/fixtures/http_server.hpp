@@ -0,0 +1,66 @@
+#ifndef MBGL_BENCHMARK_HTTP_SERVER
+#define MBGL_BENCHMARK_HTTP_SERVER
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace benchmark {
+
+// Minimal HTTP/1.1 server on the loopback interface that returns the same body for every path,
+// so that storage benchmarks don't depend on the node test server. Every connection is served by
+// its own thread, and connections are kept alive.
+class HTTPServer : private util::noncopyable {
+public:
+    struct Options {
+        // Time that passes before each response is sent.
+        Duration latency = Duration::zero();
+
+        // Responses carry an ETag, and requests with a matching If-None-Match get a 304.
+        bool etag = true;
+
+        // Cache-Control max-age in seconds; with 0, responses must be revalidated every time.
+        int64_t maxAge = 0;
+    };
+
+    HTTPServer(std::string body, Options);
+    ~HTTPServer();
+
+    // Returns the URL of the path on this server.
+    std::string url(const std::string& path) const;
+
+    std::size_t getRequests() const { return requests; }
+    std::size_t getNotModified() const { return notModified; }
+
+private:
+    void accept();
+    void serve(int connection);
+    std::string respond(const std::string& request);
+
+    const std::string body;
+    const Options options;
+
+    int listener = -1;
+    uint16_t port = 0;
+
+    std::atomic<bool> stopping { false };
+    std::atomic<std::size_t> requests { 0 };
+    std::atomic<std::size_t> notModified { 0 };
+
+    std::thread acceptor;
+    std::mutex mutex;
+    std::vector<int> connections;
+    std::vector<std::thread> workers;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,6 @@
+#include "util.hpp"
+
+GTEST_API_ int main(int argc, char *argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,43 @@
+#include "util.hpp"
+
+#include <cstdio>
+
+namespace mbgl {
+namespace benchmark {
+
+Duration Result::perIteration() const {
+    if (iterations == 0) {
+        return Duration::zero();
+    }
+    return total / static_cast<Duration::rep>(iterations);
+}
+
+Result measure(const std::string& name,
+               const std::function<void()>& fn,
+               std::size_t minIterations,
+               Duration minDuration) {
+    // Warm up caches and lazily initialized state before timing anything.
+    fn();
+
+    Result result;
+    const TimePoint start = Clock::now();
+    do {
+        fn();
+        result.iterations++;
+        result.total = Clock::now() - start;
+    } while (result.iterations < minIterations || result.total < minDuration);
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(result.perIteration());
+    std::printf("[ BENCHMARK] %-48s %12lld ns/iter %10zu iterations\n", name.c_str(),
+                static_cast<long long>(ns.count()), result.iterations);
+    return result;
+}
+
+void compare(const std::string& name, const Result& baseline, const Result& candidate) {
+    const double before = std::chrono::duration<double>(baseline.perIteration()).count();
+    const double after = std::chrono::duration<double>(candidate.perIteration()).count();
+    std::printf("[ BENCHMARK] %-48s %11.2fx\n", name.c_str(), after > 0 ? before / after : 0.0);
+}
+
+}
+}
@@ -0,0 +1,34 @@
+#ifndef MBGL_BENCHMARK_UTIL
+#define MBGL_BENCHMARK_UTIL
+
+#include <gtest/gtest.h>
+
+#include <mbgl/util/chrono.hpp>
+
+#include <string>
+#include <functional>
+
+namespace mbgl {
+namespace benchmark {
+
+struct Result {
+    std::size_t iterations = 0;
+    Duration total = Duration::zero();
+
+    Duration perIteration() const;
+};
+
+// Runs the function repeatedly until it has been running for at least the minimum duration (and
+// at least the minimum number of iterations), then prints and returns the timing.
+Result measure(const std::string& name,
+               const std::function<void()>&,
+               std::size_t minIterations = 10,
+               Duration minDuration = std::chrono::milliseconds(500));
+
+// Prints a comparison between two results of the same workload.
+void compare(const std::string& name, const Result& baseline, const Result& candidate);
+
+}
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/style/filter_expression_private.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <rapidjson/document.h>
+
+#include <map>
+
+using namespace mbgl;
+
+namespace {
+
+struct StyleFilter {
+    std::string sourceLayer;
+    FilterExpression filter;
+    bool symbol;
+};
+
+// Extracts the filters of all layers of a real-world style.
+std::vector<StyleFilter> loadFilters(const std::string& path) {
+    const std::string json = util::read_file(path);
+    rapidjson::Document doc;
+    doc.Parse<0>(json.c_str());
+
+    std::vector<StyleFilter> filters;
+    const auto& layers = doc["layers"];
+    for (rapidjson::SizeType i = 0; i < layers.Size(); i++) {
+        const auto& layer = layers[i];
+        if (layer.HasMember("source-layer") && layer.HasMember("filter")) {
+            filters.push_back({ layer["source-layer"].GetString(),
+                                parseFilterExpression(layer["filter"]),
+                                layer["type"].GetString() == std::string("symbol") });
+        }
+    }
+    return filters;
+}
+
+std::size_t evaluateAll(const GeometryTileLayer& layer, const FilterExpression& filter) {
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < layer.featureCount(); i++) {
+        GeometryTileFeatureExtractor extractor(layer.getFeature(i));
+        matches += evaluate(filter, extractor);
+    }
+    return matches;
+}
+
+std::size_t countPoints(const GeometryCollection& geometries) {
+    std::size_t points = 0;
+    for (const auto& line : geometries) {
+        points += line.size();
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(Benchmark, FilterEvaluation) {
+    const auto filters = loadFilters("ios/benchmark/assets/styles/streets-v8.json");
+    const std::string data = util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf");
+    const VectorTile tile(pbf(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+
+    std::size_t rawMatches = 0;
+    const auto raw = benchmark::measure("FilterEvaluation raw", [&] {
+        rawMatches = 0;
+        for (const auto& filter : filters) {
+            if (auto layer = tile.getLayer(filter.sourceLayer)) {
+                rawMatches += evaluateAll(*layer, filter.filter);
+            }
+        }
+    });
+
+    std::size_t compiledMatches = 0;
+    const auto compiled = benchmark::measure("FilterEvaluation optimized", [&] {
+        compiledMatches = 0;
+        for (const auto& filter : filters) {
+            if (auto layer = tile.getLayer(filter.sourceLayer)) {
+                const FilterExpression optimized =
+                    compileFilterExpression(optimizeFilterExpression(filter.filter), *layer);
+                if (!isFalseFilter(optimized)) {
+                    compiledMatches += evaluateAll(*layer, optimized);
+                }
+            }
+        }
+    });
+
+    EXPECT_EQ(rawMatches, compiledMatches);
+    benchmark::compare("FilterEvaluation", raw, compiled);
+}
+
+TEST(Benchmark, FeaturePass) {
+    // Fill, line and circle buckets of a real-world style, compared between one pass over the
+    // source layer per bucket and one shared pass per source layer.
+    std::map<std::string, std::vector<FilterExpression>> groups;
+    for (auto& filter : loadFilters("ios/benchmark/assets/styles/streets-v8.json")) {
+        if (!filter.symbol) {
+            groups[filter.sourceLayer].push_back(optimizeFilterExpression(filter.filter));
+        }
+    }
+
+    for (const auto& path : { "test/fixtures/tiles/streets/15-17605-10749.vector.pbf",
+                              "test/fixtures/tiles/streets/15-17605-10750.vector.pbf" }) {
+        const std::string data = util::read_file(path);
+        const VectorTile tile(pbf(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+
+        std::size_t perBucketPoints = 0;
+        const auto perBucket = benchmark::measure(std::string("FeaturePass per bucket ") + path, [&] {
+            perBucketPoints = 0;
+            for (const auto& group : groups) {
+                const auto layer = tile.getLayer(group.first);
+                if (!layer) {
+                    continue;
+                }
+                for (const auto& rawFilter : group.second) {
+                    const FilterExpression filter = compileFilterExpression(rawFilter, *layer);
+                    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                        const auto& feature = layer->getFeature(i);
+                        if (evaluate(filter, GeometryTileFeatureExtractor(feature))) {
+                            perBucketPoints += countPoints(feature.getGeometries());
+                        }
+                    }
+                }
+            }
+        });
+
+        std::size_t sharedPoints = 0;
+        const auto shared = benchmark::measure(std::string("FeaturePass shared ") + path, [&] {
+            sharedPoints = 0;
+            GeometryCollection geometries;
+            std::vector<FilterExpression> filters;
+            for (const auto& group : groups) {
+                const auto layer = tile.getLayer(group.first);
+                if (!layer) {
+                    continue;
+                }
+                filters.clear();
+                for (const auto& rawFilter : group.second) {
+                    filters.push_back(compileFilterExpression(rawFilter, *layer));
+                }
+                for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                    const auto& feature = layer->getFeature(i);
+                    const GeometryTileFeatureExtractor extractor(feature);
+                    bool decoded = false;
+                    for (const auto& filter : filters) {
+                        if (evaluate(filter, extractor)) {
+                            if (!decoded) {
+                                feature.readGeometries(geometries);
+                                decoded = true;
+                            }
+                            sharedPoints += countPoints(geometries);
+                        }
+                    }
+                }
+            }
+        });
+
+        EXPECT_EQ(perBucketPoints, sharedPoints);
+        benchmark::compare(std::string("FeaturePass ") + path, perBucket, shared);
+    }
+}
@@ -0,0 +1,75 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::vector<std::string> fixtures = {
+    "test/fixtures/tiles/streets/0-0-0.vector.pbf",
+    "test/fixtures/tiles/streets/15-17605-10749.vector.pbf",
+    "test/fixtures/tiles/streets/15-17605-10750.vector.pbf",
+};
+
+const std::vector<std::string> layerNames = {
+    "water", "admin", "road", "landuse", "building", "poi_label", "road_label", "place_label",
+    "housenum_label", "bridge", "tunnel", "barrier_line", "water_label", "waterway_label",
+};
+
+VectorTile makeTile(const std::string& data) {
+    return VectorTile(pbf(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+}
+
+} // namespace
+
+TEST(Benchmark, VectorTileIndex) {
+    for (const auto& path : fixtures) {
+        const std::string data = util::read_file(path);
+        benchmark::measure("VectorTileIndex " + path, [&] {
+            auto tile = makeTile(data);
+        });
+    }
+}
+
+TEST(Benchmark, VectorTileSingleLayer) {
+    // Mimics a style that only references the road layer; all other layers stay untouched.
+    for (const auto& path : fixtures) {
+        const std::string data = util::read_file(path);
+        benchmark::measure("VectorTileSingleLayer " + path, [&] {
+            auto tile = makeTile(data);
+            auto layer = tile.getLayer("road");
+            if (!layer) {
+                return;
+            }
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                const auto& feature = layer->getFeature(i);
+                feature.getValue("class");
+                feature.getGeometries();
+            }
+        });
+    }
+}
+
+TEST(Benchmark, VectorTileFullDecode) {
+    for (const auto& path : fixtures) {
+        const std::string data = util::read_file(path);
+        benchmark::measure("VectorTileFullDecode " + path, [&] {
+            auto tile = makeTile(data);
+            for (const auto& name : layerNames) {
+                auto layer = tile.getLayer(name);
+                if (!layer) {
+                    continue;
+                }
+                for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                    const auto& feature = layer->getFeature(i);
+                    feature.getType();
+                    feature.getValue("class");
+                    feature.getValue("name");
+                    feature.getGeometries();
+                }
+            }
+        });
+    }
+}
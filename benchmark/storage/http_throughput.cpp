@@ -0,0 +1,156 @@
+#include "../fixtures/util.hpp"
+#include "../fixtures/http_server.hpp"
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/sqlite_cache.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <uv.h>
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace mbgl;
+
+namespace {
+
+const char* const path = "test/fixtures/database/benchmark_http.db";
+const std::size_t tileCount = 512;
+
+// Roughly the round trip time to a nearby server.
+const Duration latency = std::chrono::milliseconds(2);
+
+std::vector<std::string> makeURLs(const benchmark::HTTPServer& server, const std::string& prefix) {
+    std::vector<std::string> urls;
+    for (std::size_t i = 0; i < tileCount; i++) {
+        urls.push_back(server.url("/" + prefix + "/" + util::toString(i) + ".vector.pbf"));
+    }
+    return urls;
+}
+
+// Requests all URLs at once and returns the time it took until each of them had a fresh response.
+// With cancelEvery, every n-th request is canceled right after it was made.
+std::vector<Duration> load(DefaultFileSource& fs, const std::vector<std::string>& urls, std::size_t cancelEvery = 0) {
+    struct Pending {
+        Request* request = nullptr;
+        TimePoint start;
+    };
+
+    std::vector<Pending> pending(urls.size());
+    std::vector<Duration> latencies;
+
+    for (std::size_t i = 0; i < urls.size(); i++) {
+        pending[i].start = Clock::now();
+        pending[i].request = fs.request({ Resource::Tile, urls[i] }, uv_default_loop(), [&, i] (const Response& res) {
+            if (res.stale || !pending[i].request) {
+                // Wait for the revalidated response.
+                return;
+            }
+
+            EXPECT_EQ(Response::Successful, res.status);
+            latencies.push_back(Clock::now() - pending[i].start);
+            fs.cancel(pending[i].request);
+            pending[i].request = nullptr;
+        });
+
+        if (cancelEvery && i % cancelEvery == 0) {
+            fs.cancel(pending[i].request);
+            pending[i].request = nullptr;
+        }
+    }
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    return latencies;
+}
+
+void report(const std::string& name, std::vector<Duration> latencies, Duration total,
+            const benchmark::HTTPServer& server, std::size_t requests) {
+    ASSERT_FALSE(latencies.empty());
+    std::sort(latencies.begin(), latencies.end());
+
+    const auto percentile = [&] (std::size_t p) {
+        const auto value = latencies[std::min(latencies.size() - 1, latencies.size() * p / 100)];
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(value).count());
+    };
+
+    std::printf("[ BENCHMARK] %-48s %9.0f req/s %8lld us p50 %8lld us p99 %5zu sent\n", name.c_str(),
+                latencies.size() / std::chrono::duration<double>(total).count(),
+                percentile(50), percentile(99), server.getRequests() - requests);
+}
+
+template <typename Fn>
+void run(const std::string& name, const benchmark::HTTPServer& server, Fn&& fn) {
+    const std::size_t requests = server.getRequests();
+    const TimePoint start = Clock::now();
+    auto latencies = fn();
+    report(name, std::move(latencies), Clock::now() - start, server, requests);
+}
+
+} // namespace
+
+TEST(Benchmark, StorageThroughput) {
+    const std::string tile = util::read_file("test/fixtures/tiles/streets/15-17605-10750.vector.pbf");
+
+    benchmark::HTTPServer::Options fresh;
+    fresh.latency = latency;
+    fresh.maxAge = 3600;
+    benchmark::HTTPServer server(tile, fresh);
+
+    // Responses that are cached, but have to be revalidated before they can be used.
+    benchmark::HTTPServer::Options revalidate;
+    revalidate.latency = latency;
+    benchmark::HTTPServer revalidateServer(tile, revalidate);
+
+    std::remove(path);
+
+    // Every phase opens the database again, so that it doesn't wait for writes of the previous
+    // one, and every file source starts with an empty memory cache.
+    const auto urls = makeURLs(server, "tiles");
+    run("StorageThroughput cold", server, [&] {
+        SQLiteCache cache(path);
+        DefaultFileSource fs(&cache);
+        auto latencies = load(fs, urls);
+
+        const auto http = fs.getStatistics().http;
+        const auto average = [&] (Duration phase) {
+            return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                phase).count() / std::max<uint64_t>(http.requests, 1));
+        };
+        std::printf("[ BENCHMARK] %-48s %5llu connections %6lld us connect %6lld us first byte\n",
+                    "StorageThroughput cold", static_cast<unsigned long long>(http.connections),
+                    average(http.dns + http.connect + http.tls), average(http.firstByte));
+        return latencies;
+    });
+
+    run("StorageThroughput warm cache", server, [&] {
+        SQLiteCache cache(path);
+        DefaultFileSource fs(&cache);
+        return load(fs, urls);
+    });
+
+    const auto revalidateURLs = makeURLs(revalidateServer, "tiles");
+    {
+        SQLiteCache cache(path);
+        DefaultFileSource fs(&cache);
+        load(fs, revalidateURLs);
+    }
+
+    run("StorageThroughput revalidation", revalidateServer, [&] {
+        SQLiteCache cache(path);
+        DefaultFileSource fs(&cache);
+        return load(fs, revalidateURLs);
+    });
+    std::printf("[ BENCHMARK] %-48s %9zu not modified\n", "StorageThroughput revalidation",
+                revalidateServer.getNotModified());
+
+    run("StorageThroughput cancel half", server, [&] {
+        SQLiteCache cache(path);
+        DefaultFileSource fs(&cache);
+        return load(fs, makeURLs(server, "canceled"), 2);
+    });
+
+    std::remove(path);
+}
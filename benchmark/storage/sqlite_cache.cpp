@@ -0,0 +1,114 @@
+#include "../fixtures/util.hpp"
+
+#include "sqlite_cache_impl.hpp"
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <uv.h>
+
+#include <cstdio>
+
+using namespace mbgl;
+
+namespace {
+
+const char* const path = "test/fixtures/database/benchmark.db";
+const std::size_t tileCount = 256;
+
+std::vector<std::pair<Resource, std::shared_ptr<const Response>>> makeTiles() {
+    const auto data = std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10750.vector.pbf"));
+
+    std::vector<std::pair<Resource, std::shared_ptr<const Response>>> tiles;
+    for (std::size_t i = 0; i < tileCount; i++) {
+        auto response = std::make_shared<Response>();
+        response->status = Response::Successful;
+        response->data = data;
+        tiles.emplace_back(Resource{ Resource::Tile, "mapbox://tiles/" + std::to_string(i) }, response);
+    }
+    return tiles;
+}
+
+} // namespace
+
+TEST(Benchmark, SQLiteCachePut) {
+    util::RunLoop loop(uv_default_loop());
+    const auto tiles = makeTiles();
+
+    std::remove(path);
+    SQLiteCache::Impl cache(path);
+
+    // Every put is a separate transaction.
+    const auto single = benchmark::measure("SQLiteCachePut single", [&] {
+        for (const auto& tile : tiles) {
+            cache.put(tile.first, tile.second);
+        }
+    }, 3);
+
+    // Puts are queued and committed in batches, and reads are served from the queue.
+    const auto batched = benchmark::measure("SQLiteCachePut batched", [&] {
+        for (const auto& tile : tiles) {
+            cache.schedulePut(tile.first, tile.second);
+            cache.get(tile.first, [] (std::unique_ptr<Response>) {});
+        }
+        cache.flush();
+    }, 3);
+
+    benchmark::compare("SQLiteCachePut batched vs. single", single, batched);
+
+    const auto statistics = cache.getStatistics();
+    const auto commitTime = std::chrono::duration_cast<std::chrono::microseconds>(statistics.maxCommitTime);
+    std::printf("[ BENCHMARK] %-48s %12llu commits %7llu rows %8lld us max\n", "SQLiteCachePut statistics",
+                static_cast<unsigned long long>(statistics.commits),
+                static_cast<unsigned long long>(statistics.rows),
+                static_cast<long long>(commitTime.count()));
+
+    std::remove(path);
+}
+
+TEST(Benchmark, SQLiteCacheCodecs) {
+    std::vector<std::string> fixtures;
+    for (const auto& name : { "test/fixtures/tiles/streets/0-0-0.vector.pbf",
+                              "test/fixtures/tiles/streets/15-17605-10749.vector.pbf",
+                              "test/fixtures/tiles/streets/15-17605-10750.vector.pbf",
+                              "test/fixtures/resources/vector.pbf",
+                              "test/fixtures/resources/glyphs.pbf" }) {
+        fixtures.push_back(util::read_file(name));
+    }
+
+    std::size_t rawSize = 0;
+    for (const auto& fixture : fixtures) {
+        rawSize += fixture.size();
+    }
+
+    const std::vector<std::pair<std::string, util::Codec>> codecs = {
+        { "zlib", util::Codec::Zlib },
+        { "deflate", util::Codec::Deflate },
+    };
+
+    // Decoding is what every cache hit pays for; the size is what the cache can hold.
+    std::vector<benchmark::Result> results;
+    for (const auto& codec : codecs) {
+        std::vector<std::string> encoded;
+        std::size_t encodedSize = 0;
+        for (const auto& fixture : fixtures) {
+            encoded.push_back(util::encode(codec.second, fixture));
+            encodedSize += encoded.back().size();
+        }
+
+        results.push_back(benchmark::measure("SQLiteCacheCodecs decode " + codec.first, [&] {
+            for (const auto& data : encoded) {
+                util::decode(codec.second, data.data(), data.size());
+            }
+        }));
+
+        std::printf("[ BENCHMARK] %-48s %12zu bytes %7.1f%% of %zu\n",
+                    ("SQLiteCacheCodecs size " + codec.first).c_str(), encodedSize,
+                    100.0 * encodedSize / rawSize, rawSize);
+    }
+
+    benchmark::compare("SQLiteCacheCodecs deflate vs. zlib", results[0], results[1]);
+}
@@ -0,0 +1,102 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/text/glyph_store.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string stackName = "Open Sans Regular";
+
+const std::vector<std::u32string> labels = {
+    U"Main Street", U"Market Street", U"Broadway", U"Elm Street", U"Pennsylvania Avenue",
+    U"Central Park", U"Union Square", U"Golden Gate Bridge", U"Fisherman's Wharf", U"Mission",
+};
+
+// Number of labels in a symbol bucket.
+const std::size_t bucketSize = 100;
+
+// Owns the GlyphStore on a thread of the Map type, which is where glyph ranges are loaded.
+class GlyphStoreThread {
+public:
+    GlyphStoreThread() {
+        FontStack fontStack;
+        for (uint32_t id = 0; id < 256; id++) {
+            SDFGlyph glyph;
+            glyph.id = id;
+            glyph.metrics.width = 14;
+            glyph.metrics.height = 18;
+            glyph.metrics.advance = 12;
+            fontStack.insert(id, glyph);
+        }
+        fontStack.addRange({ 0, 255 });
+        store.setFontStack(stackName, std::move(fontStack));
+    }
+
+    GlyphStore* get() {
+        return &store;
+    }
+
+private:
+    GlyphStore store;
+};
+
+// What a worker does with the GlyphStore for a symbol bucket.
+void layoutBucket(GlyphStore& store) {
+    if (!store.hasGlyphRanges(stackName, {{ 0, 255 }})) {
+        return;
+    }
+
+    const FontStack& fontStack = store.getFontStack(stackName);
+    for (std::size_t i = 0; i < bucketSize; i++) {
+        fontStack.getShaping(labels[i % labels.size()], 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 });
+    }
+}
+
+} // namespace
+
+TEST(Benchmark, GlyphStoreScaling) {
+    const util::ThreadContext context = { "Map", util::ThreadType::Map, util::ThreadPriority::Regular };
+    util::Thread<GlyphStoreThread> thread(context);
+    GlyphStore& store = *thread.invokeSync<GlyphStore*>(&GlyphStoreThread::get);
+
+    // Every thread lays out the same number of buckets, so that perfect scaling keeps the time
+    // per iteration constant.
+    const std::size_t bucketsPerThread = 64;
+    const std::size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+
+    Duration single = Duration::zero();
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        const auto result = benchmark::measure("GlyphStoreScaling " + std::to_string(threads) + " threads", [&] {
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; t++) {
+                workers.emplace_back([&] {
+                    for (std::size_t i = 0; i < bucketsPerThread; i++) {
+                        layoutBucket(store);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+
+        if (threads == 1) {
+            single = result.perIteration();
+        }
+
+        const double seconds = std::chrono::duration<double>(result.perIteration()).count();
+        const double speedup = double(threads) * std::chrono::duration<double>(single).count() / seconds;
+        std::printf("[ BENCHMARK] %-48s %9.0f buckets/s %6.2fx\n",
+                    ("GlyphStoreScaling " + std::to_string(threads) + " threads").c_str(),
+                    threads * bucketsPerThread / seconds, speedup);
+    }
+}
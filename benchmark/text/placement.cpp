@@ -0,0 +1,119 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/get_anchors.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace mbgl;
+
+namespace {
+
+// Street level tiles with many road, POI and house number labels.
+const std::vector<std::string> fixtures = {
+    "test/fixtures/tiles/streets/15-17605-10749.vector.pbf",
+    "test/fixtures/tiles/streets/15-17605-10750.vector.pbf",
+};
+
+struct LabelLayer {
+    std::string name;
+    bool isLine;
+};
+
+const std::vector<LabelLayer> labelLayers = {
+    { "road_label", true },
+    { "waterway_label", true },
+    { "poi_label", false },
+    { "place_label", false },
+    { "water_label", false },
+    { "housenum_label", false },
+};
+
+// Approximates the layout of the symbol bucket with the default text properties: 16px text with
+// glyphs that are 14px wide on average, at a tile pixel ratio of 8.
+const float tilePixelRatio = 8;
+const float glyphSize = 24;
+const float boxScale = tilePixelRatio * 16 / glyphSize;
+const float padding = 2 * tilePixelRatio;
+const float spacing = 250 * tilePixelRatio;
+const float maxAngle = 45 * M_PI / 180;
+
+std::vector<CollisionFeature> makeFeatures(const std::string& path) {
+    const std::string data = util::read_file(path);
+    VectorTile tile(pbf(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+
+    std::vector<CollisionFeature> features;
+    for (const auto& labelLayer : labelLayers) {
+        auto layer = tile.getLayer(labelLayer.name);
+        if (!layer) {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            const auto& feature = layer->getFeature(i);
+            const auto name = feature.getValue(labelLayer.name == "housenum_label" ? "house_num" : "name");
+            if (!name || !name->is<std::string>()) {
+                continue;
+            }
+
+            const float width = name->get<std::string>().size() * 14;
+            const float left = -width / 2;
+            const float right = width / 2;
+
+            for (const auto& line : feature.getGeometries()) {
+                if (line.empty()) {
+                    continue;
+                }
+
+                const Anchors anchors = labelLayer.isLine ?
+                    getAnchors(line, spacing, maxAngle, left, right, 0, 0, glyphSize, boxScale, 1) :
+                    Anchors({ Anchor(float(line[0].x), float(line[0].y), 0, 0.5f) });
+
+                for (const auto& anchor : anchors) {
+                    features.emplace_back(line, anchor, -12.0f, 12.0f, left, right, boxScale,
+                                          padding, labelLayer.isLine);
+                }
+            }
+        }
+    }
+    return features;
+}
+
+} // namespace
+
+TEST(Benchmark, Placement) {
+    for (const auto& path : fixtures) {
+        auto features = makeFeatures(path);
+
+        std::size_t placed = 0;
+        std::size_t boxes = 0;
+        for (const auto& feature : features) {
+            boxes += feature.boxes.size();
+        }
+
+        for (const float angle : { 0.0f, float(M_PI / 6) }) {
+            PlacementConfig config(angle, 0, false);
+            const std::string name = "Placement " + path.substr(path.rfind('/') + 1) +
+                                     (angle ? " rotated" : "");
+            benchmark::measure(name, [&] {
+                CollisionTile collisionTile(config);
+                placed = 0;
+                for (auto& feature : features) {
+                    const float scale = collisionTile.placeFeature(feature);
+                    if (scale < collisionTile.maxScale) {
+                        placed++;
+                    }
+                    collisionTile.insertFeature(feature, scale);
+                }
+            });
+        }
+
+        std::printf("[ BENCHMARK] %-48s %6zu features %6zu boxes %6zu placed\n",
+                    ("Placement " + path.substr(path.rfind('/') + 1)).c_str(),
+                    features.size(), boxes, placed);
+    }
+}
@@ -6,5 +6,6 @@
   'conditions': [
     ['test', { 'includes': [ '../test/test.gypi' ] } ],
     ['render', { 'includes': [ '../bin/render.gypi' ] } ],
+    ['benchmark', { 'includes': [ '../benchmark/benchmark.gypi' ] } ],
   ],
 }
@@ -4,5 +4,6 @@
     '../linux/mapboxgl-app.gypi',
     '../test/test.gypi',
     '../bin/render.gypi',
+    '../benchmark/benchmark.gypi',
   ],
 }
@@ -160,6 +160,14 @@ public:
 
     // Memory
     void setSourceTileCacheSize(size_t);
+    void setSourceTileCacheBytes(size_t);
+    // Zoom levels above the visible tiles at which their ancestors are kept loaded as well.
+    // Applies to the sources of the current style and of styles that are loaded afterwards.
+    void setSourceParentPrefetchLevels(std::vector<int32_t>);
+    // Parsed tiles are stored in this existing directory, so that they can be loaded again without
+    // parsing them. Applies to tiles that are loaded afterwards; an empty path disables the cache.
+    // The least recently used files are removed once the directory holds more than 256 MB of them.
+    void setBucketCachePath(const std::string&);
     void onLowMemory();
 
     // Debug
@@ -3,6 +3,7 @@
 
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/file_cache.hpp>
+#include <mbgl/util/chrono.hpp>
 
 namespace mbgl {
 
@@ -21,6 +22,64 @@ public:
     // FileSource API
     Request* request(const Resource&, uv_loop_t*, Callback) override;
     void cancel(Request*) override;
+    void setPriority(Request*, double rank, bool prefetch) override;
+
+    // Network requests wait in a queue until a connection is available.
+    struct Statistics {
+        struct Wait {
+            uint64_t started = 0; // Number of requests that left the queue.
+            Duration total = Duration::zero();
+            Duration max = Duration::zero();
+        };
+
+        std::size_t queued = 0;    // Requests currently waiting for a connection.
+        std::size_t maxQueued = 0; // Largest number of requests that were waiting at the same time.
+        std::size_t active = 0;    // Requests currently using a connection.
+
+        Wait style;     // Styles and TileJSON documents.
+        Wait resources; // Glyphs, sprites and other resources.
+        Wait tiles;     // Tiles that are visible.
+        Wait prefetch;  // Tiles that aren't visible yet.
+
+        // Responses with a known expiry time are revalidated in batches by a single timer.
+        struct Expiry {
+            std::size_t pending = 0;    // Responses that are waiting to expire.
+            uint64_t wakeups = 0;       // Number of times the timer fired.
+            uint64_t revalidations = 0; // Responses that were revalidated after they expired.
+        };
+
+        Expiry expiry;
+
+        // Phases of the HTTP requests that completed, added up. Requests that reuse a connection
+        // don't spend time on resolving the host, connecting or negotiating TLS. Platforms that
+        // can't measure the phases report zero.
+        struct HTTP {
+            uint64_t requests = 0;    // Requests that completed.
+            uint64_t connections = 0; // Connections that were opened for them.
+            Duration dns = Duration::zero();
+            Duration connect = Duration::zero();
+            Duration tls = Duration::zero();
+            Duration firstByte = Duration::zero(); // Waiting for the server after the request was sent.
+            Duration transfer = Duration::zero();
+        };
+
+        HTTP http;
+    };
+
+    Statistics getStatistics();
+
+    // Recently used responses are also kept in memory, so that they can be returned without
+    // going through the FileCache. A size of 0 disables the memory cache.
+    void setMemoryCacheSize(std::size_t bytes);
+    FileCache::Usage getMemoryCacheUsage();
+
+    // Requests to the same host share HTTP/2 connections when the server supports it, instead of
+    // each opening a connection of its own. Enabled by default.
+    void setHTTPMultiplexing(bool);
+
+    // Limits the number of connections to each host; further requests wait for a connection to
+    // become available. A value of 0 removes the limit.
+    void setMaxConnectionsPerHost(std::size_t);
 
 public:
     class Impl;
@@ -3,8 +3,11 @@
 
 #include <mbgl/util/noncopyable.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace mbgl {
 
@@ -21,6 +24,24 @@ public:
 
     virtual std::unique_ptr<WorkRequest> get(const Resource &resource, Callback callback) = 0;
     virtual void put(const Resource &resource, std::shared_ptr<const Response> response, Hint hint) = 0;
+
+    struct Usage {
+        uint64_t size = 0;   // Bytes used by the stored responses.
+        uint64_t hits = 0;   // Number of get() calls that found a response.
+        uint64_t misses = 0; // Number of get() calls that didn't.
+    };
+
+    // Blocks until the usage has been determined.
+    virtual Usage getUsage() = 0;
+
+    // Offline packs are named sets of responses that must stay available without a network
+    // connection. Responses that belong to a pack are never evicted until the pack is removed.
+    using PackCallback = std::function<void(std::vector<std::string> urls)>;
+
+    virtual void addToPack(const std::string& pack, const Resource&) = 0;
+    // Invokes the callback with the canonical URLs of the responses that belong to the pack.
+    virtual std::unique_ptr<WorkRequest> getPack(const std::string& pack, PackCallback) = 0;
+    virtual void removePack(const std::string& pack) = 0;
 };
 
 }
@@ -28,6 +28,9 @@ public:
     // You can only cancel a request from the same thread it was created in.
     virtual Request* request(const Resource&, uv_loop_t*, Callback) = 0;
     virtual void cancel(Request*) = 0;
+
+    // Changes the priority of a request that may still be waiting; see Request::setPriority().
+    virtual void setPriority(Request*, double rank, bool prefetch);
 };
 
 }
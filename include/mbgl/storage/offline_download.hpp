@@ -0,0 +1,72 @@
+#ifndef MBGL_STORAGE_OFFLINE_DOWNLOAD
+#define MBGL_STORAGE_OFFLINE_DOWNLOAD
+
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class FileSource;
+class FileCache;
+
+// The area that should be available without a network connection.
+struct OfflineRegion {
+    std::string styleURL;
+
+    // A region whose southwest longitude is greater than its northeast longitude crosses the
+    // antimeridian.
+    LatLngBounds bounds;
+    double minZoom = 0;
+    double maxZoom = 16;
+    float pixelRatio = 1;
+
+    // The token that the file source uses for mapbox:// URLs. It determines how the responses are
+    // stored in the cache, so that resources that are in the pack already aren't requested again.
+    std::string accessToken;
+};
+
+// Downloads everything that is needed to render a region: the style, the TileJSON of its sources,
+// the sprite, the glyphs of all fonts used by the style, and every tile in the region. Responses
+// are added to an offline pack in the cache as they arrive, so that they are never evicted.
+//
+// A download can be interrupted at any time by destroying it. A later download of the same pack
+// skips the resources that were added to the pack already, even if they have expired since.
+//
+// Must be created on a thread that has a RunLoop. The callback is invoked on that thread whenever
+// a resource has been downloaded, and must not destroy the download.
+class OfflineDownload : private util::noncopyable {
+public:
+    struct Progress {
+        uint64_t completedResources = 0;
+        uint64_t failedResources = 0;
+        uint64_t completedBytes = 0;
+
+        // Grows while the style and TileJSON documents are being loaded.
+        uint64_t requiredResources = 0;
+
+        // All required resources are known, and all of them have completed or failed.
+        bool complete = false;
+    };
+
+    using Callback = std::function<void(const Progress&)>;
+
+    OfflineDownload(const std::string& pack, const OfflineRegion&, FileSource&, FileCache&, Callback);
+    ~OfflineDownload();
+
+    // Number of requests that are in flight at the same time.
+    static const std::size_t maxConcurrentRequests;
+
+    class Impl;
+
+private:
+    const std::unique_ptr<Impl> impl;
+};
+
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <functional>
@@ -31,6 +32,15 @@ public:
     // May be called only from the thread the Request was created in.
     void cancel();
 
+    // Network requests that have to wait for a free connection are started in order of their
+    // rank, lowest first; the map ranks tiles by their distance from the center of the viewport.
+    // Prefetch requests start after all other requests. Use FileSource::setPriority(), so that
+    // the file source can reorder the requests that are waiting. Returns whether the priority
+    // changed.
+    bool setPriority(double rank, bool prefetch = false);
+    double getRank() const { return rank; }
+    bool isPrefetch() const { return prefetch; }
+
 private:
     ~Request();
     void notifyCallback();
@@ -42,6 +52,8 @@ private:
     const std::unique_ptr<uv::async> async;
     Callback callback;
     std::shared_ptr<const Response> response;
+    std::atomic<double> rank { 0 };
+    std::atomic<bool> prefetch { false };
 
 public:
     const Resource resource;
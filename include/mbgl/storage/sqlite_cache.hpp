@@ -2,7 +2,10 @@
 #define MBGL_STORAGE_DEFAULT_SQLITE_CACHE
 
 #include <mbgl/storage/file_cache.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/codec.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
@@ -19,6 +22,38 @@ public:
     // FileCache API
     std::unique_ptr<WorkRequest> get(const Resource &resource, Callback callback) override;
     void put(const Resource &resource, std::shared_ptr<const Response> response, Hint hint) override;
+    Usage getUsage() override;
+    void addToPack(const std::string& pack, const Resource&) override;
+    std::unique_ptr<WorkRequest> getPack(const std::string& pack, PackCallback) override;
+    void removePack(const std::string& pack) override;
+
+    // Once the database grows beyond this size, responses are evicted: expired ones first, then
+    // tiles that haven't been used for the longest time, and only then styles, sources, glyphs
+    // and sprites. A size of 0 disables eviction.
+    static const uint64_t defaultMaximumSize;
+    void setMaximumSize(uint64_t size);
+
+    // Codec that new responses are stored with, Codec::Deflate by default. Responses are readable
+    // regardless of the codec they were stored with.
+    void setCodec(util::Codec);
+
+    // Responses are not written one by one. They're queued, and the queue is committed in a single
+    // transaction once it is full or after a short delay. Queued responses are returned by get()
+    // before they've been committed.
+    struct Statistics {
+        std::size_t queued = 0;    // Writes currently waiting to be committed.
+        std::size_t maxQueued = 0; // Largest number of writes that were waiting at the same time.
+        uint64_t commits = 0;      // Number of transactions committed.
+        uint64_t rows = 0;         // Number of writes committed.
+        Duration totalCommitTime = Duration::zero();
+        Duration maxCommitTime = Duration::zero();
+        uint64_t evictions = 0;    // Number of responses evicted to stay within the maximum size.
+    };
+
+    Statistics getStatistics();
+
+    // Blocks until all queued writes have been committed.
+    void flush();
 
     class Impl;
 
@@ -0,0 +1,21 @@
+#ifndef MBGL_UTIL_CODEC
+#define MBGL_UTIL_CODEC
+
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+// Formats that data can be stored in. The values are persisted along with the data, e.g. in the
+// cache database, so they must never change; new codecs get new values.
+enum class Codec : uint8_t {
+    None = 0,
+    Zlib = 1,    // zlib stream, as written by compress().
+    Deflate = 2, // Raw deflate stream without checksum, prefixed with the uncompressed size, so
+                 // that it can be inflated in a single pass into a buffer of the right size.
+};
+
+}
+}
+
+#endif
@@ -18,9 +18,11 @@
 
 #include <queue>
 #include <map>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 #if UV_VERSION_MAJOR == 0 && UV_VERSION_MINOR <= 10
 #define UV_TIMER_PARAMS(timer) uv_timer_t *timer, int
@@ -42,6 +44,9 @@ void handleError(CURLcode code) {
 
 namespace mbgl {
 
+// Largest Content-Length that is allocated up front.
+const std::size_t maxReservedLength = 32 * 1024 * 1024;
+
 class HTTPCURLRequest;
 
 class HTTPCURLContext : public HTTPContextBase {
@@ -56,6 +61,12 @@ public:
                                uv_loop_t*,
                                std::shared_ptr<const Response>) final;
 
+    void setMultiplexing(bool) final;
+    void setMaxConnectionsPerHost(std::size_t) final;
+
+    // Adds the phases of a completed transfer to the statistics.
+    void recordTiming(CURL *handle);
+
     static int handleSocket(CURL *handle, curl_socket_t s, int action, void *userp, void *socketp);
     static void perform(uv_poll_t *req, int status, int events);
     static int startTimeout(CURLM *multi, long timeout_ms, void *userp);
@@ -74,9 +85,14 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state (e.g. resolved hosts and TLS sessions)
+    // between the easy handles, so that new connections to the same host are cheaper to set up.
+    // All handles are used on this thread, so the share doesn't need lock functions.
     CURLSH *share = nullptr;
 
+    // Whether requests may be multiplexed over a single HTTP/2 connection.
+    bool multiplexing = true;
+
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
@@ -113,6 +129,9 @@ private:
     std::shared_ptr<std::string> data;
     std::unique_ptr<Response> response;
 
+    // Value of the Content-Length header; used to allocate the data in one go.
+    std::size_t contentLength = 0;
+
     // In case of revalidation requests, this will store the old response.
     const std::shared_ptr<const Response> existingResponse;
 
@@ -178,12 +197,19 @@ HTTPCURLContext::HTTPCURLContext(uv_loop_t *loop_)
     uv_timer_init(loop, timeout);
 
     share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (23) << 8 | 0) // Added in 7.23.0
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#endif
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+
+    setMultiplexing(true);
+    setMaxConnectionsPerHost(6);
 }
 
 HTTPCURLContext::~HTTPCURLContext() {
@@ -209,6 +235,54 @@ HTTPRequestBase* HTTPCURLContext::createRequest(const Resource& resource,
     return new HTTPCURLRequest(this, resource, callback, loop_, response);
 }
 
+void HTTPCURLContext::setMultiplexing(bool enabled) {
+    MBGL_VERIFY_THREAD(tid);
+
+    multiplexing = enabled;
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, enabled ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING));
+#endif
+}
+
+void HTTPCURLContext::setMaxConnectionsPerHost(std::size_t connections) {
+    MBGL_VERIFY_THREAD(tid);
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (30) << 8 | 0) // Added in 7.30.0
+    handleError(curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(connections)));
+#else
+    (void)connections;
+#endif
+}
+
+void HTTPCURLContext::recordTiming(CURL *handle) {
+    double nameLookup = 0, connect = 0, appConnect = 0, startTransfer = 0, total = 0;
+    long connects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &nameLookup);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &appConnect);
+    curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME, &startTransfer);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &total);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+
+    // All times are measured from the start of the request. A reused connection reports the
+    // time it took to pick it up, and an unencrypted one doesn't report a TLS handshake.
+    const auto duration = [] (double seconds) {
+        return std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(std::max(seconds, 0.0)));
+    };
+    const double established = std::max(connect, appConnect);
+
+    statistics.requests++;
+    statistics.connections += connects;
+    statistics.dns += duration(nameLookup);
+    statistics.connect += duration(connect - nameLookup);
+    if (appConnect > 0) {
+        statistics.tls += duration(appConnect - connect);
+    }
+    statistics.firstByte += duration(startTransfer - established);
+    statistics.transfer += duration(total - startTransfer);
+}
+
 CURL *HTTPCURLContext::getHandle() {
     if (!handles.empty()) {
         auto handle = handles.front();
@@ -471,6 +545,18 @@ HTTPCURLRequest::HTTPCURLRequest(HTTPCURLContext* context_, const Resource& reso
 #endif
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (25) << 8 | 0) // Added in 7.25.0
+    handleError(curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+    // Older versions of curl may lack HTTP/2 support, in which case this is an error.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION,
+                     context->multiplexing ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    // Rather wait for a connection that can be multiplexed than open another one.
+    handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, context->multiplexing ? 1 : 0));
+#endif
 
     start();
 }
@@ -518,6 +604,9 @@ size_t HTTPCURLRequest::writeCallback(void *const contents, const size_t size, c
 
     if (!impl->data) {
         impl->data = std::make_shared<std::string>();
+        // The header is the exact size for responses that aren't content-encoded, such as images,
+        // and a lower bound for the others. The limit guards against bogus headers.
+        impl->data->reserve(std::min(impl->contentLength, maxReservedLength));
     }
 
     impl->data->append((char *)contents, size * nmemb);
@@ -564,6 +653,9 @@ size_t HTTPCURLRequest::headerCallback(char *const buffer, const size_t size, co
     } else if ((begin = headerMatches("expires: ", buffer, length)) != std::string::npos) {
         const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
         baton->response->expires = curl_getdate(value.c_str(), nullptr);
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        baton->contentLength = std::strtoull(value.c_str(), nullptr, 10);
     }
 
     return length;
@@ -572,7 +664,10 @@ size_t HTTPCURLRequest::headerCallback(char *const buffer, const size_t size, co
 void HTTPCURLRequest::retry(uint64_t timeout) {
     handleError(curl_multi_remove_handle(context->multi, handle));
 
+    // Don't prepend the partial data of this attempt to the next one.
     response.reset();
+    data.reset();
+    contentLength = 0;
 
     assert(!timer);
     timer = new uv_timer_t;
@@ -657,6 +752,8 @@ void HTTPCURLRequest::handleResult(CURLcode code) {
             return finish(ResponseStatus::PermanentError);
         }
     } else {
+        context->recordTiming(handle);
+
         long responseCode = 0;
         curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
 
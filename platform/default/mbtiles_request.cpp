@@ -0,0 +1,261 @@
+#include <mbgl/storage/mbtiles_context_base.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+#include <mbgl/util/util.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+using namespace mapbox::sqlite;
+
+namespace {
+
+const std::string protocol = "mbtiles://";
+
+// Archives are read through a memory map of up to this size, so that reading a tile neither
+// copies pages into SQLite's page cache nor goes through a read() syscall.
+const int64_t mmapSize = int64_t(1) << 30;
+
+bool isCompressed(const std::pair<const char *, std::size_t>& blob) {
+    if (blob.second < 2) {
+        return false;
+    }
+    const uint8_t first = blob.first[0];
+    const uint8_t second = blob.first[1];
+    // A gzip magic number, or a zlib header that uses deflate and has a valid checksum. Neither
+    // can be the start of a PNG, JPEG, WebP or uncompressed vector tile.
+    return (first == 0x1F && second == 0x8B) ||
+           ((first & 0x0F) == 8 && (first * 256 + second) % 31 == 0);
+}
+
+// Splits mbtiles://path/to/archive.mbtiles/{z}/{x}/{y} into the path of the archive and the
+// coordinates of the tile.
+bool parseTileURL(const std::string& url, std::string& path, int32_t coordinates[3]) {
+    path = url.substr(protocol.size());
+    for (int i = 2; i >= 0; i--) {
+        const auto slash = path.rfind('/');
+        if (slash == std::string::npos || slash + 1 == path.size()) {
+            return false;
+        }
+
+        char* end = nullptr;
+        const long value = std::strtol(path.c_str() + slash + 1, &end, 10);
+        if (*end != '\0' || value < 0 || value > (i == 0 ? 30 : (1l << 30) - 1)) {
+            return false;
+        }
+        coordinates[i] = int32_t(value);
+        path.erase(slash);
+    }
+
+    // Columns and rows have to exist at the zoom level, since the row is flipped for TMS.
+    const int32_t tiles = 1 << coordinates[0];
+    return coordinates[1] < tiles && coordinates[2] < tiles;
+}
+
+// MBTiles stores bounds and center as comma separated lists of numbers.
+std::vector<double> parseNumbers(const std::string& value) {
+    std::vector<double> numbers;
+    const char* it = value.c_str();
+    while (*it) {
+        char* end = nullptr;
+        numbers.push_back(std::strtod(it, &end));
+        if (end == it) {
+            return {};
+        }
+        it = *end == ',' ? end + 1 : end;
+    }
+    return numbers;
+}
+
+} // namespace
+
+class MBTilesReader {
+public:
+    using Callback = std::function<void(std::unique_ptr<Response>)>;
+
+    void read(const Resource&, Callback);
+
+private:
+    struct Archive {
+        Archive(const std::string& path);
+
+        Database db;
+        Statement tileStmt;
+    };
+
+    Archive& open(const std::string& path);
+    std::unique_ptr<Response> readTile(Archive&, const int32_t coordinates[3]);
+    std::unique_ptr<Response> readTileJSON(Archive&, const std::string& url);
+
+    // Archives stay open for as long as the file source exists.
+    std::unordered_map<std::string, std::unique_ptr<Archive>> archives;
+};
+
+MBTilesReader::Archive::Archive(const std::string& path)
+    : db(path, ReadOnly),
+      tileStmt(db.prepare("SELECT `tile_data` FROM `tiles` "
+                          "WHERE `zoom_level` = ? AND `tile_column` = ? AND `tile_row` = ?")) {
+    db.exec("PRAGMA mmap_size = " + std::to_string(mmapSize));
+}
+
+MBTilesReader::Archive& MBTilesReader::open(const std::string& path) {
+    auto it = archives.find(path);
+    if (it == archives.end()) {
+        it = archives.emplace(path, std::make_unique<Archive>(util::percentDecode(path))).first;
+    }
+    return *it->second;
+}
+
+void MBTilesReader::read(const Resource& resource, Callback callback) {
+    std::unique_ptr<Response> response;
+
+    try {
+        if (resource.kind == Resource::Kind::Tile) {
+            std::string path;
+            int32_t coordinates[3];
+            if (!parseTileURL(resource.url, path, coordinates)) {
+                response = std::make_unique<Response>();
+                response->message = "Invalid MBTiles tile URL";
+            } else {
+                response = readTile(open(path), coordinates);
+            }
+        } else {
+            response = readTileJSON(open(resource.url.substr(protocol.size())), resource.url);
+        }
+    } catch (const std::exception& ex) {
+        response = std::make_unique<Response>();
+        response->status = Response::Error;
+        response->message = ex.what();
+    }
+
+    callback(std::move(response));
+}
+
+std::unique_ptr<Response> MBTilesReader::readTile(Archive& archive, const int32_t coordinates[3]) {
+    const int32_t z = coordinates[0];
+    // MBTiles uses the TMS scheme, which numbers rows from the south.
+    const int32_t row = (1 << z) - 1 - coordinates[2];
+
+    Statement& stmt = archive.tileStmt;
+    stmt.reset();
+    stmt.bind(1, z);
+    stmt.bind(2, coordinates[1]);
+    stmt.bind(3, row);
+
+    auto response = std::make_unique<Response>();
+    if (!stmt.run()) {
+        response->status = Response::NotFound;
+        return response;
+    }
+
+    // Decompress straight from the memory map; the tile is copied exactly once, into the buffer
+    // that the response owns.
+    const auto blob = stmt.getBlob(0);
+    if (isCompressed(blob)) {
+        response->data = std::make_shared<std::string>(util::decompress(blob.first, blob.second));
+    } else {
+        response->data = std::make_shared<std::string>(blob.first, blob.second);
+    }
+    response->status = Response::Successful;
+
+    // Release the read lock; the blob must not be used anymore.
+    stmt.reset();
+    return response;
+}
+
+std::unique_ptr<Response> MBTilesReader::readTileJSON(Archive& archive, const std::string& url) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+    writer.String("tilejson");
+    writer.String("2.0.0");
+    writer.String("tiles");
+    writer.StartArray();
+    writer.String((url + "/{z}/{x}/{y}").c_str());
+    writer.EndArray();
+
+    Statement stmt = archive.db.prepare("SELECT `name`, `value` FROM `metadata`");
+    while (stmt.run()) {
+        const auto name = stmt.get<std::string>(0);
+        const auto value = stmt.get<std::string>(1);
+
+        if (name == "minzoom" || name == "maxzoom") {
+            writer.String(name.c_str());
+            writer.Int(std::atoi(value.c_str()));
+        } else if (name == "bounds" || name == "center") {
+            writer.String(name.c_str());
+            writer.StartArray();
+            for (const double number : parseNumbers(value)) {
+                writer.Double(number);
+            }
+            writer.EndArray();
+        } else if (name == "name" || name == "attribution" || name == "description") {
+            writer.String(name.c_str());
+            writer.String(value.c_str());
+        }
+    }
+
+    writer.EndObject();
+
+    auto response = std::make_unique<Response>();
+    response->status = Response::Successful;
+    response->data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+    return response;
+}
+
+class MBTilesRequest : public RequestBase {
+    MBGL_STORE_THREAD(tid)
+
+public:
+    MBTilesRequest(const Resource& resource_, Callback callback_, util::Thread<MBTilesReader>& reader)
+        : RequestBase(resource_, callback_) {
+        workRequest = reader.invokeWithCallback(&MBTilesReader::read, [this] (std::unique_ptr<Response> response) {
+            MBGL_VERIFY_THREAD(tid);
+            notify(std::move(response), FileCache::Hint::No);
+            delete this;
+        }, resource);
+    }
+
+    void cancel() final {
+        MBGL_VERIFY_THREAD(tid);
+        delete this;
+    }
+
+private:
+    std::unique_ptr<WorkRequest> workRequest;
+};
+
+class MBTilesContext : public MBTilesContextBase {
+public:
+    MBTilesContext()
+        : reader(util::ThreadContext{"MBTiles", util::ThreadType::Unknown, util::ThreadPriority::Regular}) {
+    }
+
+    RequestBase* createRequest(const Resource& resource,
+                               RequestBase::Callback callback,
+                               uv_loop_t*) final {
+        return new MBTilesRequest(resource, callback, reader);
+    }
+
+private:
+    util::Thread<MBTilesReader> reader;
+};
+
+std::unique_ptr<MBTilesContextBase> MBTilesContextBase::createContext(uv_loop_t*) {
+    return std::make_unique<MBTilesContext>();
+}
+
+}
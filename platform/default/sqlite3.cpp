@@ -64,6 +64,11 @@ void Database::exec(const std::string &sql) {
     }
 }
 
+int Database::changes() const {
+    assert(db);
+    return sqlite3_changes(db);
+}
+
 Statement Database::prepare(const char *query) {
     assert(db);
     return std::move(Statement(db, query));
@@ -176,6 +181,14 @@ template <> std::string Statement::get(int offset) {
     };
 }
 
+std::pair<const char *, std::size_t> Statement::getBlob(int offset) {
+    assert(stmt);
+    return {
+        reinterpret_cast<const char *>(sqlite3_column_blob(stmt, offset)),
+        size_t(sqlite3_column_bytes(stmt, offset))
+    };
+}
+
 void Statement::reset() {
     assert(stmt);
     sqlite3_reset(stmt);
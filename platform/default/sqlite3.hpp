@@ -2,6 +2,7 @@
 
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 typedef struct sqlite3 sqlite3;
 typedef struct sqlite3_stmt sqlite3_stmt;
@@ -42,6 +43,9 @@ public:
     void exec(const std::string &sql);
     Statement prepare(const char *query);
 
+    // Number of rows modified by the most recent INSERT, UPDATE or DELETE statement.
+    int changes() const;
+
 private:
     sqlite3 *db = nullptr;
 };
@@ -63,6 +67,10 @@ public:
     void bind(int offset, const std::string &value, bool retain = true);
     template <typename T> T get(int offset);
 
+    // Points to the blob in SQLite's own memory, which is a page of the memory-mapped database
+    // file when mmap I/O is enabled. Only valid until the statement is run again or reset.
+    std::pair<const char *, std::size_t> getBlob(int offset);
+
     bool run();
     void reset();
 
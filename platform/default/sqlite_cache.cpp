@@ -6,32 +6,65 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/uv_detail.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include "sqlite3.hpp"
 #include <sqlite3.h>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace mapbox::sqlite;
 
+namespace {
+
+// Bump this whenever the columns of `http_cache` change. Databases with a different version are
+// emptied when they're opened.
+constexpr int schemaVersion = 2;
+
+// Number of responses that are evicted at once when the database is too large.
+constexpr int evictionBatchSize = 16;
+
+// Number of free pages that are returned to the file system after each commit.
+constexpr int vacuumPages = 64;
+
+int64_t currentTime() {
+    return std::chrono::duration_cast<std::chrono::seconds>(SystemClock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 SQLiteCache::SQLiteCache(const std::string& path_)
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"SQLite Cache", util::ThreadType::Unknown, util::ThreadPriority::Low}, path_)) {
 }
 
 SQLiteCache::~SQLiteCache() = default;
 
+const uint64_t SQLiteCache::defaultMaximumSize = 50 * 1024 * 1024;
+
+const std::size_t SQLiteCache::Impl::maxQueuedWrites = 64;
+const Duration SQLiteCache::Impl::flushDelay = std::chrono::milliseconds(100);
+
 SQLiteCache::Impl::Impl(const std::string& path_)
     : path(path_) {
 }
 
 SQLiteCache::Impl::~Impl() {
+    // Don't lose the writes that are still waiting for the timer.
+    flush();
+
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
         getStmt.reset();
         putStmt.reset();
         refreshStmt.reset();
+        accessedStmt.reset();
+        evictStmt.reset();
+        packStmt.reset();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
@@ -43,7 +76,13 @@ void SQLiteCache::Impl::createDatabase() {
 }
 
 void SQLiteCache::Impl::createSchema() {
-    constexpr const char *const sql = ""
+    // Writes are committed in batches, so there are few syncs to begin with. Losing the last batch
+    // on power loss is harmless for a cache, so don't sync more often than SQLite requires to
+    // keep the database consistent. Pages freed by evictions are returned to the file system by
+    // evict(); auto_vacuum only takes effect for databases that don't have any tables yet.
+    const std::string sql = std::string() +
+        "PRAGMA synchronous = NORMAL;"
+        "PRAGMA auto_vacuum = INCREMENTAL;"
         "CREATE TABLE IF NOT EXISTS `http_cache` ("
         "    `url` TEXT PRIMARY KEY NOT NULL,"
         "    `status` INTEGER NOT NULL," // The response status (Successful or Error).
@@ -52,11 +91,37 @@ void SQLiteCache::Impl::createSchema() {
         "    `etag` TEXT,"
         "    `expires` INTEGER," // Timestamp when the server says the file expires.
         "    `data` BLOB,"
-        "    `compressed` INTEGER NOT NULL DEFAULT 0" // Whether the data is compressed.
+        "    `compressed` INTEGER NOT NULL DEFAULT 0," // The util::Codec of the data.
+        "    `accessed` INTEGER NOT NULL DEFAULT 0" // Timestamp when the file was last used.
+        ");"
+        "CREATE INDEX IF NOT EXISTS `http_cache_kind_idx` ON `http_cache` (`kind`);"
+        "CREATE TABLE IF NOT EXISTS `offline_resources` (" // Responses that must not be evicted.
+        "    `pack` TEXT NOT NULL," // The name of the offline pack.
+        "    `url` TEXT NOT NULL," // The canonical URL of the response in `http_cache`.
+        "    PRIMARY KEY (`pack`, `url`)"
         ");"
-        "CREATE INDEX IF NOT EXISTS `http_cache_kind_idx` ON `http_cache` (`kind`);";
+        "CREATE INDEX IF NOT EXISTS `offline_resources_url_idx` ON `offline_resources` (`url`);"
+        "PRAGMA user_version = " + std::to_string(schemaVersion) + ";";
 
     try {
+        int version = 0;
+        {
+            Statement versionStmt = db->prepare("PRAGMA user_version");
+            if (versionStmt.run()) {
+                version = versionStmt.get<int>(0);
+            }
+        }
+
+        if (version != schemaVersion) {
+            // This is either a new database, or one that was created with different columns.
+            // It's only a cache, so start over rather than migrating the stored responses. The
+            // vacuum enables incremental vacuuming, and is cheap now that the database is empty.
+            db->exec("DROP TABLE IF EXISTS `http_cache`;"
+                     "DROP TABLE IF EXISTS `offline_resources`;"
+                     "PRAGMA auto_vacuum = INCREMENTAL;"
+                     "VACUUM;");
+        }
+
         db->exec(sql);
         schema = true;
     } catch (mapbox::sqlite::Exception &ex) {
@@ -89,6 +154,15 @@ std::unique_ptr<WorkRequest> SQLiteCache::get(const Resource &resource, Callback
 }
 
 void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
+    // Writes that haven't been committed yet take precedence over the database.
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+    const auto queued = queue.find(canonicalURL);
+    if (queued != queue.end() && queued->second.response) {
+        hits++;
+        callback(std::make_unique<Response>(*queued->second.response));
+        return;
+    }
+
     try {
         // This is called in the SQLite event loop.
         if (!db) {
@@ -108,7 +182,6 @@ void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
             getStmt->reset();
         }
 
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
         getStmt->bind(1, canonicalURL.c_str());
         if (getStmt->run()) {
             // There is data.
@@ -117,17 +190,36 @@ void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
             response->modified = getStmt->get<int64_t>(1);
             response->etag = getStmt->get<std::string>(2);
             response->expires = getStmt->get<int64_t>(3);
-            response->data = std::make_shared<std::string>(std::move(getStmt->get<std::string>(4)));
-            if (getStmt->get<int>(5)) { // == compressed
-                response->data = std::make_shared<std::string>(std::move(util::decompress(*response->data)));
+            // Decode straight from the blob; older databases only contain zlib and raw data.
+            const auto blob = getStmt->getBlob(4);
+            const auto storedCodec = util::Codec(getStmt->get<int>(5));
+            response->data = std::make_shared<std::string>(util::decode(storedCodec, blob.first, blob.second));
+            if (queued != queue.end()) {
+                // Only the expiry date was changed.
+                response->expires = queued->second.expires;
             }
+            hits++;
             callback(std::move(response));
+
+            // Access times are only used to decide what to evict, so they don't need to be
+            // written right away. They're committed together with the next batch of writes.
+            accessed[canonicalURL] = currentTime();
+            if (accessed.size() >= maxQueuedWrites) {
+                flush();
+            }
         } else {
             // There is no data.
+            misses++;
             callback(nullptr);
         }
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
+        misses++;
+        callback(nullptr);
+    } catch (std::runtime_error& ex) {
+        // Corrupt data, or a codec that this version doesn't know.
+        Log::Error(Event::Database, ex.what());
+        misses++;
         callback(nullptr);
     }
 }
@@ -137,12 +229,44 @@ void SQLiteCache::put(const Resource &resource, std::shared_ptr<const Response>
     // storing a new response or updating the currently stored response, potentially setting a new
     // expiry date.
     if (hint == Hint::Full) {
-        thread->invoke(&Impl::put, resource, response);
+        thread->invoke(&Impl::schedulePut, resource, response);
     } else if (hint == Hint::Refresh) {
-        thread->invoke(&Impl::refresh, resource, response->expires);
+        thread->invoke(&Impl::scheduleRefresh, resource, response->expires);
     }
 }
 
+SQLiteCache::Statistics SQLiteCache::getStatistics() {
+    return thread->invokeSync<Statistics>(&Impl::getStatistics);
+}
+
+void SQLiteCache::flush() {
+    thread->invokeSync(&Impl::flush);
+}
+
+FileCache::Usage SQLiteCache::getUsage() {
+    return thread->invokeSync<Usage>(&Impl::getUsage);
+}
+
+void SQLiteCache::setMaximumSize(uint64_t size) {
+    thread->invoke(&Impl::setMaximumSize, size);
+}
+
+void SQLiteCache::setCodec(util::Codec codec) {
+    thread->invoke(&Impl::setCodec, codec);
+}
+
+void SQLiteCache::addToPack(const std::string& pack, const Resource& resource) {
+    thread->invoke(&Impl::addToPack, pack, resource);
+}
+
+std::unique_ptr<WorkRequest> SQLiteCache::getPack(const std::string& pack, PackCallback callback) {
+    return thread->invokeWithCallback(&Impl::getPack, callback, pack);
+}
+
+void SQLiteCache::removePack(const std::string& pack) {
+    thread->invoke(&Impl::removePack, pack);
+}
+
 void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Response> response) {
     try {
         if (!db) {
@@ -153,49 +277,172 @@ void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Resp
             createSchema();
         }
 
-        if (!putStmt) {
-            putStmt = std::make_unique<Statement>(db->prepare("REPLACE INTO `http_cache` ("
-            //     1       2       3         4         5         6        7          8
-                "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`"
-                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?)"));
-        } else {
-            putStmt->reset();
-        }
-
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
-        putStmt->bind(1 /* url */, canonicalURL.c_str());
-        putStmt->bind(2 /* status */, int(response->status));
-        putStmt->bind(3 /* kind */, int(resource.kind));
-        putStmt->bind(4 /* modified */, response->modified);
-        putStmt->bind(5 /* etag */, response->etag.c_str());
-        putStmt->bind(6 /* expires */, response->expires);
-
-        std::string data;
-        if (resource.kind != Resource::SpriteImage && response->data) {
-            // Do not compress images, since they are typically compressed already.
-            data = util::compress(*response->data);
-        }
-
-        if (!data.empty() && data.size() < response->data->size()) {
-            // Store the compressed data when it is smaller than the original
-            // uncompressed data.
-            putStmt->bind(7 /* data */, data, false); // do not retain the string internally.
-            putStmt->bind(8 /* compressed */, true);
-        } else if (response->data) {
-            putStmt->bind(7 /* data */, *response->data, false); // do not retain the string internally.
-            putStmt->bind(8 /* compressed */, false);
-        } else {
-            putStmt->bind(7 /* data */, "", false);
-            putStmt->bind(8 /* compressed */, false);
+        writePut(resource, *response);
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::Impl::writePut(const Resource& resource, const Response& response) {
+    if (!putStmt) {
+        putStmt = std::make_unique<Statement>(db->prepare("REPLACE INTO `http_cache` ("
+        //     1       2       3         4         5         6        7          8              9
+            "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`, `accessed`"
+            ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    } else {
+        putStmt->reset();
+    }
+
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+    putStmt->bind(1 /* url */, canonicalURL.c_str());
+    putStmt->bind(2 /* status */, int(response.status));
+    putStmt->bind(3 /* kind */, int(resource.kind));
+    putStmt->bind(4 /* modified */, response.modified);
+    putStmt->bind(5 /* etag */, response.etag.c_str());
+    putStmt->bind(6 /* expires */, response.expires);
+    putStmt->bind(9 /* accessed */, currentTime());
+
+    // Do not compress images, since they are typically compressed already.
+    std::string data;
+    if (resource.kind != Resource::SpriteImage && codec != util::Codec::None && response.data) {
+        data = util::encode(codec, *response.data);
+    }
+
+    if (!data.empty() && data.size() < response.data->size()) {
+        // Store the compressed data when it is smaller than the original
+        // uncompressed data.
+        putStmt->bind(7 /* data */, data, false); // do not retain the string internally.
+        putStmt->bind(8 /* compressed */, int(codec));
+    } else if (response.data) {
+        putStmt->bind(7 /* data */, *response.data, false); // do not retain the string internally.
+        putStmt->bind(8 /* compressed */, int(util::Codec::None));
+    } else {
+        putStmt->bind(7 /* data */, "", false);
+        putStmt->bind(8 /* compressed */, int(util::Codec::None));
+    }
+
+    putStmt->run();
+}
+
+void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
+    try {
+        if (!db) {
+            createDatabase();
         }
 
-        putStmt->run();
+        if (!schema) {
+            createSchema();
+        }
+
+        writeRefresh(util::mapbox::canonicalURL(resource.url), expires);
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
     }
 }
 
-void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
+void SQLiteCache::Impl::writeRefresh(const std::string& canonicalURL, int64_t expires) {
+    if (!refreshStmt) {
+        refreshStmt = std::make_unique<Statement>( //        1               2
+            db->prepare("UPDATE `http_cache` SET `expires` = ? WHERE `url` = ?"));
+    } else {
+        refreshStmt->reset();
+    }
+
+    refreshStmt->bind(1, int64_t(expires));
+    refreshStmt->bind(2, canonicalURL.c_str());
+    refreshStmt->run();
+}
+
+void SQLiteCache::Impl::writeAccessed(const std::string& canonicalURL, int64_t time) {
+    if (!accessedStmt) {
+        accessedStmt = std::make_unique<Statement>( //         1               2
+            db->prepare("UPDATE `http_cache` SET `accessed` = ? WHERE `url` = ?"));
+    } else {
+        accessedStmt->reset();
+    }
+
+    accessedStmt->bind(1, int64_t(time));
+    accessedStmt->bind(2, canonicalURL.c_str());
+    accessedStmt->run();
+}
+
+void SQLiteCache::Impl::writePacked(const std::string& pack, const std::string& canonicalURL) {
+    if (!packStmt) {
+        packStmt = std::make_unique<Statement>( //                                 1      2
+            db->prepare("INSERT OR IGNORE INTO `offline_resources` (`pack`, `url`) VALUES (?, ?)"));
+    } else {
+        packStmt->reset();
+    }
+
+    packStmt->bind(1, pack.c_str());
+    packStmt->bind(2, canonicalURL.c_str());
+    packStmt->run();
+}
+
+void SQLiteCache::Impl::schedulePut(const Resource& resource, std::shared_ptr<const Response> response) {
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+    const int64_t expires = response->expires;
+    queue.erase(canonicalURL);
+    queue.emplace(canonicalURL, QueuedWrite{ resource, std::move(response), expires });
+    scheduleFlush();
+}
+
+void SQLiteCache::Impl::scheduleRefresh(const Resource& resource, int64_t expires) {
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+    auto it = queue.find(canonicalURL);
+    if (it == queue.end()) {
+        queue.emplace(canonicalURL, QueuedWrite{ resource, nullptr, expires });
+    } else {
+        if (it->second.response) {
+            // Fold the new expiry date into the response that is still waiting to be written.
+            auto response = std::make_shared<Response>(*it->second.response);
+            response->expires = expires;
+            it->second.response = std::move(response);
+        }
+        it->second.expires = expires;
+    }
+    scheduleFlush();
+}
+
+void SQLiteCache::Impl::scheduleFlush() {
+    statistics.queued = queue.size();
+    statistics.maxQueued = std::max(statistics.maxQueued, statistics.queued);
+
+    if (queue.size() >= maxQueuedWrites || packed.size() >= maxQueuedWrites) {
+        flush();
+    } else if (!flushScheduled) {
+        if (!flushTimer) {
+            flushTimer = std::make_unique<uv::timer>(util::RunLoop::getLoop());
+        }
+        flushTimer->start(std::chrono::duration_cast<std::chrono::milliseconds>(flushDelay).count(), 0, [this] {
+            flushScheduled = false;
+            flush();
+        });
+        flushScheduled = true;
+    }
+}
+
+void SQLiteCache::Impl::flush() {
+    if (flushScheduled) {
+        flushTimer->stop();
+        flushScheduled = false;
+    }
+
+    if (queue.empty() && accessed.empty() && packed.empty()) {
+        return;
+    }
+
+    const auto writes = std::move(queue);
+    queue.clear();
+    statistics.queued = 0;
+
+    const auto times = std::move(accessed);
+    accessed.clear();
+
+    const auto packs = std::move(packed);
+    packed.clear();
+
+    const auto start = Clock::now();
     try {
         if (!db) {
             createDatabase();
@@ -205,17 +452,185 @@ void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
             createSchema();
         }
 
-        if (!refreshStmt) {
-            refreshStmt = std::make_unique<Statement>( //        1               2
-                db->prepare("UPDATE `http_cache` SET `expires` = ? WHERE `url` = ?"));
-        } else {
-            refreshStmt->reset();
+        db->exec("BEGIN");
+        for (const auto& write : writes) {
+            if (write.second.response) {
+                writePut(write.second.resource, *write.second.response);
+            } else {
+                writeRefresh(write.first, write.second.expires);
+            }
+        }
+        for (const auto& time : times) {
+            writeAccessed(time.first, time.second);
+        }
+        for (const auto& pack : packs) {
+            writePacked(pack.first, pack.second);
+        }
+        db->exec("COMMIT");
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+        if (db) {
+            try {
+                db->exec("ROLLBACK");
+            } catch (mapbox::sqlite::Exception&) {
+                // There was no transaction to roll back.
+            }
+        }
+        return;
+    }
+
+    const Duration elapsed = Clock::now() - start;
+    statistics.commits++;
+    statistics.rows += writes.size();
+    statistics.totalCommitTime += elapsed;
+    statistics.maxCommitTime = std::max(statistics.maxCommitTime, elapsed);
+
+    try {
+        evict();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::Impl::evict() {
+    if (maximumSize > 0) {
+        uint64_t size = databaseSize();
+        while (size > maximumSize) {
+            if (!evictStmt) {
+                // Expired responses go first, then tiles, and both in least recently used order.
+                evictStmt = std::make_unique<Statement>(db->prepare("DELETE FROM `http_cache` "
+                    "WHERE `url` IN (SELECT `url` FROM `http_cache` "
+                    "WHERE `url` NOT IN (SELECT `url` FROM `offline_resources`) ORDER BY "
+                    //                                1                   2
+                    "`expires` > 0 AND `expires` <= ? DESC, `kind` = ? DESC, `accessed` ASC "
+                    //     3
+                    "LIMIT ?)"));
+            } else {
+                evictStmt->reset();
+            }
+
+            evictStmt->bind(1, currentTime());
+            evictStmt->bind(2, int(Resource::Tile));
+            evictStmt->bind(3, evictionBatchSize);
+            evictStmt->run();
+
+            const int evicted = db->changes();
+            if (evicted == 0) {
+                break;
+            }
+
+            statistics.evictions += evicted;
+            size = databaseSize();
+        }
+    }
+
+    // Free pages are only returned a few at a time so that a large eviction doesn't hold up the
+    // requests that are waiting for this thread.
+    db->exec("PRAGMA incremental_vacuum(" + std::to_string(vacuumPages) + ")");
+}
+
+uint64_t SQLiteCache::Impl::databaseSize() {
+    auto pragma = [&] (const char* sql) {
+        Statement stmt = db->prepare(sql);
+        stmt.run();
+        return uint64_t(stmt.get<int64_t>(0));
+    };
+
+    // Pages on the free list still take up space in the file, but will be reused or vacuumed.
+    return (pragma("PRAGMA page_count") - pragma("PRAGMA freelist_count")) * pragma("PRAGMA page_size");
+}
+
+SQLiteCache::Statistics SQLiteCache::Impl::getStatistics() const {
+    return statistics;
+}
+
+FileCache::Usage SQLiteCache::Impl::getUsage() {
+    Usage usage;
+    usage.hits = hits;
+    usage.misses = misses;
+
+    try {
+        if (!db) {
+            createDatabase();
+        }
+
+        if (!schema) {
+            createSchema();
+        }
+
+        usage.size = databaseSize();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+
+    return usage;
+}
+
+void SQLiteCache::Impl::setMaximumSize(uint64_t size) {
+    maximumSize = size;
+
+    try {
+        if (db && schema) {
+            evict();
+        }
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::Impl::setCodec(util::Codec codec_) {
+    codec = codec_;
+}
+
+void SQLiteCache::Impl::addToPack(const std::string& pack, const Resource& resource) {
+    packed.emplace_back(pack, util::mapbox::canonicalURL(resource.url));
+    scheduleFlush();
+}
+
+void SQLiteCache::Impl::getPack(const std::string& pack, PackCallback callback) {
+    // Make sure that responses that were just added are included.
+    flush();
+
+    std::vector<std::string> urls;
+    try {
+        if (!db) {
+            createDatabase();
         }
 
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
-        refreshStmt->bind(1, int64_t(expires));
-        refreshStmt->bind(2, canonicalURL.c_str());
-        refreshStmt->run();
+        if (!schema) {
+            createSchema();
+        }
+
+        Statement stmt = db->prepare("SELECT `url` FROM `offline_resources` WHERE `pack` = ?");
+        stmt.bind(1, pack.c_str());
+        while (stmt.run()) {
+            urls.emplace_back(stmt.get<std::string>(0));
+        }
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+
+    callback(std::move(urls));
+}
+
+void SQLiteCache::Impl::removePack(const std::string& pack) {
+    flush();
+
+    try {
+        if (!db) {
+            createDatabase();
+        }
+
+        if (!schema) {
+            createSchema();
+        }
+
+        Statement stmt = db->prepare("DELETE FROM `offline_resources` WHERE `pack` = ?");
+        stmt.bind(1, pack.c_str());
+        stmt.run();
+
+        // The responses of the pack may now be evicted.
+        evict();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
     }
@@ -2,6 +2,10 @@
 #define MBGL_STORAGE_DEFAULT_SQLITE_CACHE_IMPL
 
 #include <mbgl/storage/sqlite_cache.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/compression.hpp>
+
+#include <unordered_map>
 
 namespace mapbox {
 namespace sqlite {
@@ -10,6 +14,10 @@ class Statement;
 }
 }
 
+namespace uv {
+class timer;
+}
+
 namespace mbgl {
 
 class SQLiteCache::Impl {
@@ -21,16 +29,76 @@ public:
     void put(const Resource& resource, std::shared_ptr<const Response> response);
     void refresh(const Resource& resource, int64_t expires);
 
+    // Like put() and refresh(), but the writes are queued and committed in batches.
+    void schedulePut(const Resource& resource, std::shared_ptr<const Response> response);
+    void scheduleRefresh(const Resource& resource, int64_t expires);
+
+    // Commits all queued writes in a single transaction.
+    void flush();
+
+    Statistics getStatistics() const;
+    Usage getUsage();
+    void setMaximumSize(uint64_t size);
+
+    // Codec that new responses are stored with. Responses are readable regardless of the codec
+    // they were stored with.
+    void setCodec(util::Codec);
+
+    void addToPack(const std::string& pack, const Resource&);
+    void getPack(const std::string& pack, PackCallback);
+    void removePack(const std::string& pack);
+
+    // The queue is committed once it holds this many writes, or after this delay.
+    static const std::size_t maxQueuedWrites;
+    static const Duration flushDelay;
+
 private:
     void createDatabase();
     void createSchema();
 
+    void writePut(const Resource& resource, const Response& response);
+    void writeRefresh(const std::string& canonicalURL, int64_t expires);
+    void writeAccessed(const std::string& canonicalURL, int64_t accessed);
+    void writePacked(const std::string& pack, const std::string& canonicalURL);
+    void scheduleFlush();
+
+    // Evicts responses until the database fits into the maximum size, and returns some of the
+    // pages that were freed to the file system.
+    void evict();
+    uint64_t databaseSize();
+
     const std::string path;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unique_ptr<::mapbox::sqlite::Statement> getStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> putStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> refreshStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> accessedStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> evictStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> packStmt;
     bool schema = false;
+    uint64_t maximumSize = SQLiteCache::defaultMaximumSize;
+    util::Codec codec = util::Codec::Deflate;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    struct QueuedWrite {
+        Resource resource;
+        std::shared_ptr<const Response> response; // Empty when only the expiry date is updated.
+        int64_t expires;
+    };
+
+    // Queued writes, indexed by canonical URL. Later writes to the same URL replace earlier ones.
+    std::unordered_map<std::string, QueuedWrite> queue;
+
+    // Access times of responses that were read from the database, indexed by canonical URL. They
+    // are written along with the queued writes.
+    std::unordered_map<std::string, int64_t> accessed;
+
+    // Pack names and canonical URLs of responses that were added to offline packs.
+    std::vector<std::pair<std::string, std::string>> packed;
+    std::unique_ptr<uv::timer> flushTimer;
+    bool flushScheduled = false;
+    Statistics statistics;
 };
 
 
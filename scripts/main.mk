@@ -74,6 +74,7 @@ GYP_FLAGS += -Dcache_lib=$(CACHE)
 GYP_FLAGS += -Dheadless_lib=$(HEADLESS)
 GYP_FLAGS += -Dtest=$(BUILD_TEST)
 GYP_FLAGS += -Drender=$(BUILD_RENDER)
+GYP_FLAGS += -Dbenchmark=$(BUILD_BENCHMARK)
 GYP_FLAGS += --depth=.
 GYP_FLAGS += -Goutput_dir=.
 GYP_FLAGS += --generator-output=./build/$(HOST_SLUG)
@@ -137,6 +138,11 @@ Xcode/%: Xcode/__project__
 test-%: Makefile/test
 	./scripts/run_tests.sh "build/$(HOST_SLUG)/$(BUILDTYPE)/test" --gtest_filter=$*
 
+#### Run benchmarks ############################################################
+
+run-benchmark: Makefile/benchmark
+	build/$(HOST_SLUG)/$(BUILDTYPE)/benchmark
+
 #### Helper targets ############################################################
 
 .PHONY: print-env
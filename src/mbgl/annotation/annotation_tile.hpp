@@ -26,7 +26,7 @@ public:
 class AnnotationTileLayer : public GeometryTileLayer {
 public:
     std::size_t featureCount() const override { return features.size(); }
-    util::ptr<const GeometryTileFeature> getFeature(std::size_t i) const override { return features[i]; }
+    const GeometryTileFeature& getFeature(std::size_t i) const override { return *features[i]; }
 
     std::vector<util::ptr<const AnnotationTileFeature>> features;
 };
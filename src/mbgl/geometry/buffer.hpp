@@ -9,6 +9,7 @@
 
 #include <cstdlib>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 
 namespace mbgl {
@@ -39,6 +40,12 @@ public:
         return pos == 0;
     }
 
+    // Returns the number of bytes of data in this buffer, regardless of whether it is still held
+    // in main memory or has already been uploaded to the GPU.
+    inline std::size_t byteSize() const {
+        return static_cast<std::size_t>(pos);
+    }
+
     // Transfers this buffer to the GPU and binds the buffer to the GL context.
     void bind() {
         if (buffer) {
@@ -64,6 +71,33 @@ public:
         }
     }
 
+    // Returns the CPU-side data, which is only available until the buffer is uploaded.
+    inline const GLvoid* data() const {
+        return array;
+    }
+
+    // Replaces the contents of this buffer with data that was previously obtained from data().
+    void assign(const void* data_, std::size_t size) {
+        if (buffer != 0) {
+            throw std::runtime_error("Can't add elements after buffer was bound to GPU");
+        }
+        if (size % itemSize != 0) {
+            throw std::runtime_error("Buffer data isn't a multiple of the item size");
+        }
+        cleanup();
+        pos = 0;
+        length = 0;
+        if (size) {
+            array = malloc(size);
+            if (array == nullptr) {
+                throw std::runtime_error("Buffer allocation failed");
+            }
+            std::memcpy(array, data_, size);
+            pos = size;
+            length = size;
+        }
+    }
+
     inline GLuint getID() const {
         return buffer;
     }
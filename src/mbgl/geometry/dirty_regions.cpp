@@ -0,0 +1,154 @@
+#include <mbgl/geometry/dirty_regions.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace mbgl;
+
+namespace {
+
+std::size_t area(const Rect<uint16_t>& rect) {
+    return std::size_t(rect.w) * rect.h;
+}
+
+Rect<uint16_t> unite(const Rect<uint16_t>& a, const Rect<uint16_t>& b) {
+    const uint16_t x = std::min(a.x, b.x);
+    const uint16_t y = std::min(a.y, b.y);
+    return { x, y, uint16_t(std::max(a.x + a.w, b.x + b.w) - x),
+                   uint16_t(std::max(a.y + a.h, b.y + b.h) - y) };
+}
+
+// Merging is worth it when the union is at most a quarter larger than the two regions: one call
+// that transfers a few more bytes is cheaper than two calls.
+bool shouldMerge(const Rect<uint16_t>& a, const Rect<uint16_t>& b) {
+    return area(unite(a, b)) * 4 <= (area(a) + area(b)) * 5;
+}
+
+} // namespace
+
+const std::size_t DirtyRegions::maxRegions = 32;
+
+DirtyRegions::DirtyRegions(uint16_t width_, uint16_t height_, uint8_t bytesPerPixel_)
+    : width(width_), height(height_), bytesPerPixel(bytesPerPixel_) {
+}
+
+void DirtyRegions::add(Rect<uint16_t> rect) {
+    // Clip to the texture.
+    if (rect.x >= width || rect.y >= height) {
+        return;
+    }
+    rect.w = std::min<uint16_t>(rect.w, width - rect.x);
+    rect.h = std::min<uint16_t>(rect.h, height - rect.y);
+    if (!rect.hasArea()) {
+        return;
+    }
+
+    // A merged region may now be worth merging with another one, so keep going until nothing
+    // changes.
+    for (auto it = regions.begin(); it != regions.end();) {
+        if (shouldMerge(*it, rect)) {
+            rect = unite(*it, rect);
+            regions.erase(it);
+            it = regions.begin();
+        } else {
+            ++it;
+        }
+    }
+
+    if (regions.size() < maxRegions) {
+        regions.push_back(rect);
+        return;
+    }
+
+    auto best = regions.end();
+    std::size_t bestGrowth = std::numeric_limits<std::size_t>::max();
+    for (auto it = regions.begin(); it != regions.end(); ++it) {
+        const std::size_t growth = area(unite(*it, rect)) - area(*it);
+        if (growth < bestGrowth) {
+            best = it;
+            bestGrowth = growth;
+        }
+    }
+
+    *best = unite(*best, rect);
+}
+
+std::vector<Rect<uint16_t>> DirtyRegions::take(std::size_t budget) {
+    std::vector<Rect<uint16_t>> result;
+
+    if (budget == 0) {
+        result.swap(regions);
+        return result;
+    }
+
+    std::size_t remaining = budget;
+    auto it = regions.begin();
+    for (; it != regions.end(); ++it) {
+        const std::size_t rowBytes = std::size_t(it->w) * bytesPerPixel;
+        const std::size_t bytes = rowBytes * it->h;
+        if (bytes <= remaining) {
+            result.push_back(*it);
+            remaining -= bytes;
+            continue;
+        }
+
+        uint16_t rows = remaining / rowBytes;
+        if (rows == 0 && result.empty()) {
+            rows = 1;
+        }
+        if (rows > 0) {
+            result.push_back({ it->x, it->y, it->w, rows });
+            it->y += rows;
+            it->h -= rows;
+        }
+        break;
+    }
+
+    regions.erase(regions.begin(), it);
+    return result;
+}
+
+void DirtyRegions::upload(const void* data, GLenum format, std::size_t budget) {
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(data);
+    const std::size_t textureRowBytes = std::size_t(width) * bytesPerPixel;
+
+    for (const auto& rect : take(budget)) {
+        const std::size_t rowBytes = std::size_t(rect.w) * bytesPerPixel;
+
+        // Rows have to start at a four byte boundary with the default GL_UNPACK_ALIGNMENT.
+        const uint8_t* pixels = source + rect.y * textureRowBytes;
+        if (rect.w != width || rowBytes % 4 != 0) {
+            const std::size_t stride = (rowBytes + 3) & ~std::size_t(3);
+            staging.resize(stride * rect.h);
+            for (uint16_t y = 0; y < rect.h; y++) {
+                std::memcpy(staging.data() + y * stride,
+                            source + (rect.y + y) * textureRowBytes + rect.x * bytesPerPixel,
+                            rowBytes);
+            }
+            pixels = staging.data();
+        }
+
+        MBGL_CHECK_ERROR(glTexSubImage2D(
+            GL_TEXTURE_2D, // GLenum target
+            0, // GLint level
+            rect.x, // GLint xoffset
+            rect.y, // GLint yoffset
+            rect.w, // GLsizei width
+            rect.h, // GLsizei height
+            format, // GLenum format
+            GL_UNSIGNED_BYTE, // GLenum type
+            pixels // const GLvoid *pixels
+        ));
+
+        statistics.uploads++;
+        statistics.bytes += rowBytes * rect.h;
+    }
+}
+
+void DirtyRegions::uploadedAll() {
+    regions.clear();
+
+    statistics.uploads++;
+    statistics.bytes += std::size_t(width) * height * bytesPerPixel;
+}
@@ -0,0 +1,67 @@
+#ifndef MBGL_GEOMETRY_DIRTY_REGIONS
+#define MBGL_GEOMETRY_DIRTY_REGIONS
+
+#include <mbgl/platform/gl.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/rect.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// Keeps track of the parts of an atlas texture that changed since they were last uploaded, so
+// that only those have to be transferred to the GPU. Not thread-safe; atlases that are modified
+// from several threads guard it with their own mutex.
+class DirtyRegions : private util::noncopyable {
+public:
+    // Running totals; the difference between two frames is what was uploaded in between.
+    struct Statistics {
+        uint64_t uploads = 0; // glTexImage2D and glTexSubImage2D calls.
+        uint64_t bytes = 0;   // Bytes transferred by them.
+    };
+
+    // Regions beyond this number are merged into the region they grow the least.
+    static const std::size_t maxRegions;
+
+    DirtyRegions(uint16_t width, uint16_t height, uint8_t bytesPerPixel);
+
+    // Adds a changed region, merging it with existing regions when the union doesn't cover
+    // much more than the regions themselves.
+    void add(Rect<uint16_t>);
+
+    bool empty() const { return regions.empty(); }
+    std::size_t size() const { return regions.size(); }
+
+    // Removes and returns regions worth at most `budget` bytes, or all of them with a budget of 0.
+    // A region that doesn't fit is split along its rows; at least one row is returned so that
+    // uploads make progress with any budget.
+    std::vector<Rect<uint16_t>> take(std::size_t budget);
+
+    // Uploads the regions returned by take() from `data`, which holds the whole texture, to the
+    // texture that is currently bound.
+    void upload(const void* data, GLenum format, std::size_t budget);
+
+    // Forgets all regions after the whole texture was uploaded.
+    void uploadedAll();
+
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    const uint16_t width;
+    const uint16_t height;
+    const uint8_t bytesPerPixel;
+
+    std::vector<Rect<uint16_t>> regions;
+
+    // Rows of regions that don't span the whole texture are copied here, because OpenGL ES 2
+    // can't upload a sub-rectangle of a larger image.
+    std::vector<uint8_t> staging;
+
+    Statistics statistics;
+};
+
+} // namespace mbgl
+
+#endif
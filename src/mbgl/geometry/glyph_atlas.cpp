@@ -14,20 +14,31 @@
 
 using namespace mbgl;
 
-GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_)
+GlyphAtlas::Page::Page(uint16_t width_, uint16_t height_)
+    : bin(width_, height_),
+      data(std::make_unique<uint8_t[]>(width_ * height_)),
+      regions(width_, height_, 1) {
+}
+
+GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_, uint16_t maxPages_)
     : width(width_),
       height(height_),
-      bin(width_, height_),
-      data(std::make_unique<uint8_t[]>(width_ * height_)),
+      maxPages(maxPages_),
       dirty(true) {
 }
 
 GlyphAtlas::~GlyphAtlas() {
-    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    for (const auto& page : pages) {
+        if (page && page->texture) {
+            abandonedTextures.push_back(page->texture);
+        }
+    }
 
-    if (texture) {
+    // An atlas that was never uploaded doesn't own any textures.
+    assert(abandonedTextures.empty() || util::ThreadContext::currentlyOn(util::ThreadType::Map));
+
+    for (const GLuint texture : abandonedTextures) {
         mbgl::util::ThreadContext::getGLObjectStore()->abandonTexture(texture);
-        texture = 0;
     }
 }
 
@@ -39,24 +50,20 @@ void GlyphAtlas::addGlyphs(uintptr_t tileUID,
 {
     std::lock_guard<std::mutex> lock(mtx);
 
-    const std::map<uint32_t, SDFGlyph>& sdfs = fontStack.getSDFs();
-
     for (uint32_t chr : text)
     {
-        auto sdf_it = sdfs.find(chr);
-        if (sdf_it == sdfs.end()) {
+        const SDFGlyph* sdf = fontStack.getGlyph(chr);
+        if (!sdf) {
             continue;
         }
 
-        const SDFGlyph& sdf = sdf_it->second;
-        Rect<uint16_t> rect = addGlyph(tileUID, stackName, sdf);
-        face.emplace(chr, Glyph{rect, sdf.metrics});
+        face.emplace(chr, addGlyph(tileUID, stackName, *sdf));
     }
 }
 
-Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
-                                    const std::string& stackName,
-                                    const SDFGlyph& glyph)
+Glyph GlyphAtlas::addGlyph(uintptr_t tileUID,
+                           const std::string& stackName,
+                           const SDFGlyph& glyph)
 {
     // Use constant value for now.
     const uint8_t buffer = 3;
@@ -68,12 +75,12 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     if (it != face.end()) {
         GlyphValue& value = it->second;
         value.ids.insert(tileUID);
-        return value.rect;
+        return Glyph{ value.rect, glyph.metrics, value.page };
     }
 
     // The glyph bitmap has zero width.
     if (glyph.bitmap.empty()) {
-        return Rect<uint16_t>{ 0, 0, 0, 0 };
+        return Glyph{ Rect<uint16_t>{ 0, 0, 0, 0 }, glyph.metrics };
     }
 
     uint16_t buffered_width = glyph.metrics.width + buffer * 2;
@@ -90,16 +97,45 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     pack_width += (4 - pack_width % 4);
     pack_height += (4 - pack_height % 4);
 
-    Rect<uint16_t> rect = bin.allocate(pack_width, pack_height);
-    if (rect.w == 0) {
-        Log::Error(Event::OpenGL, "glyph bitmap overflow");
-        return rect;
+    // Fill the lowest pages first, so that glyphs on higher pages are released over time and
+    // their pages can be dropped.
+    Rect<uint16_t> rect;
+    uint16_t pageIndex = 0;
+    for (; pageIndex < pages.size(); pageIndex++) {
+        if (pages[pageIndex]) {
+            rect = pages[pageIndex]->bin.allocate(pack_width, pack_height);
+            if (rect.hasArea()) {
+                break;
+            }
+        }
+    }
+
+    if (!rect.hasArea()) {
+        // Add a page, preferably in the slot of a released page.
+        pageIndex = std::find(pages.begin(), pages.end(), nullptr) - pages.begin();
+        if (pageIndex >= maxPages) {
+            Log::Error(Event::OpenGL, "glyph bitmap overflow");
+            return Glyph{ Rect<uint16_t>{ 0, 0, 0, 0 }, glyph.metrics };
+        }
+        if (pageIndex == pages.size()) {
+            pages.emplace_back();
+        }
+        pages[pageIndex] = std::make_unique<Page>(width, height);
+        rect = pages[pageIndex]->bin.allocate(pack_width, pack_height);
+        if (!rect.hasArea()) {
+            // The glyph is larger than a page.
+            pages[pageIndex].reset();
+            Log::Error(Event::OpenGL, "glyph bitmap overflow");
+            return Glyph{ rect, glyph.metrics };
+        }
     }
 
     assert(rect.x + rect.w <= width);
     assert(rect.y + rect.h <= height);
 
-    face.emplace(glyph.id, GlyphValue { rect, tileUID });
+    Page& page = *pages[pageIndex];
+    face.emplace(glyph.id, GlyphValue { rect, pageIndex, tileUID });
+    page.glyphs++;
 
     // Copy the bitmap
     const uint8_t* source = reinterpret_cast<const uint8_t*>(glyph.bitmap.data());
@@ -107,13 +143,14 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
         uint32_t y1 = width * (rect.y + y + padding) + rect.x + padding;
         uint32_t y2 = buffered_width * y;
         for (uint32_t x = 0; x < buffered_width; x++) {
-            data[y1 + x] = source[y2 + x];
+            page.data[y1 + x] = source[y2 + x];
         }
     }
 
+    page.regions.add(rect);
     dirty = true;
 
-    return rect;
+    return Glyph{ rect, glyph.metrics, pageIndex };
 }
 
 void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
@@ -127,17 +164,31 @@ void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
 
             if (value.ids.empty()) {
                 const Rect<uint16_t>& rect = value.rect;
-
-                // Clear out the bitmap.
-                uint8_t *target = data.get();
-                for (uint32_t y = 0; y < rect.h; y++) {
-                    uint32_t y1 = width * (rect.y + y) + rect.x;
-                    for (uint32_t x = 0; x < rect.w; x++) {
-                        target[y1 + x] = 0;
+                auto& page = pages[value.page];
+                assert(page);
+
+                if (--page->glyphs == 0) {
+                    // No tile uses this page anymore. Dropping it instead of releasing the
+                    // rectangle also undoes the fragmentation of its bin.
+                    const auto& statistics = page->regions.getStatistics();
+                    releasedStatistics.uploads += statistics.uploads;
+                    releasedStatistics.bytes += statistics.bytes;
+                    if (page->texture) {
+                        abandonedTextures.push_back(page->texture);
+                    }
+                    page.reset();
+                } else {
+                    // Clear out the bitmap.
+                    uint8_t *target = page->data.get();
+                    for (uint32_t y = 0; y < rect.h; y++) {
+                        uint32_t y1 = width * (rect.y + y) + rect.x;
+                        for (uint32_t x = 0; x < rect.w; x++) {
+                            target[y1 + x] = 0;
+                        }
                     }
-                }
 
-                bin.release(rect);
+                    page->bin.release(rect);
+                }
 
                 // Make sure to post-increment the iterator: This will return the
                 // current iterator, but will go to the next position before we
@@ -151,51 +202,67 @@ void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
     }
 }
 
-void GlyphAtlas::upload() {
-    if (dirty) {
-        const bool first = !texture;
-        bind();
-
-        std::lock_guard<std::mutex> lock(mtx);
-
-        if (first) {
-            MBGL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                GL_ALPHA, // GLint internalformat
-                width, // GLsizei width
-                height, // GLsizei height
-                0, // GLint border
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
-        } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
+std::size_t GlyphAtlas::getPageCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return std::count_if(pages.begin(), pages.end(), [] (const std::unique_ptr<Page>& page) {
+        return bool(page);
+    });
+}
+
+DirtyRegions::Statistics GlyphAtlas::getUploadStatistics() {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    DirtyRegions::Statistics result = releasedStatistics;
+    for (const auto& page : pages) {
+        if (page) {
+            result.uploads += page->regions.getStatistics().uploads;
+            result.bytes += page->regions.getStatistics().bytes;
         }
+    }
+    return result;
+}
 
-        dirty = false;
+void GlyphAtlas::upload(std::size_t budget) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
 
-#if defined(DEBUG)
-        // platform::showDebugImage("Glyph Atlas", reinterpret_cast<char*>(data.get()), width, height);
-#endif
+    std::lock_guard<std::mutex> lock(mtx);
+
+    for (const GLuint texture : abandonedTextures) {
+        mbgl::util::ThreadContext::getGLObjectStore()->abandonTexture(texture);
+    }
+    abandonedTextures.clear();
+
+    if (dirty) {
+        // The budget is shared by all pages.
+        std::size_t remaining = budget;
+        bool pending = false;
+        for (const auto& page : pages) {
+            if (!page || page->regions.empty()) {
+                continue;
+            }
+
+            if (budget && !remaining) {
+                pending = true;
+                continue;
+            }
+
+            const uint64_t before = page->regions.getStatistics().bytes;
+            uploadPage(*page, remaining);
+            if (budget) {
+                remaining -= std::min<uint64_t>(remaining, page->regions.getStatistics().bytes - before);
+            }
+
+            pending = pending || !page->regions.empty();
+        }
+
+        dirty = pending;
     }
 }
 
-void GlyphAtlas::bind() {
-    if (!texture) {
-        MBGL_CHECK_ERROR(glGenTextures(1, &texture));
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+void GlyphAtlas::uploadPage(Page& page, std::size_t budget) {
+    if (!page.texture) {
+        MBGL_CHECK_ERROR(glGenTextures(1, &page.texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
 #ifndef GL_ES_VERSION_2_0
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
 #endif
@@ -203,7 +270,40 @@ void GlyphAtlas::bind() {
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        MBGL_CHECK_ERROR(glTexImage2D(
+            GL_TEXTURE_2D, // GLenum target
+            0, // GLint level
+            GL_ALPHA, // GLint internalformat
+            width, // GLsizei width
+            height, // GLsizei height
+            0, // GLint border
+            GL_ALPHA, // GLenum format
+            GL_UNSIGNED_BYTE, // GLenum type
+            page.data.get() // const GLvoid* data
+        ));
+        page.regions.uploadedAll();
+    } else {
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
+        page.regions.upload(page.data.get(), GL_ALPHA, budget);
+    }
+}
+
+void GlyphAtlas::bind(uint16_t pageIndex) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (pageIndex >= pages.size() || !pages[pageIndex]) {
+        // The page was released; no tile should refer to it anymore.
+        return;
+    }
+
+    // Glyphs that upload() left pending for later frames may already be used by the bucket that
+    // is about to be drawn, so they're uploaded now regardless of the budget.
+    Page& page = *pages[pageIndex];
+    if (!page.texture || !page.regions.empty()) {
+        uploadPage(page, 0);
     } else {
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
     }
 };
@@ -2,6 +2,7 @@
 #define MBGL_GEOMETRY_GLYPH_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_regions.hpp>
 #include <mbgl/text/glyph_store.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/platform/gl.hpp>
@@ -11,12 +12,15 @@
 #include <map>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 namespace mbgl {
 
+// Glyph bitmaps are packed into pages of equal size, each with its own texture. Pages are added
+// when the existing ones are full, and released again once no tile uses their glyphs.
 class GlyphAtlas : public util::noncopyable {
 public:
-    GlyphAtlas(uint16_t width, uint16_t height);
+    GlyphAtlas(uint16_t width, uint16_t height, uint16_t maxPages = 8);
     ~GlyphAtlas();
 
     void addGlyphs(uintptr_t tileUID,
@@ -26,34 +30,67 @@ public:
                    GlyphPositions&);
     void removeGlyphs(uintptr_t tileUID);
 
-    // Binds the atlas texture to the GPU, and uploads data if it is out of date.
-    void bind();
+    // Binds the texture of a page to the GPU, and uploads its data if it doesn't exist yet or
+    // has glyphs that are still waiting to be uploaded.
+    void bind(uint16_t page);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
-    void upload();
+    // the texture is only bound when the data is out of date (=dirty). Only glyphs that were added
+    // since the last upload are transferred, up to `budget` bytes; the rest follows with the next
+    // upload. A budget of 0 uploads everything. Also frees the textures of released pages.
+    void upload(std::size_t budget = 0);
+
+    // Returns true when glyphs are waiting to be uploaded.
+    bool isDirty() const { return dirty; }
+
+    // Returns the number of pages that hold glyphs.
+    std::size_t getPageCount();
+
+    DirtyRegions::Statistics getUploadStatistics();
 
     const GLsizei width;
     const GLsizei height;
+    const uint16_t maxPages;
 
 private:
     struct GlyphValue {
-        GlyphValue(const Rect<uint16_t>& rect_, uintptr_t id)
-            : rect(rect_), ids({ id }) {}
+        GlyphValue(const Rect<uint16_t>& rect_, uint16_t page_, uintptr_t id)
+            : rect(rect_), page(page_), ids({ id }) {}
         Rect<uint16_t> rect;
+        uint16_t page;
         std::set<uintptr_t> ids;
     };
 
-    Rect<uint16_t> addGlyph(uintptr_t tileID,
-                            const std::string& stackName,
-                            const SDFGlyph&);
+    struct Page : private util::noncopyable {
+        Page(uint16_t width, uint16_t height);
+
+        BinPack<uint16_t> bin;
+        const std::unique_ptr<uint8_t[]> data;
+        DirtyRegions regions;
+        GLuint texture = 0;
+
+        // Number of glyphs on this page; the page is released when it drops to zero.
+        std::size_t glyphs = 0;
+    };
+
+    Glyph addGlyph(uintptr_t tileID,
+                   const std::string& stackName,
+                   const SDFGlyph&);
+    void uploadPage(Page&, std::size_t budget);
 
     std::mutex mtx;
-    BinPack<uint16_t> bin;
     std::map<std::string, std::map<uint32_t, GlyphValue>> index;
-    const std::unique_ptr<uint8_t[]> data;
+
+    // Released pages leave an empty slot, so that the indices of other pages remain valid.
+    std::vector<std::unique_ptr<Page>> pages;
+
+    // Textures of released pages; they can only be deleted on the map thread.
+    std::vector<GLuint> abandonedTextures;
+
+    // Uploads of released pages are kept in the total.
+    DirtyRegions::Statistics releasedStatistics;
+
     std::atomic<bool> dirty;
-    GLuint texture = 0;
 };
 
 };
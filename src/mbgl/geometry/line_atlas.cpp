@@ -16,6 +16,7 @@ LineAtlas::LineAtlas(GLsizei w, GLsizei h)
     : width(w),
       height(h),
       data(std::make_unique<GLbyte[]>(w * h)),
+      regions(w, h, 1),
       dirty(true) {
 }
 
@@ -122,6 +123,7 @@ LinePatternPos LineAtlas::addDash(const std::vector<float> &dasharray, bool roun
     position.height = (2.0 * n) / height;
     position.width = length;
 
+    regions.add({ 0, uint16_t(nextRow), uint16_t(width), uint16_t(dashheight) });
     nextRow += dashheight;
 
     dirty = true;
@@ -130,9 +132,16 @@ LinePatternPos LineAtlas::addDash(const std::vector<float> &dasharray, bool roun
     return position;
 };
 
-void LineAtlas::upload() {
+void LineAtlas::upload(std::size_t budget) {
     if (dirty) {
-        bind();
+        if (!texture) {
+            // The texture is allocated with all dashes.
+            bind();
+        } else {
+            MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+            regions.upload(data.get(), GL_ALPHA, budget);
+            dirty = !regions.empty();
+        }
     }
 }
 
@@ -165,21 +174,11 @@ void LineAtlas::bind() {
                 GL_UNSIGNED_BYTE, // GLenum type
                 data.get() // const GLvoid * data
             ));
+            regions.uploadedAll();
         } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
+            regions.upload(data.get(), GL_ALPHA, 0);
         }
 
-
         dirty = false;
     }
 };
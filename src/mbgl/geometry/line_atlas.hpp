@@ -1,6 +1,7 @@
 #ifndef MBGL_GEOMETRY_LINE_ATLAS
 #define MBGL_GEOMETRY_LINE_ATLAS
 
+#include <mbgl/geometry/dirty_regions.hpp>
 #include <mbgl/platform/gl.hpp>
 
 #include <vector>
@@ -24,8 +25,15 @@ public:
     void bind();
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
-    void upload();
+    // the texture is only bound when the data is out of date (=dirty). Only dashes that were added
+    // since the last upload are transferred, up to `budget` bytes; binding the atlas uploads the
+    // rest. A budget of 0 uploads everything.
+    void upload(std::size_t budget = 0);
+
+    // Returns true when dashes are waiting to be uploaded.
+    bool isDirty() const { return dirty; }
+
+    const DirtyRegions::Statistics& getUploadStatistics() const { return regions.getStatistics(); }
 
     LinePatternPos getDashPosition(const std::vector<float>&, bool);
     LinePatternPos addDash(const std::vector<float> &dasharray, bool round);
@@ -35,6 +43,7 @@ public:
 
 private:
     const std::unique_ptr<GLbyte[]> data;
+    DirtyRegions regions;
     bool dirty;
     GLuint texture = 0;
     int nextRow = 0;
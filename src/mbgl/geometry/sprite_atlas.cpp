@@ -28,6 +28,7 @@ SpriteAtlas::SpriteAtlas(dimension width_, dimension height_, float pixelRatio_,
       store(store_),
       bin(width_, height_),
       data(std::make_unique<uint32_t[]>(pixelWidth * pixelHeight)),
+      regions(pixelWidth, pixelHeight, sizeof(uint32_t)),
       dirty(true) {
     std::fill(data.get(), data.get() + pixelWidth * pixelHeight, 0);
 }
@@ -123,6 +124,8 @@ void SpriteAtlas::copy(const Holder& holder, const bool wrap) {
 
     util::bilinearScale(srcData, srcSize, srcPos, dstData, dstSize, dstPos, wrap);
 
+    Rect<uint32_t> changed = dstPos;
+
     // Add borders around the copied image if required.
     if (wrap) {
         // We're copying from the same image so we don't have to scale again.
@@ -152,17 +155,33 @@ void SpriteAtlas::copy(const Holder& holder, const bool wrap) {
             dstData, dstSize, { dstPos.x - borderX, dstPos.y, dstPos.w + 2 * borderX, border },
             dstData, dstSize,
             { dstPos.x - borderX, dstPos.y + dstPos.h, dstPos.w + border + borderX, border });
+
+        changed = { dstPos.x - borderX, dstPos.y - borderY,
+                    dstPos.w + borderX + border, dstPos.h + borderY + border };
     }
 
+    regions.add({ static_cast<uint16_t>(changed.x), static_cast<uint16_t>(changed.y),
+                  static_cast<uint16_t>(changed.w), static_cast<uint16_t>(changed.h) });
     dirty = true;
 }
 
-void SpriteAtlas::upload() {
+void SpriteAtlas::upload(std::size_t budget) {
     if (dirty) {
-        bind();
+        if (!texture) {
+            // The texture is allocated with all images.
+            bind();
+        } else {
+            MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+            uploadDirty(budget);
+        }
     }
 }
 
+DirtyRegions::Statistics SpriteAtlas::getUploadStatistics() {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+    return regions.getStatistics();
+}
+
 void SpriteAtlas::updateDirty() {
     auto dirtySprites = store.getDirty();
     if (dirtySprites.empty()) {
@@ -215,43 +234,38 @@ void SpriteAtlas::bind(bool linear) {
     }
 
     if (dirty) {
-        std::lock_guard<std::recursive_mutex> lock(mtx);
-
-        if (fullUploadRequired) {
-            MBGL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                GL_RGBA, // GLint internalformat
-                pixelWidth, // GLsizei width
-                pixelHeight, // GLsizei height
-                0, // GLint border
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid * data
-            ));
-            fullUploadRequired = false;
-        } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                pixelWidth, // GLsizei width
-                pixelHeight, // GLsizei height
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
-        }
+        uploadDirty(0);
+    }
+};
+
+void SpriteAtlas::uploadDirty(std::size_t budget) {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
 
-        dirty = false;
+    if (fullUploadRequired) {
+        MBGL_CHECK_ERROR(glTexImage2D(
+            GL_TEXTURE_2D, // GLenum target
+            0, // GLint level
+            GL_RGBA, // GLint internalformat
+            pixelWidth, // GLsizei width
+            pixelHeight, // GLsizei height
+            0, // GLint border
+            GL_RGBA, // GLenum format
+            GL_UNSIGNED_BYTE, // GLenum type
+            data.get() // const GLvoid * data
+        ));
+        regions.uploadedAll();
+        fullUploadRequired = false;
+    } else {
+        regions.upload(data.get(), GL_RGBA, budget);
+    }
+
+    dirty = !regions.empty();
 
 #ifndef GL_ES_VERSION_2_0
-        // platform::showColorDebugImage("Sprite Atlas", reinterpret_cast<const char*>(data.get()),
-        //                               pixelWidth, pixelHeight, pixelWidth, pixelHeight);
+    // platform::showColorDebugImage("Sprite Atlas", reinterpret_cast<const char*>(data.get()),
+    //                               pixelWidth, pixelHeight, pixelWidth, pixelHeight);
 #endif
-    }
-};
+}
 
 SpriteAtlas::~SpriteAtlas() {
     std::lock_guard<std::recursive_mutex> lock(mtx);
@@ -2,6 +2,7 @@
 #define MBGL_GEOMETRY_SPRITE_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_regions.hpp>
 #include <mbgl/platform/gl.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/ptr.hpp>
@@ -58,8 +59,15 @@ public:
     void updateDirty();
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
-    void upload();
+    // the texture is only bound when the data is out of date (=dirty). Only images that changed
+    // since the last upload are transferred, up to `budget` bytes; binding the atlas uploads the
+    // rest. A budget of 0 uploads everything.
+    void upload(std::size_t budget = 0);
+
+    // Returns true when images are waiting to be uploaded.
+    bool isDirty() const { return dirty; }
+
+    DirtyRegions::Statistics getUploadStatistics();
 
     inline dimension getWidth() const { return width; }
     inline dimension getHeight() const { return height; }
@@ -84,6 +92,7 @@ private:
 
     Rect<SpriteAtlas::dimension> allocateImage(size_t width, size_t height);
     void copy(const Holder& holder, const bool wrap);
+    void uploadDirty(std::size_t budget);
 
     std::recursive_mutex mtx;
     SpriteStore& store;
@@ -91,6 +100,7 @@ private:
     std::map<Key, Holder> images;
     std::set<std::string> uninitialized;
     const std::unique_ptr<uint32_t[]> data;
+    DirtyRegions regions;
     std::atomic<bool> dirty;
     bool fullUploadRequired = true;
     GLuint texture = 0;
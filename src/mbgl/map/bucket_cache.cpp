@@ -0,0 +1,203 @@
+#include <mbgl/map/bucket_cache.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace mbgl {
+
+namespace {
+
+const uint32_t magic = 0x4342424d; // "MBBC"
+
+// Files written by other versions are ignored, and overwritten once the tile is parsed again.
+const uint32_t version = 2;
+
+// Buffers are stored in the byte order of the machine that wrote them, so files that were copied
+// from a machine with a different byte order are ignored as well.
+const uint32_t byteOrder = 0x01020304;
+
+const std::string extension = ".buckets";
+
+// FNV-1a; the file names have to be the same in every run, which std::hash doesn't guarantee.
+uint64_t hash(const std::string& value) {
+    uint64_t result = 14695981039346656037ull;
+    for (const char c : value) {
+        result ^= static_cast<unsigned char>(c);
+        result *= 1099511628211ull;
+    }
+    return result;
+}
+
+} // namespace
+
+const uint64_t BucketCache::defaultMaxBytes = 256 * 1024 * 1024;
+
+BucketCache::BucketCache(const std::string& path_, uint64_t maxBytes_)
+    : path(path_), maxBytes(maxBytes_) {
+    // Pick up the files of previous runs, so that they count against the limit.
+    struct File {
+        std::string name;
+        time_t modified;
+        uint64_t size;
+    };
+    std::vector<File> files;
+
+    if (DIR* dir = opendir(path.c_str())) {
+        while (const dirent* entry = readdir(dir)) {
+            const std::string name = path + "/" + entry->d_name;
+            struct stat info;
+            if (name.size() > extension.size() &&
+                name.compare(name.size() - extension.size(), extension.size(), extension) == 0 &&
+                stat(name.c_str(), &info) == 0) {
+                files.push_back({ name, info.st_mtime, uint64_t(info.st_size) });
+            }
+        }
+        closedir(dir);
+    }
+
+    std::sort(files.begin(), files.end(), [] (const File& a, const File& b) {
+        return a.modified < b.modified;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& file : files) {
+        touch(file.name, file.size);
+    }
+    evict();
+}
+
+std::string BucketCache::filename(const std::string& tileKey) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash(tileKey)));
+    return path + "/" + name + extension;
+}
+
+void BucketCache::touch(const std::string& file, uint64_t size) {
+    auto it = entries.find(file);
+    if (it == entries.end()) {
+        order.push_front(file);
+        entries.emplace(file, Entry { size, order.begin() });
+    } else {
+        order.splice(order.begin(), order, it->second.position);
+        totalBytes -= it->second.size;
+        it->second.size = size;
+    }
+    totalBytes += size;
+}
+
+void BucketCache::evict() {
+    while (totalBytes > maxBytes && !order.empty()) {
+        const std::string& file = order.back();
+        std::remove(file.c_str());
+        totalBytes -= entries[file].size;
+        entries.erase(file);
+        order.pop_back();
+        evictions++;
+    }
+}
+
+std::string BucketCache::bucketKey(const std::string& name, const std::string& styleKey) {
+    return name + '\n' + styleKey;
+}
+
+BucketCache::Buckets BucketCache::get(const std::string& tileKey) {
+    Buckets buckets;
+
+    const std::string name = filename(tileKey);
+    std::ifstream file(name, std::ios::binary);
+    if (!file.good()) {
+        return buckets;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string data = stream.str();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        touch(name, data.size());
+    }
+
+    try {
+        Reader reader(data);
+        if (reader.read<uint32_t>() != magic || reader.read<uint32_t>() != version ||
+            reader.read<uint32_t>() != byteOrder) {
+            return buckets;
+        }
+
+        // Different tiles may hash to the same file name.
+        if (reader.readString() != tileKey) {
+            return buckets;
+        }
+
+        const auto count = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < count; i++) {
+            std::string key = reader.readString();
+            buckets.emplace(std::move(key), reader.readString());
+        }
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::ParseTile, "ignoring invalid bucket cache file for %s: %s", tileKey.c_str(), ex.what());
+        buckets.clear();
+    }
+
+    return buckets;
+}
+
+void BucketCache::put(const std::string& tileKey, const Buckets& buckets) {
+    Writer writer;
+    writer.write(magic);
+    writer.write(version);
+    writer.write(byteOrder);
+    writer.writeString(tileKey);
+    writer.write<uint32_t>(buckets.size());
+    for (const auto& bucket : buckets) {
+        writer.writeString(bucket.first);
+        writer.writeString(bucket.second);
+    }
+
+    // Workers that read the file at the same time must never see a partially written file, so
+    // we write to a temporary file first and replace the existing one in a single step.
+    const std::string target = filename(tileKey);
+    const std::string temporary = target + "." + util::toString(temporaryFiles++) + ".tmp";
+
+    try {
+        util::write_file(temporary, writer.data);
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::ParseTile, "can't write bucket cache file: %s", ex.what());
+        return;
+    }
+
+    if (std::rename(temporary.c_str(), target.c_str()) != 0) {
+        Log::Warning(Event::ParseTile, "can't replace bucket cache file %s", target.c_str());
+        std::remove(temporary.c_str());
+        return;
+    }
+
+    writes++;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    touch(target, writer.data.size());
+    evict();
+}
+
+BucketCache::Statistics BucketCache::getStatistics() const {
+    Statistics statistics;
+    statistics.hits = hits;
+    statistics.misses = misses;
+    statistics.writes = writes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics.evictions = evictions;
+    statistics.bytes = totalBytes;
+    return statistics;
+}
+
+} // namespace mbgl
@@ -0,0 +1,194 @@
+#ifndef MBGL_MAP_BUCKET_CACHE
+#define MBGL_MAP_BUCKET_CACHE
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// Stores the vertex and element buffers of parsed buckets on disk, so that tiles that are loaded
+// again, e.g. after they were evicted from the TileCache or after a restart, don't have to be
+// decoded and tessellated again. All buckets of a tile are stored in a single file in the cache
+// directory, which must exist. When the files exceed the size limit, the least recently used
+// ones are removed. Files that were in the directory already are ordered by modification time.
+//
+// Thread-safe; the workers use it concurrently.
+class BucketCache : private util::noncopyable {
+public:
+    struct Statistics {
+        uint64_t hits = 0;   // Buckets that were restored from the cache.
+        uint64_t misses = 0; // Buckets that had to be parsed.
+        uint64_t writes = 0; // Tiles that were written to the cache.
+        uint64_t evictions = 0; // Tiles that were removed to stay within the size limit.
+        uint64_t bytes = 0; // Size of all files in the cache.
+    };
+
+    // Serialized buckets of a tile, keyed by bucketKey().
+    using Buckets = std::unordered_map<std::string, std::string>;
+
+    BucketCache(const std::string& path, uint64_t maxBytes = defaultMaxBytes);
+
+    // The tile key identifies the tile data, e.g. by its URL and ETag. Returns an empty set if
+    // the tile isn't cached or if the file can't be read.
+    Buckets get(const std::string& tileKey);
+    void put(const std::string& tileKey, const Buckets&);
+
+    // Buckets are only reused as long as the style properties they were parsed with are the same.
+    static std::string bucketKey(const std::string& name, const std::string& styleKey);
+
+    void recordHit() { hits++; }
+    void recordMiss() { misses++; }
+    Statistics getStatistics() const;
+
+    static const uint64_t defaultMaxBytes;
+
+    class Writer {
+    public:
+        template <typename T>
+        void write(T value) {
+            static_assert(std::is_arithmetic<T>::value, "Only numbers can be written");
+            write(&value, sizeof(T));
+        }
+
+        void write(const void* bytes, std::size_t size) {
+            if (size) {
+                data.append(reinterpret_cast<const char*>(bytes), size);
+            }
+        }
+
+        void writeString(const std::string& value) {
+            write<uint32_t>(value.size());
+            write(value.data(), value.size());
+        }
+
+        // Buffers have to be written before they are uploaded.
+        template <typename Buffer>
+        void writeBuffer(const Buffer& buffer) {
+            if (!buffer.empty() && !buffer.data()) {
+                throw std::runtime_error("buffer was already uploaded");
+            }
+            write<uint32_t>(buffer.byteSize());
+            write(buffer.data(), buffer.byteSize());
+        }
+
+        template <typename Group>
+        void writeGroups(const std::vector<std::unique_ptr<Group>>& groups) {
+            write<uint32_t>(groups.size());
+            for (const auto& group : groups) {
+                write<int32_t>(group->vertex_length);
+                write<int32_t>(group->elements_length);
+            }
+        }
+
+        std::string data;
+    };
+
+    // Throws std::runtime_error when reading past the end, so that truncated files are treated
+    // like missing ones.
+    class Reader {
+    public:
+        Reader(const std::string& data_)
+            : pos(data_.data()), end(data_.data() + data_.size()) {}
+
+        template <typename T>
+        T read() {
+            static_assert(std::is_arithmetic<T>::value, "Only numbers can be read");
+            T value;
+            std::memcpy(&value, read(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        const char* read(std::size_t size) {
+            if (std::size_t(end - pos) < size) {
+                throw std::runtime_error("unexpected end of bucket data");
+            }
+            const char* bytes = pos;
+            pos += size;
+            return bytes;
+        }
+
+        std::string readString() {
+            const auto size = read<uint32_t>();
+            return { read(size), size };
+        }
+
+        template <typename Buffer>
+        void readBuffer(Buffer& buffer) {
+            const auto size = read<uint32_t>();
+            buffer.assign(read(size), size);
+        }
+
+        // The groups are drawn from consecutive ranges of the buffers, so they are checked against
+        // the buffers that were read before. They may cover fewer items than the buffers hold (a
+        // fill whose tessellation failed only has outline groups), but must not reach past them.
+        template <typename Group, typename VertexBuffer, typename ElementsBuffer>
+        void readGroups(std::vector<std::unique_ptr<Group>>& groups,
+                        const VertexBuffer& vertexBuffer,
+                        const ElementsBuffer& elementsBuffer) {
+            const auto count = read<uint32_t>();
+            groups.clear();
+            int64_t vertexCount = 0;
+            int64_t elementsCount = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                const auto vertexLength = read<int32_t>();
+                const auto elementsLength = read<int32_t>();
+                if (vertexLength < 0 || elementsLength < 0) {
+                    throw std::runtime_error("negative bucket group length");
+                }
+                vertexCount += vertexLength;
+                elementsCount += elementsLength;
+                groups.emplace_back(std::make_unique<Group>(vertexLength, elementsLength));
+            }
+            if (vertexCount > vertexBuffer.index() || elementsCount > elementsBuffer.index()) {
+                throw std::runtime_error("bucket groups exceed the buffers");
+            }
+        }
+
+        bool atEnd() const { return pos == end; }
+
+    private:
+        const char* pos;
+        const char* end;
+    };
+
+private:
+    std::string filename(const std::string& tileKey) const;
+
+    // Must be called with the mutex locked.
+    void touch(const std::string& file, uint64_t size);
+    void evict();
+
+    const std::string path;
+    const uint64_t maxBytes;
+
+    // Files in the cache directory with their sizes, most recently used first.
+    struct Entry {
+        uint64_t size;
+        std::list<std::string>::iterator position;
+    };
+    mutable std::mutex mutex;
+    std::list<std::string> order;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t totalBytes = 0;
+    uint64_t evictions = 0;
+
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+    std::atomic<uint64_t> writes { 0 };
+    std::atomic<uint64_t> temporaryFiles { 0 };
+};
+
+} // namespace mbgl
+
+#endif
@@ -12,6 +12,91 @@ mapbox::util::optional<Value> GeometryTileFeatureExtractor::getValue(const std::
     return feature.getValue(key);
 }
 
+mapbox::util::optional<Value> GeometryTileFeatureExtractor::getValue(const FilterKey& key) const {
+    switch (key.index) {
+    case FilterKey::Unresolved:
+        return getValue(key.name);
+    case FilterKey::Missing:
+        return mapbox::util::optional<Value>();
+    case FilterKey::Type:
+        return Value(uint64_t(feature.getType()));
+    default:
+        return feature.getValue(uint32_t(key.index));
+    }
+}
+
 template bool evaluate(const FilterExpression&, const GeometryTileFeatureExtractor&);
 
+class FilterCompiler : public mapbox::util::static_visitor<FilterExpression> {
+public:
+    FilterCompiler(const GeometryTileLayer& layer_)
+        : layer(layer_) {}
+
+    FilterExpression operator()(const NullExpression& expression) const {
+        return expression;
+    }
+
+    FilterExpression operator()(const AnyExpression& expression) const {
+        return compileCompound(expression);
+    }
+
+    FilterExpression operator()(const AllExpression& expression) const {
+        return compileCompound(expression);
+    }
+
+    FilterExpression operator()(const NoneExpression& expression) const {
+        return compileCompound(expression);
+    }
+
+    template <class Expression>
+    FilterExpression operator()(const Expression& expression) const {
+        Expression compiled = expression;
+        compiled.key.index = resolve(expression.key.name);
+        if (compiled.key.index == FilterKey::Missing) {
+            // The key doesn't occur in this layer, so the result is the same for every feature.
+            if (matchesMissingKey(compiled)) {
+                return NullExpression();
+            } else {
+                return AnyExpression();
+            }
+        }
+        return compiled;
+    }
+
+private:
+    template <class Expression>
+    static bool matchesMissingKey(const Expression&) { return false; }
+    static bool matchesMissingKey(const NotEqualsExpression&) { return true; }
+    static bool matchesMissingKey(const NotInExpression&) { return true; }
+
+    template <class Expression>
+    FilterExpression compileCompound(const Expression& expression) const {
+        Expression compiled;
+        compiled.expressions.reserve(expression.expressions.size());
+        for (const auto& e : expression.expressions) {
+            compiled.expressions.push_back(mapbox::util::apply_visitor(*this, e));
+        }
+        return compiled;
+    }
+
+    int32_t resolve(const std::string& name) const {
+        if (name == "$type") {
+            return FilterKey::Type;
+        }
+
+        if (!layer.hasKeyTable()) {
+            return FilterKey::Unresolved;
+        }
+
+        auto index = layer.getKeyIndex(name);
+        return index ? int32_t(*index) : int32_t(FilterKey::Missing);
+    }
+
+    const GeometryTileLayer& layer;
+};
+
+FilterExpression compileFilterExpression(const FilterExpression& filter, const GeometryTileLayer& layer) {
+    return optimizeFilterExpression(mapbox::util::apply_visitor(FilterCompiler(layer), filter));
+}
+
 }
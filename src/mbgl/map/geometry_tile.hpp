@@ -5,6 +5,7 @@
 #include <mapbox/optional.hpp>
 
 #include <mbgl/style/value.hpp>
+#include <mbgl/style/filter_expression.hpp>
 #include <mbgl/util/ptr.hpp>
 #include <mbgl/util/vec.hpp>
 #include <mbgl/util/noncopyable.hpp>
@@ -24,17 +25,28 @@ enum class FeatureType : uint8_t {
 
 typedef std::vector<std::vector<Coordinate>> GeometryCollection;
 
-class GeometryTileFeature : private util::noncopyable {
+class GeometryTileFeature {
 public:
     virtual FeatureType getType() const = 0;
     virtual mapbox::util::optional<Value> getValue(const std::string& key) const = 0;
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Decodes the geometries into an existing collection, reusing its storage where possible.
+    virtual void readGeometries(GeometryCollection& geometries) const { geometries = getGeometries(); }
+
+    // Looks up a value by an index obtained from GeometryTileLayer::getKeyIndex().
+    virtual mapbox::util::optional<Value> getValue(uint32_t) const { return {}; }
 };
 
 class GeometryTileLayer : private util::noncopyable {
 public:
     virtual std::size_t featureCount() const = 0;
-    virtual util::ptr<const GeometryTileFeature> getFeature(std::size_t) const = 0;
+    virtual const GeometryTileFeature& getFeature(std::size_t) const = 0;
+
+    // Layers with a key table can resolve keys to indices once, instead of looking up
+    // every value by name.
+    virtual bool hasKeyTable() const { return false; }
+    virtual mapbox::util::optional<uint32_t> getKeyIndex(const std::string&) const { return {}; }
 };
 
 class GeometryTile : private util::noncopyable {
@@ -48,11 +60,15 @@ public:
         : feature(feature_) {}
 
     mapbox::util::optional<Value> getValue(const std::string& key) const;
+    mapbox::util::optional<Value> getValue(const FilterKey& key) const;
 
 private:
     const GeometryTileFeature& feature;
 };
 
+// Resolves all keys referenced by the filter against the layer's key table.
+FilterExpression compileFilterExpression(const FilterExpression&, const GeometryTileLayer&);
+
 }
 
 #endif
@@ -94,6 +94,14 @@ Bucket* LiveTileData::getBucket(const StyleLayer& layer) {
     return it->second.get();
 }
 
+std::size_t LiveTileData::memoryUsage() const {
+    std::size_t bytes = 0;
+    for (const auto& bucket : buckets) {
+        bytes += bucket.second->memoryUsage();
+    }
+    return bytes;
+}
+
 void LiveTileData::cancel() {
     state = State::obsolete;
     workRequest.reset();
@@ -27,6 +27,7 @@ public:
 
     void cancel() override;
     Bucket* getBucket(const StyleLayer&) override;
+    std::size_t memoryUsage() const override;
 
 private:
     Worker& worker;
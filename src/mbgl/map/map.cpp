@@ -92,6 +92,11 @@ void Map::update(Update flags) {
         transform->resize(view.getSize());
     }
     context->invoke(&MapContext::triggerUpdate, transform->getState(), flags);
+
+    auto prefetchStates = transform->takePrefetchStates();
+    if (!prefetchStates.empty()) {
+        context->invoke(&MapContext::prefetch, std::move(prefetchStates));
+    }
 }
 
 #pragma mark - Style
@@ -496,6 +501,18 @@ void Map::setSourceTileCacheSize(size_t size) {
     context->invoke(&MapContext::setSourceTileCacheSize, size);
 }
 
+void Map::setSourceTileCacheBytes(size_t bytes) {
+    context->invoke(&MapContext::setSourceTileCacheBytes, bytes);
+}
+
+void Map::setSourceParentPrefetchLevels(std::vector<int32_t> levels) {
+    context->invoke(&MapContext::setSourceParentPrefetchLevels, std::move(levels));
+}
+
+void Map::setBucketCachePath(const std::string& path) {
+    context->invoke(&MapContext::setBucketCachePath, path);
+}
+
 void Map::onLowMemory() {
     context->invoke(&MapContext::onLowMemory);
 }
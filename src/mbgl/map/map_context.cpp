@@ -2,6 +2,7 @@
 #include <mbgl/map/map_data.hpp>
 #include <mbgl/map/view.hpp>
 #include <mbgl/map/still_image.hpp>
+#include <mbgl/map/bucket_cache.hpp>
 #include <mbgl/annotation/sprite_store.hpp>
 
 #include <mbgl/platform/log.hpp>
@@ -87,6 +88,15 @@ void MapContext::triggerUpdate(const TransformState& state, const Update flags)
     asyncUpdate->send();
 }
 
+void MapContext::prefetch(const std::vector<TransformState>& states) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    if (!style || !texturePool) {
+        return;
+    }
+
+    style->prefetch(states, *texturePool);
+}
+
 void MapContext::setStyleURL(const std::string& url) {
     if (styleURL == url) {
         return;
@@ -97,6 +107,9 @@ void MapContext::setStyleURL(const std::string& url) {
     styleJSON.clear();
 
     style = std::make_unique<Style>(data);
+    style->bucketCache = bucketCache;
+    style->sourceCacheBytes = sourceCacheBytes;
+    style->sourceParentPrefetchLevels = sourceParentPrefetchLevels;
 
     const size_t pos = styleURL.rfind('/');
     std::string base = "";
@@ -132,6 +145,9 @@ void MapContext::setStyleJSON(const std::string& json, const std::string& base)
     styleJSON = json;
 
     style = std::make_unique<Style>(data);
+    style->bucketCache = bucketCache;
+    style->sourceCacheBytes = sourceCacheBytes;
+    style->sourceParentPrefetchLevels = sourceParentPrefetchLevels;
 
     loadStyleJSON(json, base);
 }
@@ -288,6 +304,38 @@ void MapContext::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void MapContext::setSourceTileCacheBytes(size_t bytes) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    if (bytes != sourceCacheBytes) {
+        sourceCacheBytes = bytes;
+        if (!style) return;
+        style->sourceCacheBytes = sourceCacheBytes;
+        for (const auto &source : style->sources) {
+            source->setCacheMaxBytes(sourceCacheBytes);
+        }
+        asyncInvalidate->send();
+    }
+}
+
+void MapContext::setSourceParentPrefetchLevels(const std::vector<int32_t>& levels) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    sourceParentPrefetchLevels = levels;
+    if (!style) return;
+    style->sourceParentPrefetchLevels = sourceParentPrefetchLevels;
+    for (const auto &source : style->sources) {
+        source->setParentPrefetchLevels(sourceParentPrefetchLevels);
+    }
+    triggerUpdate(transformState);
+}
+
+void MapContext::setBucketCachePath(const std::string& path) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    bucketCache = path.empty() ? nullptr : std::make_shared<BucketCache>(path);
+    if (style) {
+        style->bucketCache = bucketCache;
+    }
+}
+
 void MapContext::onLowMemory() {
     assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
     if (!style) return;
@@ -25,6 +25,7 @@ class Sprite;
 class Worker;
 class StillImage;
 class SpriteImage;
+class BucketCache;
 struct LatLng;
 struct LatLngBounds;
 
@@ -41,6 +42,9 @@ public:
     void pause();
 
     void triggerUpdate(const TransformState&, Update = Update::Nothing);
+
+    // Starts loading the tiles for states that an animation passes through.
+    void prefetch(const std::vector<TransformState>&);
     void renderStill(const TransformState&, const FrameData&, Map::StillImageCallback callback);
 
     // Triggers a synchronous render. Returns true if style has been fully loaded.
@@ -57,6 +61,9 @@ public:
     void updateAnnotations();
 
     void setSourceTileCacheSize(size_t size);
+    void setSourceTileCacheBytes(size_t bytes);
+    void setSourceParentPrefetchLevels(const std::vector<int32_t>& levels);
+    void setBucketCachePath(const std::string& path);
     void onLowMemory();
 
     void cleanup();
@@ -86,6 +93,7 @@ private:
     std::unique_ptr<TexturePool> texturePool;
     std::unique_ptr<Painter> painter;
     std::unique_ptr<Style> style;
+    std::shared_ptr<BucketCache> bucketCache;
 
     std::string styleURL;
     std::string styleJSON;
@@ -94,6 +102,8 @@ private:
 
     Map::StillImageCallback callback;
     size_t sourceCacheSize;
+    size_t sourceCacheBytes = TileCache::defaultMaxBytes;
+    std::vector<int32_t> sourceParentPrefetchLevels;
     TransformState transformState;
     FrameData frameData;
 };
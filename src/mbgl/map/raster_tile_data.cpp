@@ -3,6 +3,7 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
 #include <mbgl/util/worker.hpp>
 #include <mbgl/util/work_request.hpp>
 
@@ -57,8 +58,10 @@ void RasterTileData::request(float pixelRatio,
             state = State::loaded;
         }
 
-        workRequest = worker.parseRasterTile(std::make_unique<RasterBucket>(texturePool, layout), res.data, [this, callback] (TileParseResult result) {
+        const auto priority = prefetching ? Worker::Priority::Low : Worker::Priority::Regular;
+        workRequest = worker.parseRasterTile(std::make_unique<RasterBucket>(texturePool, layout), res.data, [this, callback, started = Clock::now()] (TileParseResult result) {
             workRequest.reset();
+            parseTime += Clock::now() - started;
             if (state != State::loaded) {
                 return;
             }
@@ -78,7 +81,7 @@ void RasterTileData::request(float pixelRatio,
             }
 
             callback();
-        });
+        }, priority);
     });
 }
 
@@ -86,6 +89,18 @@ Bucket* RasterTileData::getBucket(StyleLayer const&) {
     return bucket.get();
 }
 
+std::size_t RasterTileData::memoryUsage() const {
+    return bucket ? bucket->memoryUsage() : 0;
+}
+
+void RasterTileData::setPriority(double rank, bool prefetch) {
+    req.setPriority(rank, prefetch);
+    if (prefetching && !prefetch) {
+        worker.raisePriority(workRequest, Worker::Priority::Regular);
+    }
+    prefetching = prefetch;
+}
+
 void RasterTileData::cancel() {
     if (state != State::obsolete) {
         state = State::obsolete;
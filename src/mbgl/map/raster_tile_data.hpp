@@ -23,8 +23,10 @@ public:
                  const std::function<void()>& callback);
 
     void cancel() override;
+    void setPriority(double rank, bool prefetch = false) override;
 
     Bucket* getBucket(StyleLayer const &layer_desc) override;
+    std::size_t memoryUsage() const override;
 
 private:
     TexturePool& texturePool;
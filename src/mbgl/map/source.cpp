@@ -33,6 +33,14 @@
 
 namespace mbgl {
 
+namespace {
+
+// Upper bound for the number of tiles that are prefetched per source and animation, so that
+// prefetching doesn't use up much bandwidth or memory when the camera moves far.
+const std::size_t maxPrefetchedTiles = 32;
+
+} // namespace
+
 void parse(const rapidjson::Value& value, std::vector<std::string>& target, const char *name) {
     if (!value.HasMember(name))
         return;
@@ -282,29 +290,37 @@ TileData::State Source::addTile(MapData& data,
     }
 
     if (!new_tile.data) {
-        auto callback = std::bind(&Source::tileLoadingCompleteCallback, this, normalized_id, transformState, data.getCollisionDebug());
-
         // If we don't find working tile data, we're just going to load it.
-        if (info.type == SourceType::Vector) {
-            auto tileData = std::make_shared<VectorTileData>(normalized_id, style, info);
-            tileData->request(data.pixelRatio, callback);
-            new_tile.data = tileData;
-        } else if (info.type == SourceType::Raster) {
-            auto tileData = std::make_shared<RasterTileData>(normalized_id, texturePool, info, style.workers);
-            tileData->request(data.pixelRatio, callback);
-            new_tile.data = tileData;
-        } else if (info.type == SourceType::Annotations) {
-            new_tile.data = std::make_shared<LiveTileData>(normalized_id,
-                    data.getAnnotationManager()->getTile(normalized_id), style, info, callback);
-        } else {
-            throw std::runtime_error("source type not implemented");
-        }
+        new_tile.data = loadTile(data, transformState, style, texturePool, normalized_id);
         tile_data.emplace(new_tile.data->id, new_tile.data);
     }
 
     return new_tile.data->getState();
 }
 
+std::shared_ptr<TileData> Source::loadTile(MapData& data,
+                                           const TransformState& transformState,
+                                           Style& style,
+                                           TexturePool& texturePool,
+                                           const TileID& normalized_id) {
+    auto callback = std::bind(&Source::tileLoadingCompleteCallback, this, normalized_id, transformState, data.getCollisionDebug());
+
+    if (info.type == SourceType::Vector) {
+        auto tileData = std::make_shared<VectorTileData>(normalized_id, style, info);
+        tileData->request(data.pixelRatio, callback);
+        return tileData;
+    } else if (info.type == SourceType::Raster) {
+        auto tileData = std::make_shared<RasterTileData>(normalized_id, texturePool, info, style.workers);
+        tileData->request(data.pixelRatio, callback);
+        return tileData;
+    } else if (info.type == SourceType::Annotations) {
+        return std::make_shared<LiveTileData>(normalized_id,
+                data.getAnnotationManager()->getTile(normalized_id), style, info, callback);
+    } else {
+        throw std::runtime_error("source type not implemented");
+    }
+}
+
 double Source::getZoom(const TransformState& state) const {
     double offset = std::log(util::tileSize / info.tile_size) / std::log(2);
     return state.getZoom() + offset;
@@ -387,7 +403,10 @@ bool Source::findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, std::
 void Source::findLoadedParent(const TileID& id, int32_t minCoveringZoom, std::forward_list<TileID>& retain) {
     for (int32_t z = id.z - 1; z >= minCoveringZoom; --z) {
         const TileID parent_id = id.parent(z, info.max_zoom);
-        const TileData::State state = hasTile(parent_id);
+        TileData::State state = hasTile(parent_id);
+        if (state == TileData::State::invalid) {
+            state = addParentTile(parent_id);
+        }
         if (TileData::isReadyState(state)) {
             retain.emplace_front(parent_id);
             if (state == TileData::State::parsed) {
@@ -416,6 +435,8 @@ bool Source::update(MapData& data,
     }
     std::forward_list<TileID> required = coveringTiles(transformState);
 
+    prefetchParents(data, transformState, style, texturePool, required);
+
     // Determine the overzooming/underzooming amounts.
     int32_t minCoveringZoom = util::clamp<int32_t>(zoom - 10, info.min_zoom, info.max_zoom);
     int32_t maxCoveringZoom = util::clamp<int32_t>(zoom + 1,  info.min_zoom, info.max_zoom);
@@ -425,6 +446,10 @@ bool Source::update(MapData& data,
     // parent or child tiles that are *already* loaded.
     std::forward_list<TileID> retain(required);
 
+    // Tiles are sorted by their distance from the center of the viewport. Requests for tiles that
+    // are still loading or parsing are reprioritized accordingly, so that the closest tiles load first.
+    double rank = 0;
+
     // Add existing child/parent tiles if the actual tile is not yet loaded
     for (const auto& id : required) {
         TileData::State state = hasTile(id);
@@ -444,6 +469,12 @@ bool Source::update(MapData& data,
             break;
         }
 
+        if (state == TileData::State::loading || state == TileData::State::loaded) {
+            // This also moves tiles that were prefetched ahead of the ones that still are.
+            tiles.find(id)->second->data->setPriority(rank);
+        }
+        rank++;
+
         if (!TileData::isReadyState(state)) {
             // The tile we require is not yet loaded. Try to find a parent or
             // child tile that we already have.
@@ -489,13 +520,15 @@ bool Source::update(MapData& data,
     });
 
     // Remove all the expired pointers from the set.
-    util::erase_if(tile_data, [&retain_data, &tileCache](std::pair<const TileID, std::weak_ptr<TileData>> &pair) {
+    util::erase_if(tile_data, [&retain_data, &tileCache, this](std::pair<const TileID, std::weak_ptr<TileData>> &pair) {
         const util::ptr<TileData> tile = pair.second.lock();
         if (!tile) {
             return true;
         }
 
-        bool obsolete = retain_data.find(tile->id) == retain_data.end();
+        bool obsolete = retain_data.find(tile->id) == retain_data.end() &&
+                        prefetched.find(tile->id) == prefetched.end() &&
+                        parents.find(tile->id) == parents.end();
         if (obsolete) {
             if (!tileCache.has(tile->id.normalized().to_uint64())) {
                 tile->cancel();
@@ -518,7 +551,139 @@ bool Source::update(MapData& data,
     return allTilesUpdated;
 }
 
+void Source::prefetch(MapData& data,
+                      const std::vector<TransformState>& states,
+                      Style& style,
+                      TexturePool& texturePool) {
+    if (!loaded || (info.type != SourceType::Vector && info.type != SourceType::Raster)) {
+        return;
+    }
+
+    releasePrefetchedTiles();
+
+    // Tiles are ranked in the order of the states, and by their distance from the center within
+    // each state.
+    double rank = 0;
+    for (const auto& state : states) {
+        for (const auto& id : coveringTiles(state)) {
+            if (prefetched.size() >= maxPrefetchedTiles) {
+                return;
+            }
+
+            const TileID normalized_id = id.normalized();
+            const auto it = tile_data.find(normalized_id);
+            if ((it != tile_data.end() && !it->second.expired()) ||
+                prefetched.count(normalized_id) || cache.has(normalized_id.to_uint64())) {
+                // Loading or loaded already.
+                continue;
+            }
+
+            auto tileData = loadTile(data, state, style, texturePool, normalized_id);
+            tileData->setPriority(rank++, true);
+            tile_data[normalized_id] = tileData;
+            prefetched.emplace(normalized_id, std::move(tileData));
+        }
+    }
+}
+
+void Source::releasePrefetchedTiles() {
+    for (const auto& pair : prefetched) {
+        releaseTileData(pair.first, pair.second);
+    }
+    prefetched.clear();
+}
+
+void Source::prefetchParents(MapData& data,
+                             const TransformState& transformState,
+                             Style& style,
+                             TexturePool& texturePool,
+                             const std::forward_list<TileID>& required) {
+    if ((parentPrefetchLevels.empty() && parents.empty()) ||
+        (info.type != SourceType::Vector && info.type != SourceType::Raster)) {
+        return;
+    }
+
+    // Closer ancestors are more detailed, so they're loaded first.
+    std::map<TileID, std::shared_ptr<TileData>> needed;
+    double rank = 0;
+    for (const int32_t level : parentPrefetchLevels) {
+        for (const auto& id : required) {
+            const int32_t z = id.z - level;
+            if (level <= 0 || z < info.min_zoom) {
+                continue;
+            }
+
+            const TileID normalized_id = id.parent(z, info.max_zoom).normalized();
+            if (needed.count(normalized_id)) {
+                continue;
+            }
+
+            std::shared_ptr<TileData> tileData;
+            const auto it = parents.find(normalized_id);
+            if (it != parents.end()) {
+                tileData = it->second;
+            } else {
+                const auto existing = tile_data.find(normalized_id);
+                if (existing != tile_data.end()) {
+                    tileData = existing->second.lock();
+                }
+                if (tileData && tileData->getState() == TileData::State::obsolete) {
+                    tileData.reset();
+                }
+                if (!tileData) {
+                    tileData = cache.get(normalized_id.to_uint64());
+                }
+                if (!tileData) {
+                    tileData = loadTile(data, transformState, style, texturePool, normalized_id);
+                }
+                tile_data[normalized_id] = tileData;
+            }
+
+            tileData->setPriority(rank++, true);
+            needed.emplace(normalized_id, std::move(tileData));
+        }
+    }
+
+    parents.swap(needed);
+    for (const auto& pair : needed) {
+        if (!parents.count(pair.first)) {
+            releaseTileData(pair.first, pair.second);
+        }
+    }
+}
+
+TileData::State Source::addParentTile(const TileID& id) {
+    const auto it = parents.find(id.normalized());
+    if (it == parents.end() || !it->second->isReady()) {
+        return TileData::State::invalid;
+    }
+
+    // The ancestor has been loaded in the background; show it in place of missing tiles.
+    auto& tile = tiles.emplace(id, std::make_unique<Tile>(id)).first->second;
+    tile->data = it->second;
+    return tile->data->getState();
+}
+
+void Source::releaseTileData(const TileID& normalized_id, const std::shared_ptr<TileData>& tileData) {
+    const bool used = std::any_of(tiles.begin(), tiles.end(), [&](const auto& tile) {
+        return tile.second->data == tileData;
+    });
+    if (used) {
+        // Tiles that are in use are released by update() like all others.
+        return;
+    }
+
+    if (info.type != SourceType::Raster && tileData->getState() == TileData::State::parsed) {
+        // Keep the work that was done already, in case the camera comes back this way.
+        cache.add(normalized_id.to_uint64(), tileData);
+    } else if (!cache.has(normalized_id.to_uint64())) {
+        tileData->cancel();
+    }
+}
+
 void Source::invalidateTiles() {
+    prefetched.clear();
+    parents.clear();
     cache.clear();
     tiles.clear();
     tile_data.clear();
@@ -536,6 +701,31 @@ void Source::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
+void Source::setCacheMaxBytes(size_t bytes) {
+    cache.setMaxBytes(bytes);
+}
+
+const TileCache::Statistics& Source::getCacheStatistics() const {
+    return cache.getStatistics();
+}
+
+void Source::setParentPrefetchLevels(std::vector<int32_t> levels) {
+    parentPrefetchLevels = std::move(levels);
+
+    // Take effect with the next update.
+    updated = TimePoint::min();
+}
+
+Source::ParentPrefetchStatistics Source::getParentPrefetchStatistics() const {
+    ParentPrefetchStatistics statistics;
+    for (const auto& pair : parents) {
+        statistics.tiles++;
+        statistics.bytes += pair.second->memoryUsage();
+        statistics.parseTime += pair.second->getParseTime();
+    }
+    return statistics;
+}
+
 void Source::onLowMemory() {
     cache.clear();
 }
@@ -19,6 +19,7 @@
 #include <iosfwd>
 #include <map>
 #include <unordered_set>
+#include <vector>
 
 namespace mbgl {
 
@@ -78,6 +79,14 @@ public:
                 TexturePool&,
                 bool shouldReparsePartialTiles);
 
+    // Starts loading the tiles that cover the given states, in order, at prefetch priority, so
+    // that they are ready by the time the camera gets there. Replaces the tiles that were
+    // prefetched before, unless they're in use by now.
+    void prefetch(MapData&,
+                  const std::vector<TransformState>&,
+                  Style&,
+                  TexturePool&);
+
     void invalidateTiles();
 
     void updateMatrices(const mat4 &projMatrix, const TransformState &transform);
@@ -88,8 +97,23 @@ public:
     const std::vector<Tile*>& getTiles() const;
 
     void setCacheSize(size_t);
+    void setCacheMaxBytes(size_t);
+    const TileCache::Statistics& getCacheStatistics() const;
     void onLowMemory();
 
+    // Keeps the ancestors of the visible tiles loaded, this many zoom levels above them, e.g.
+    // { 2, 4 }. They're loaded at prefetch priority, cover the screen while the visible tiles are
+    // loading, and make zooming out immediate. Empty by default.
+    void setParentPrefetchLevels(std::vector<int32_t>);
+
+    struct ParentPrefetchStatistics {
+        std::size_t tiles = 0;                 // Ancestors that are kept, loaded or not.
+        std::size_t bytes = 0;                 // Memory used by those that are loaded.
+        Duration parseTime = Duration::zero(); // Time it took to parse them.
+    };
+
+    ParentPrefetchStatistics getParentPrefetchStatistics() const;
+
     void setObserver(Observer* observer);
 
     SourceInfo info;
@@ -115,6 +139,20 @@ private:
                             TexturePool&,
                             const TileID&);
 
+    std::shared_ptr<TileData> loadTile(MapData&,
+                                       const TransformState&,
+                                       Style&,
+                                       TexturePool&,
+                                       const TileID& normalized_id);
+    void releasePrefetchedTiles();
+    void prefetchParents(MapData&,
+                         const TransformState&,
+                         Style&,
+                         TexturePool&,
+                         const std::forward_list<TileID>& required);
+    TileData::State addParentTile(const TileID&);
+    void releaseTileData(const TileID& normalized_id, const std::shared_ptr<TileData>&);
+
     TileData::State hasTile(const TileID& id);
     void updateTilePtrs();
 
@@ -130,6 +168,14 @@ private:
     std::map<TileID, std::weak_ptr<TileData>> tile_data;
     TileCache cache;
 
+    // Tiles that were loaded ahead of time, indexed by normalized ID. They're kept alive here
+    // until the next prefetch, since no Tile may refer to them yet.
+    std::map<TileID, std::shared_ptr<TileData>> prefetched;
+
+    // Ancestors of the visible tiles, indexed by normalized ID.
+    std::vector<int32_t> parentPrefetchLevels;
+    std::map<TileID, std::shared_ptr<TileData>> parents;
+
     RequestHolder req;
     Observer* observer_ = nullptr;
 };
@@ -4,61 +4,78 @@
 
 namespace mbgl {
 
+const size_t TileCache::defaultMaxBytes = 64 * 1024 * 1024;
+
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+    index.reserve(size);
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
-
-    tiles.reserve(size);
+void TileCache::setMaxBytes(size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    evict();
 }
 
 void TileCache::add(uint64_t key, std::shared_ptr<TileData> data) {
-
-    // insert new or query existing data
-    if (tiles.emplace(key, data).second) {
-        // remove existing data key
-        orderedKeys.remove(key);
+    assert(data);
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Replace the existing data and mark it as the newest entry.
+        totalBytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
     }
 
-    // (re-)insert data key as newest
-    orderedKeys.push_back(key);
+    const size_t bytes = data->memoryUsage();
+    entries.push_back({ key, std::move(data), bytes });
+    index.emplace(key, std::prev(entries.end()));
+    totalBytes += bytes;
 
     // purge oldest key/data if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
-    }
-
-    assert(orderedKeys.size() <= size);
+    evict();
 };
 
 std::shared_ptr<TileData> TileCache::get(uint64_t key) {
-
-    std::shared_ptr<TileData> data;
-
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        data = it->second;
-        tiles.erase(it);
-        orderedKeys.remove(key);
-        assert(data->isReady());
+    auto it = index.find(key);
+    if (it == index.end()) {
+        statistics.misses++;
+        return nullptr;
     }
 
+    std::shared_ptr<TileData> data = std::move(it->second->data);
+    totalBytes -= it->second->bytes;
+    entries.erase(it->second);
+    index.erase(it);
+    statistics.hits++;
+
+    assert(data->isReady());
     return data;
 };
 
 bool TileCache::has(uint64_t key) {
-    return tiles.find(key) != tiles.end();
+    return index.find(key) != index.end();
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    entries.clear();
+    index.clear();
+    totalBytes = 0;
+}
+
+void TileCache::evict() {
+    while (!entries.empty() && (entries.size() > size || totalBytes > maxBytes)) {
+        const Entry& oldest = entries.front();
+        statistics.evictions++;
+        statistics.evictedBytes += oldest.bytes;
+        totalBytes -= oldest.bytes;
+        index.erase(oldest.key);
+        entries.pop_front();
+    }
+
+    assert(entries.size() <= size);
+    assert(totalBytes <= maxBytes);
 }
 
 };
@@ -3,26 +3,63 @@
 
 #include <mbgl/map/tile_data.hpp>
 
+#include <cstdint>
 #include <list>
 #include <unordered_map>
 
 namespace mbgl {
 
+// Least recently used cache of tiles that are no longer displayed. The cache is bounded by the
+// number of tiles as well as by the memory used by the tiles; whichever limit is hit first causes
+// the least recently added tiles to be evicted. All operations take constant time.
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;
+    };
+
+    TileCache(size_t size_ = 0, size_t maxBytes_ = defaultMaxBytes)
+        : size(size_), maxBytes(maxBytes_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+    void setMaxBytes(size_t);
+    size_t getMaxBytes() const { return maxBytes; }
+
     void add(uint64_t key, std::shared_ptr<TileData> data);
     std::shared_ptr<TileData> get(uint64_t key);
     bool has(uint64_t key);
     void clear();
+
+    // Number of tiles and bytes that are currently held by the cache.
+    size_t count() const { return entries.size(); }
+    size_t bytes() const { return totalBytes; }
+
+    const Statistics& getStatistics() const { return statistics; }
+
+    static const size_t defaultMaxBytes;
+
 private:
-    std::unordered_map<uint64_t, std::shared_ptr<TileData>> tiles;
-    std::list<uint64_t> orderedKeys;
+    struct Entry {
+        uint64_t key;
+        std::shared_ptr<TileData> data;
+        size_t bytes;
+    };
+
+    void evict();
+
+    // Ordered from least to most recently added.
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
 
     size_t size;
+    size_t maxBytes;
+    size_t totalBytes = 0;
+
+    Statistics statistics;
 };
 
 };
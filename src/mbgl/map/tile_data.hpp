@@ -5,6 +5,7 @@
 #include <mbgl/map/tile_id.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <atomic>
 #include <string>
@@ -76,6 +77,13 @@ public:
 
     virtual Bucket* getBucket(const StyleLayer&) = 0;
 
+    // Returns the approximate number of bytes held by this tile, including its buckets.
+    virtual std::size_t memoryUsage() const = 0;
+
+    // Tiles with a lower rank are loaded first, and tiles that aren't visible yet are only
+    // loaded when nothing else is waiting; see Request::setPriority().
+    virtual void setPriority(double /* rank */, bool /* prefetch */ = false) {}
+
     virtual bool parsePending(std::function<void ()>) { return true; }
     virtual void redoPlacement(PlacementConfig) {}
 
@@ -91,6 +99,12 @@ public:
         return error;
     }
 
+    // Time that parsing this tile took so far, from handing the data to a worker until the result
+    // arrived, added up over all parses.
+    Duration getParseTime() const {
+        return parseTime;
+    }
+
     const TileID id;
 
     // Contains the tile ID string for painting debug information.
@@ -99,6 +113,11 @@ public:
 protected:
     std::atomic<State> state;
     std::string error;
+    Duration parseTime = Duration::zero();
+
+    // Whether the tile was last prioritized as one that isn't visible yet. Such tiles are parsed
+    // at a low priority, so that they don't hold up the visible ones.
+    bool prefetching = false;
 };
 
 } // namespace mbgl
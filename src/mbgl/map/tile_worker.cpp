@@ -12,6 +12,7 @@
 #include <mbgl/platform/log.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/string.hpp>
 
 using namespace mbgl;
 
@@ -25,7 +26,8 @@ TileWorker::TileWorker(TileID id_,
       sourceID(sourceID_),
       parameters(id.z),
       style(style_),
-      state(state_) {
+      state(state_),
+      bucketCache(style_.bucketCache) {
     assert(style.sprite);
 }
 
@@ -34,9 +36,19 @@ TileWorker::~TileWorker() {
 }
 
 TileParseResult TileWorker::parseAllLayers(const GeometryTile& geometryTile,
-                                           PlacementConfig config) {
+                                           PlacementConfig config,
+                                           const std::string& cacheKey) {
     // We're doing a fresh parse of the tile, because the underlying data has changed.
     pending.clear();
+    shapingStatistics = ShapingCache::Statistics();
+
+    // Overscaled tiles use the data of their source tile, but their buckets are different.
+    tileKey = bucketCache && !cacheKey.empty()
+        ? sourceID + '\n' + std::string(id) + '\n' + util::toString(id.overscaling) + '\n' + cacheKey
+        : "";
+    cachedBuckets = tileKey.empty() ? BucketCache::Buckets() : bucketCache->get(tileKey);
+    storedBuckets.clear();
+    storedBucketsChanged = false;
 
     // Reset the collision tile so we have a clean slate; we're placing all features anyway.
     collisionTile = std::make_unique<CollisionTile>(config);
@@ -53,11 +65,23 @@ TileParseResult TileWorker::parseAllLayers(const GeometryTile& geometryTile,
         }
     }
 
+    parseGeometryBuckets();
+
+    if (storedBucketsChanged && state != TileData::State::obsolete) {
+        bucketCache->put(tileKey, storedBuckets);
+    }
+    cachedBuckets.clear();
+    storedBuckets.clear();
+
+    reportShapingStatistics();
+
     result.state = pending.empty() ? TileData::State::parsed : TileData::State::partial;
     return std::move(result);
 }
 
 TileParseResult TileWorker::parsePendingLayers() {
+    shapingStatistics = ShapingCache::Statistics();
+
     // Try parsing the remaining layers that we couldn't parse in the first step due to missing
     // dependencies.
     for (auto it = pending.begin(); it != pending.end();) {
@@ -69,7 +93,9 @@ TileParseResult TileWorker::parsePendingLayers() {
             auto symbolBucket = dynamic_cast<SymbolBucket*>(bucket.get());
             if (!symbolBucket->needsDependencies(*style.glyphStore, *style.sprite)) {
                 symbolBucket->addFeatures(reinterpret_cast<uintptr_t>(this), *style.spriteAtlas,
-                                          *style.glyphAtlas, *style.glyphStore, *collisionTile);
+                                          *style.glyphAtlas, *style.glyphStore,
+                                          *style.shapingCache, *collisionTile);
+                shapingStatistics += symbolBucket->getShapingStatistics();
                 insertBucket(styleBucket.name, std::move(bucket));
                 pending.erase(it++);
                 continue;
@@ -80,10 +106,25 @@ TileParseResult TileWorker::parsePendingLayers() {
         ++it;
     }
 
+    reportShapingStatistics();
+
     result.state = pending.empty() ? TileData::State::parsed : TileData::State::partial;
     return std::move(result);
 }
 
+void TileWorker::reportShapingStatistics() const {
+    const uint64_t lookups = shapingStatistics.hits + shapingStatistics.misses;
+    if (lookups == 0) {
+        return;
+    }
+
+    Log::Debug(Event::ParseTile, "%s: shaped %llu labels, %.0f%% from the shaping cache, saved %lld us",
+               std::string(id).c_str(), static_cast<unsigned long long>(lookups),
+               100.0 * shapingStatistics.hits / lookups,
+               static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                   shapingStatistics.saved()).count()));
+}
+
 void TileWorker::redoPlacement(
     const std::unordered_map<std::string, std::unique_ptr<Bucket>>* buckets,
     PlacementConfig config) {
@@ -144,13 +185,13 @@ void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometr
 
     switch (styleBucket.type) {
     case StyleLayerType::Fill:
-        createFillBucket(*geometryLayer, styleBucket);
+        createFillBucket(geometryLayer, styleBucket);
         break;
     case StyleLayerType::Line:
-        createLineBucket(*geometryLayer, styleBucket);
+        createLineBucket(geometryLayer, styleBucket);
         break;
     case StyleLayerType::Circle:
-        createCircleBucket(*geometryLayer, styleBucket);
+        createCircleBucket(geometryLayer, styleBucket);
         break;
     case StyleLayerType::Symbol:
         createSymbolBucket(*geometryLayer, styleBucket);
@@ -164,33 +205,142 @@ void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometr
 }
 
 template <class Bucket>
-void TileWorker::addBucketGeometries(Bucket& bucket, const GeometryTileLayer& layer, const FilterExpression &filter) {
-    for (std::size_t i = 0; i < layer.featureCount(); i++) {
-        auto feature = layer.getFeature(i);
+void TileWorker::addBucketGeometries(std::unique_ptr<Bucket> bucket,
+                                     const util::ptr<GeometryTileLayer>& layer,
+                                     const StyleBucket& styleBucket) {
+    if (restoreBucket(*bucket, styleBucket)) {
+        insertBucket(styleBucket.name, std::move(bucket));
+        return;
+    }
+
+    auto& group = geometryBuckets[styleBucket.source_layer];
+    group.layer = layer;
+
+    Bucket* target = bucket.get();
+    group.buckets.push_back({ styleBucket, std::move(bucket), [target](const GeometryCollection& geometries) {
+        target->addGeometry(geometries);
+    }, [target](BucketCache::Writer& writer) {
+        target->serialize(writer);
+    }});
+}
+
+template <class Bucket>
+bool TileWorker::restoreBucket(Bucket& bucket, const StyleBucket& styleBucket) {
+    if (tileKey.empty() || styleBucket.cacheKey.empty()) {
+        return false;
+    }
+
+    const std::string key = BucketCache::bucketKey(styleBucket.name, styleBucket.cacheKey);
+    auto it = cachedBuckets.find(key);
+    if (it == cachedBuckets.end()) {
+        bucketCache->recordMiss();
+        return false;
+    }
 
-        if (state == TileData::State::obsolete)
-            return;
+    try {
+        BucketCache::Reader reader(it->second);
+        bucket.deserialize(reader);
+        if (!reader.atEnd()) {
+            throw std::runtime_error("unexpected data after bucket");
+        }
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::ParseTile, "can't restore bucket '%s' of tile %s: %s",
+                styleBucket.name.c_str(), std::string(id).c_str(), ex.what());
+
+        // Bring the bucket back into its initial state, so that it can be parsed instead.
+        BucketCache::Writer empty;
+        Bucket().serialize(empty);
+        BucketCache::Reader reader(empty.data);
+        bucket.deserialize(reader);
+
+        cachedBuckets.erase(it);
+        bucketCache->recordMiss();
+        return false;
+    }
 
-        GeometryTileFeatureExtractor extractor(*feature);
-        if (!evaluate(filter, extractor))
-            continue;
+    // Keep the entry when the file is written again for other buckets of this tile.
+    storedBuckets.emplace(key, std::move(it->second));
+    cachedBuckets.erase(it);
+    bucketCache->recordHit();
+    return true;
+}
 
-        bucket->addGeometry(feature->getGeometries());
+void TileWorker::storeBucket(const GeometryBucket& bucket) {
+    if (tileKey.empty() || bucket.styleBucket.cacheKey.empty()) {
+        return;
     }
+
+    BucketCache::Writer writer;
+    bucket.serialize(writer);
+    storedBuckets[BucketCache::bucketKey(bucket.styleBucket.name, bucket.styleBucket.cacheKey)] = std::move(writer.data);
+    storedBucketsChanged = true;
 }
 
-void TileWorker::createFillBucket(const GeometryTileLayer& layer,
+void TileWorker::parseGeometryBuckets() {
+    auto groups = std::move(geometryBuckets);
+    geometryBuckets.clear();
+
+    std::vector<FilterExpression> filters;
+    std::vector<GeometryBucket*> matching;
+    GeometryCollection geometries;
+
+    for (auto& entry : groups) {
+        const GeometryTileLayer& layer = *entry.second.layer;
+        auto& buckets = entry.second.buckets;
+
+        // Buckets whose filter can't match any feature of this layer don't take part in the pass.
+        filters.clear();
+        matching.clear();
+        for (auto& bucket : buckets) {
+            FilterExpression filter = compileFilterExpression(bucket.styleBucket.filter, layer);
+            if (!isFalseFilter(filter)) {
+                filters.push_back(std::move(filter));
+                matching.push_back(&bucket);
+            }
+        }
+
+        if (!matching.empty()) {
+            for (std::size_t i = 0; i < layer.featureCount(); i++) {
+                const auto& feature = layer.getFeature(i);
+
+                if (state == TileData::State::obsolete)
+                    return;
+
+                GeometryTileFeatureExtractor extractor(feature);
+                bool decoded = false;
+
+                for (std::size_t j = 0; j < matching.size(); j++) {
+                    if (!evaluate(filters[j], extractor))
+                        continue;
+
+                    // Decode the geometry once and share it between all buckets of this layer.
+                    if (!decoded) {
+                        feature.readGeometries(geometries);
+                        decoded = true;
+                    }
+
+                    matching[j]->addGeometry(geometries);
+                }
+            }
+        }
+
+        for (auto& bucket : buckets) {
+            storeBucket(bucket);
+            insertBucket(bucket.styleBucket.name, std::move(bucket.bucket));
+        }
+    }
+}
+
+void TileWorker::createFillBucket(const util::ptr<GeometryTileLayer>& layer,
                                   const StyleBucket& styleBucket) {
     auto bucket = std::make_unique<FillBucket>();
 
     // Fill does not have layout properties to apply.
 
-    addBucketGeometries(bucket, layer, styleBucket.filter);
-
-    insertBucket(styleBucket.name, std::move(bucket));
+    addBucketGeometries(std::move(bucket), layer, styleBucket);
 }
 
-void TileWorker::createLineBucket(const GeometryTileLayer& layer,
+void TileWorker::createLineBucket(const util::ptr<GeometryTileLayer>& layer,
                                   const StyleBucket& styleBucket) {
     auto bucket = std::make_unique<LineBucket>();
 
@@ -202,20 +352,16 @@ void TileWorker::createLineBucket(const GeometryTileLayer& layer,
     applyLayoutProperty(PropertyKey::LineMiterLimit, styleBucket.layout, layout.miter_limit, z);
     applyLayoutProperty(PropertyKey::LineRoundLimit, styleBucket.layout, layout.round_limit, z);
 
-    addBucketGeometries(bucket, layer, styleBucket.filter);
-
-    insertBucket(styleBucket.name, std::move(bucket));
+    addBucketGeometries(std::move(bucket), layer, styleBucket);
 }
 
-void TileWorker::createCircleBucket(const GeometryTileLayer& layer,
+void TileWorker::createCircleBucket(const util::ptr<GeometryTileLayer>& layer,
                                     const StyleBucket& styleBucket) {
     auto bucket = std::make_unique<CircleBucket>();
 
     // Circle does not have layout properties to apply.
 
-    addBucketGeometries(bucket, layer, styleBucket.filter);
-
-    insertBucket(styleBucket.name, std::move(bucket));
+    addBucketGeometries(std::move(bucket), layer, styleBucket);
 }
 
 void TileWorker::createSymbolBucket(const GeometryTileLayer& layer,
@@ -279,8 +425,11 @@ void TileWorker::createSymbolBucket(const GeometryTileLayer& layer,
         assert(style.glyphAtlas);
         assert(style.glyphStore);
         assert(collisionTile);
+        assert(style.shapingCache);
         bucket->addFeatures(reinterpret_cast<uintptr_t>(this), *style.spriteAtlas,
-                            *style.glyphAtlas, *style.glyphStore, *collisionTile);
+                            *style.glyphAtlas, *style.glyphStore, *style.shapingCache,
+                            *collisionTile);
+        shapingStatistics += bucket->getShapingStatistics();
         insertBucket(styleBucket.name, std::move(bucket));
     }
 }
@@ -4,27 +4,30 @@
 #include <mapbox/variant.hpp>
 
 #include <mbgl/map/tile_data.hpp>
+#include <mbgl/map/bucket_cache.hpp>
+#include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/ptr.hpp>
 #include <mbgl/style/filter_expression.hpp>
 #include <mbgl/style/style_calculation_parameters.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 
 #include <string>
 #include <memory>
 #include <mutex>
 #include <list>
+#include <map>
+#include <functional>
 #include <unordered_map>
 
 namespace mbgl {
 
 class CollisionTile;
-class GeometryTile;
 class Style;
 class Bucket;
 class StyleLayer;
 class StyleBucket;
-class GeometryTileLayer;
 
 // We're using this class to shuttle the resulting buckets from the worker thread to the MapContext
 // thread. This class is movable-only because the vector contains movable-only value elements.
@@ -46,7 +49,10 @@ public:
                const std::atomic<TileData::State>&);
     ~TileWorker();
 
-    TileParseResult parseAllLayers(const GeometryTile&, PlacementConfig);
+    // Fill, line and circle buckets are restored from the style's BucketCache instead of being
+    // parsed when the tile was parsed before. The cache key identifies the tile data, e.g. by its
+    // URL and ETag; tiles without a key aren't cached.
+    TileParseResult parseAllLayers(const GeometryTile&, PlacementConfig, const std::string& cacheKey = "");
     TileParseResult parsePendingLayers();
     void redoPlacement(const std::unordered_map<std::string, std::unique_ptr<Bucket>>*,
                        PlacementConfig);
@@ -56,15 +62,22 @@ public:
 private:
     void parseLayer(const StyleLayer&, const GeometryTile&);
 
-    void createFillBucket(const GeometryTileLayer&, const StyleBucket&);
-    void createLineBucket(const GeometryTileLayer&, const StyleBucket&);
-    void createCircleBucket(const GeometryTileLayer&, const StyleBucket&);
+    void createFillBucket(const util::ptr<GeometryTileLayer>&, const StyleBucket&);
+    void createLineBucket(const util::ptr<GeometryTileLayer>&, const StyleBucket&);
+    void createCircleBucket(const util::ptr<GeometryTileLayer>&, const StyleBucket&);
     void createSymbolBucket(const GeometryTileLayer&, const StyleBucket&);
 
     void insertBucket(const std::string& name, std::unique_ptr<Bucket>);
 
+    // Logs how many labels of the last parse were shaped and how many came from the cache.
+    void reportShapingStatistics() const;
+
+    template <class Bucket>
+    void addBucketGeometries(std::unique_ptr<Bucket>, const util::ptr<GeometryTileLayer>&, const StyleBucket&);
+    void parseGeometryBuckets();
+
     template <class Bucket>
-    void addBucketGeometries(Bucket&, const GeometryTileLayer&, const FilterExpression&);
+    bool restoreBucket(Bucket&, const StyleBucket&);
 
     const TileID id;
     const std::string sourceID;
@@ -75,10 +88,44 @@ private:
 
     std::unique_ptr<CollisionTile> collisionTile;
 
+    // Shaping cache lookups of the symbol buckets added by the current parse.
+    ShapingCache::Statistics shapingStatistics;
+
     // Contains buckets that we couldn't parse so far due to missing resources.
     // They will be attempted on subsequent parses.
     std::list<std::pair<const StyleBucket&, std::unique_ptr<Bucket>>> pending;
 
+    // Fill, line and circle buckets that are waiting to receive their geometries, grouped by
+    // source layer. All buckets of a source layer are filled in a single pass over its features.
+    struct GeometryBucket {
+        const StyleBucket& styleBucket;
+        std::unique_ptr<Bucket> bucket;
+        std::function<void (const GeometryCollection&)> addGeometry;
+        std::function<void (BucketCache::Writer&)> serialize;
+    };
+
+    void storeBucket(const GeometryBucket&);
+
+    struct GeometryBucketGroup {
+        util::ptr<GeometryTileLayer> layer;
+        std::vector<GeometryBucket> buckets;
+    };
+
+    std::map<std::string, GeometryBucketGroup> geometryBuckets;
+
+    // Null when the style doesn't have a bucket cache.
+    const std::shared_ptr<BucketCache> bucketCache;
+
+    // Identifies the tile that is currently being parsed in the bucket cache; empty when the
+    // buckets of this parse aren't cached.
+    std::string tileKey;
+
+    // Buckets of the current tile that were found in the cache, and those that will be stored
+    // once the tile is parsed.
+    BucketCache::Buckets cachedBuckets;
+    BucketCache::Buckets storedBuckets;
+    bool storedBucketsChanged = false;
+
     // Temporary holder
     TileParseResultBuckets result;
 };
@@ -238,6 +238,8 @@ void Transform::_easeTo(CameraOptions options, const double new_scale, const dou
     if (!options.duration || *options.duration == Duration::zero()) {
         view.notifyMapChange(MapChangeRegionWillChange);
 
+        prefetchStates.clear();
+
         state.scale = scale;
         state.x = x;
         state.y = y;
@@ -261,20 +263,31 @@ void Transform::_easeTo(CameraOptions options, const double new_scale, const dou
         state.scaling = true;
         state.rotating = true;
 
+        const auto interpolateState = [=](TransformState& current, double t) {
+            current.scale = util::interpolate(startS, scale, t);
+            current.x = util::interpolate(startX, x, t);
+            current.y = util::interpolate(startY, y, t);
+            const double s = current.scale * util::tileSize;
+            current.Bc = s / 360;
+            current.Cc = s / util::M2PI;
+            current.angle = util::wrap(util::interpolate(startA, angle, t), -M_PI, M_PI);
+            current.pitch = util::interpolate(startP, pitch, t);
+        };
+
+        // The destination is where the camera stays, so it is the most useful to prefetch.
+        prefetchStates.clear();
+        for (const double t : { 1.0, 0.5 }) {
+            prefetchStates.push_back(state);
+            interpolateState(prefetchStates.back(), t);
+        }
+
         startTransition(
             [=](double t) {
                 util::UnitBezier ease = options.easing ? *options.easing : util::UnitBezier(0, 0, 0.25, 1);
                 return ease.solve(t, 0.001);
             },
             [=](double t) {
-                state.scale = util::interpolate(startS, scale, t);
-                state.x = util::interpolate(startX, x, t);
-                state.y = util::interpolate(startY, y, t);
-                const double s = state.scale * util::tileSize;
-                state.Bc = s / 360;
-                state.Cc = s / util::M2PI;
-                state.angle = util::wrap(util::interpolate(startA, angle, t), -M_PI, M_PI);
-                state.pitch = util::interpolate(startP, pitch, t);
+                interpolateState(state, t);
                 view.notifyMapChange(MapChangeRegionIsChanging);
                 return update;
             },
@@ -402,6 +415,12 @@ void Transform::startTransition(std::function<double(double)> easing,
     transitionFinishFn = finish;
 }
 
+std::vector<TransformState> Transform::takePrefetchStates() {
+    std::vector<TransformState> states;
+    states.swap(prefetchStates);
+    return states;
+}
+
 bool Transform::inTransition() const {
     return transitionFrameFn != nullptr;
 }
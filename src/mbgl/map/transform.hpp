@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -55,6 +56,11 @@ public:
     Update updateTransitions(const TimePoint& now);
     void cancelTransitions();
 
+    // States that the most recently started transition passes through, starting with its
+    // destination, so that tiles can be loaded before the camera gets there. They are only
+    // returned once per transition.
+    std::vector<TransformState> takePrefetchStates();
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -86,6 +92,8 @@ private:
     Duration transitionDuration;
     std::function<Update(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+
+    std::vector<TransformState> prefetchStates;
 };
 
 }
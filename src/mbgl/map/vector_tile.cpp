@@ -52,25 +52,13 @@ mapbox::util::optional<Value> VectorTileFeature::getValue(const std::string& key
         return mapbox::util::optional<Value>();
     }
 
-    pbf tags = tags_pbf;
-    while (tags) {
-        uint32_t tag_key = tags.varint();
-
-        if (layer.keys.size() <= tag_key) {
-            throw std::runtime_error("feature referenced out of range key");
-        }
-
-        if (!tags) {
-            throw std::runtime_error("uneven number of feature tag ids");
-        }
-
-        uint32_t tag_val = tags.varint();
-        if (layer.values.size() <= tag_val) {
-            throw std::runtime_error("feature referenced out of range value");
-        }
+    return getValue(keyIter->second);
+}
 
-        if (tag_key == keyIter->second) {
-            return layer.values[tag_val];
+mapbox::util::optional<Value> VectorTileFeature::getValue(uint32_t keyIndex) const {
+    for (std::size_t i = tags_begin; i < tags_end; i += 2) {
+        if (layer.tags[i] == keyIndex) {
+            return layer.getValue(layer.tags[i + 1]);
         }
     }
 
@@ -78,16 +66,31 @@ mapbox::util::optional<Value> VectorTileFeature::getValue(const std::string& key
 }
 
 GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryCollection lines;
+    readGeometries(lines);
+    return lines;
+}
+
+void VectorTileFeature::readGeometries(GeometryCollection& lines) const {
     pbf data(geometry_pbf);
     uint8_t cmd = 1;
     uint32_t length = 0;
     int32_t x = 0;
     int32_t y = 0;
 
-    GeometryCollection lines;
+    // Lines that are already present in the collection are cleared and reused so that their
+    // storage survives across features.
+    std::size_t count = 0;
+    auto nextLine = [&]() -> std::vector<Coordinate>* {
+        if (count == lines.size()) {
+            lines.emplace_back();
+        } else {
+            lines[count].clear();
+        }
+        return &lines[count++];
+    };
 
-    lines.emplace_back();
-    std::vector<Coordinate>* line = &lines.back();
+    std::vector<Coordinate>* line = nextLine();
 
     while (data.data < data.end) {
         if (length == 0) {
@@ -103,8 +106,7 @@ GeometryCollection VectorTileFeature::getGeometries() const {
             y += data.svarint();
 
             if (cmd == 1 && !line->empty()) { // moveTo
-                lines.emplace_back();
-                line = &lines.back();
+                line = nextLine();
             }
 
             line->emplace_back(x, y);
@@ -119,14 +121,19 @@ GeometryCollection VectorTileFeature::getGeometries() const {
         }
     }
 
-    return lines;
+    lines.resize(count);
 }
 
 VectorTile::VectorTile(pbf tile_pbf) {
     while (tile_pbf.next()) {
         if (tile_pbf.tag == 3) { // layer
-            util::ptr<VectorTileLayer> layer = std::make_shared<VectorTileLayer>(tile_pbf.message());
-            layers.emplace(layer->name, layer);
+            pbf layer_pbf = tile_pbf.message();
+
+            // Only look at the name of the layer for now; everything else is skipped over.
+            pbf name_pbf = layer_pbf;
+            if (name_pbf.next(1)) {
+                layer_pbfs.emplace(name_pbf.string(), layer_pbf);
+            }
         } else {
             tile_pbf.skip();
         }
@@ -138,29 +145,91 @@ util::ptr<GeometryTileLayer> VectorTile::getLayer(const std::string& name) const
     if (layer_it != layers.end()) {
         return layer_it->second;
     }
+
+    auto pbf_it = layer_pbfs.find(name);
+    if (pbf_it != layer_pbfs.end()) {
+        util::ptr<GeometryTileLayer> layer = std::make_shared<VectorTileLayer>(pbf_it->second);
+        layers.emplace(name, layer);
+        return layer;
+    }
+
     return nullptr;
 }
 
 VectorTileLayer::VectorTileLayer(pbf layer_pbf) {
+    // Count the features first so that the feature index is allocated exactly once.
+    std::size_t feature_count = 0;
+    pbf count_pbf = layer_pbf;
+    while (count_pbf.next(2)) {
+        ++feature_count;
+        count_pbf.skip();
+    }
+    features.reserve(feature_count);
+
     while (layer_pbf.next()) {
         if (layer_pbf.tag == 1) { // name
             name = layer_pbf.string();
         } else if (layer_pbf.tag == 2) { // feature
-            features.push_back(layer_pbf.message());
+            features.emplace_back(layer_pbf.message(), *this);
         } else if (layer_pbf.tag == 3) { // keys
             keys.emplace(layer_pbf.string(), keys.size());
         } else if (layer_pbf.tag == 4) { // values
-            values.emplace_back(std::move(parseValue(layer_pbf.message())));
+            values.push_back(layer_pbf.message());
         } else if (layer_pbf.tag == 5) { // extent
             extent = layer_pbf.varint();
         } else {
             layer_pbf.skip();
         }
     }
+
+    decodeTags();
+}
+
+void VectorTileLayer::decodeTags() {
+    // The key and value tables are complete at this point, so we can validate the indices once
+    // instead of on every lookup.
+    for (auto& feature : features) {
+        feature.tags_begin = tags.size();
+
+        pbf tags_pbf = feature.tags_pbf;
+        while (tags_pbf) {
+            uint32_t tag_key = tags_pbf.varint();
+
+            if (keys.size() <= tag_key) {
+                throw std::runtime_error("feature referenced out of range key");
+            }
+
+            if (!tags_pbf) {
+                throw std::runtime_error("uneven number of feature tag ids");
+            }
+
+            uint32_t tag_val = tags_pbf.varint();
+            if (values.size() <= tag_val) {
+                throw std::runtime_error("feature referenced out of range value");
+            }
+
+            tags.push_back(tag_key);
+            tags.push_back(tag_val);
+        }
+
+        feature.tags_end = tags.size();
+    }
+}
+
+const GeometryTileFeature& VectorTileLayer::getFeature(std::size_t i) const {
+    return features.at(i);
+}
+
+mapbox::util::optional<uint32_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    auto it = keys.find(key);
+    if (it == keys.end()) {
+        return mapbox::util::optional<uint32_t>();
+    }
+    return it->second;
 }
 
-util::ptr<const GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_shared<VectorTileFeature>(features.at(i), *this);
+Value VectorTileLayer::getValue(uint32_t index) const {
+    return parseValue(values[index]);
 }
 
 }
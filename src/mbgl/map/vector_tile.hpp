@@ -10,20 +10,31 @@ namespace mbgl {
 
 class VectorTileLayer;
 
+// A lightweight view onto a feature message. It only records where the geometry is located in
+// the underlying buffer and decodes it on demand. The tags of all features are decoded once into
+// a flat array owned by the layer.
 class VectorTileFeature : public GeometryTileFeature {
 public:
     VectorTileFeature(pbf, const VectorTileLayer&);
 
     FeatureType getType() const override { return type; }
     mapbox::util::optional<Value> getValue(const std::string&) const override;
+    mapbox::util::optional<Value> getValue(uint32_t keyIndex) const override;
     GeometryCollection getGeometries() const override;
+    void readGeometries(GeometryCollection&) const override;
 
 private:
+    friend class VectorTileLayer;
+
     const VectorTileLayer& layer;
     uint64_t id = 0;
     FeatureType type = FeatureType::Unknown;
     pbf tags_pbf;
     pbf geometry_pbf;
+
+    // Range of this feature's key/value index pairs in VectorTileLayer::tags.
+    std::size_t tags_begin = 0;
+    std::size_t tags_end = 0;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
@@ -31,17 +42,28 @@ public:
     VectorTileLayer(pbf);
 
     std::size_t featureCount() const override { return features.size(); }
-    util::ptr<const GeometryTileFeature> getFeature(std::size_t) const override;
+    const GeometryTileFeature& getFeature(std::size_t) const override;
+
+    bool hasKeyTable() const override { return true; }
+    mapbox::util::optional<uint32_t> getKeyIndex(const std::string&) const override;
 
 private:
     friend class VectorTile;
     friend class VectorTileFeature;
 
+    void decodeTags();
+    Value getValue(uint32_t index) const;
+
     std::string name;
     uint32_t extent = 4096;
     std::map<std::string, uint32_t> keys;
-    std::vector<Value> values;
-    std::vector<pbf> features;
+
+    // Values are kept in their encoded form and only decoded when a feature references them.
+    std::vector<pbf> values;
+    std::vector<VectorTileFeature> features;
+
+    // Alternating key and value indices of all features.
+    std::vector<uint32_t> tags;
 };
 
 class VectorTile : public GeometryTile {
@@ -51,7 +73,10 @@ public:
     util::ptr<GeometryTileLayer> getLayer(const std::string&) const override;
 
 private:
-    std::map<std::string, util::ptr<GeometryTileLayer>> layers;
+    // Layers are only indexed by name here; they're parsed the first time they are requested,
+    // so that layers which aren't used by any style bucket are never decoded.
+    std::map<std::string, pbf> layer_pbfs;
+    mutable std::map<std::string, util::ptr<GeometryTileLayer>> layers;
 };
 
 }
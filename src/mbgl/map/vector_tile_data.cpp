@@ -6,10 +6,13 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
 #include <mbgl/util/worker.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/style/style.hpp>
 
+#include <sstream>
+
 using namespace mbgl;
 
 VectorTileData::VectorTileData(const TileID& id_,
@@ -64,6 +67,10 @@ void VectorTileData::request(float pixelRatio, const std::function<void()>& call
         }
         data = res.data;
 
+        // Without an ETag, we'd have to compare the data itself to know whether the tile
+        // is still the same as the one whose buckets were cached.
+        cacheKey = res.etag.empty() ? "" : url + '\n' + res.etag;
+
         parse(callback);
     });
 }
@@ -73,8 +80,10 @@ void VectorTileData::parse(std::function<void ()> callback) {
     // when tile data changed. Replacing the workdRequest will cancel a pending work
     // request in case there is one.
     workRequest.reset();
-    workRequest = worker.parseVectorTile(tileWorker, data, targetConfig, [this, callback, config = targetConfig] (TileParseResult result) {
+    const auto priority = prefetching ? Worker::Priority::Low : Worker::Priority::Regular;
+    workRequest = worker.parseVectorTile(tileWorker, data, cacheKey, targetConfig, [this, callback, config = targetConfig, started = Clock::now()] (TileParseResult result) {
         workRequest.reset();
+        parseTime += Clock::now() - started;
         if (state == State::obsolete) {
             return;
         }
@@ -106,7 +115,7 @@ void VectorTileData::parse(std::function<void ()> callback) {
         }
 
         callback();
-    });
+    }, priority);
 }
 
 bool VectorTileData::parsePending(std::function<void()> callback) {
@@ -164,6 +173,15 @@ Bucket* VectorTileData::getBucket(const StyleLayer& layer) {
     return it->second.get();
 }
 
+std::size_t VectorTileData::memoryUsage() const {
+    // The raw tile data is retained so that the tile can be reparsed.
+    std::size_t bytes = data ? data->size() : 0;
+    for (const auto& bucket : buckets) {
+        bytes += bucket.second->memoryUsage();
+    }
+    return bytes;
+}
+
 void VectorTileData::redoPlacement(const PlacementConfig newConfig) {
     if (newConfig != placedConfig) {
         targetConfig = newConfig;
@@ -197,6 +215,16 @@ void VectorTileData::redoPlacement() {
     });
 }
 
+void VectorTileData::setPriority(double rank, bool prefetch) {
+    req.setPriority(rank, prefetch);
+    if (prefetching && !prefetch) {
+        // The tile is needed now; don't let it wait behind other tiles that are parsed ahead of
+        // time. Placement requests already run at a higher priority.
+        worker.raisePriority(workRequest, Worker::Priority::Regular);
+    }
+    prefetching = prefetch;
+}
+
 void VectorTileData::cancel() {
     if (state != State::obsolete) {
         state = State::obsolete;
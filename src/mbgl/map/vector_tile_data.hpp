@@ -22,6 +22,7 @@ public:
     ~VectorTileData();
 
     Bucket* getBucket(const StyleLayer&) override;
+    std::size_t memoryUsage() const override;
 
     void request(float pixelRatio, const std::function<void()>& callback);
 
@@ -32,6 +33,7 @@ public:
     void redoPlacement();
 
     void cancel() override;
+    void setPriority(double rank, bool prefetch = false) override;
 
 private:
     Worker& worker;
@@ -46,6 +48,9 @@ private:
     RequestHolder req;
     std::shared_ptr<const std::string> data;
 
+    // Identifies the data in the bucket cache.
+    std::string cacheKey;
+
     // Stores the placement configuration of the text that is currently placed on the screen.
     PlacementConfig placedConfig;
 
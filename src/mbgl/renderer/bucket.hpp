@@ -7,6 +7,7 @@
 #include <mbgl/util/mat4.hpp>
 
 #include <atomic>
+#include <cstddef>
 
 #define BUFFER_OFFSET_0  ((GLbyte*)nullptr)
 #define BUFFER_OFFSET(i) ((BUFFER_OFFSET_0) + (i))
@@ -34,6 +35,10 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Returns the approximate number of bytes of vertex, element and texture data held by this
+    // bucket, either in main memory or on the GPU.
+    virtual std::size_t memoryUsage() const = 0;
+
     inline bool needsUpload() const {
         return !uploaded;
     }
@@ -30,6 +30,22 @@ bool CircleBucket::hasData() const {
     return !triangleGroups_.empty();
 }
 
+std::size_t CircleBucket::memoryUsage() const {
+    return vertexBuffer_.byteSize() + elementsBuffer_.byteSize();
+}
+
+void CircleBucket::serialize(BucketCache::Writer& writer) const {
+    writer.writeBuffer(vertexBuffer_);
+    writer.writeBuffer(elementsBuffer_);
+    writer.writeGroups(triangleGroups_);
+}
+
+void CircleBucket::deserialize(BucketCache::Reader& reader) {
+    reader.readBuffer(vertexBuffer_);
+    reader.readBuffer(elementsBuffer_);
+    reader.readGroups(triangleGroups_, vertexBuffer_, elementsBuffer_);
+}
+
 void CircleBucket::addGeometry(const GeometryCollection& geometryCollection) {
     const int extent = 4096;
     for (auto& circle : geometryCollection) {
@@ -2,6 +2,7 @@
 #define MBGL_RENDERER_CIRCLE_BUCKET
 
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/map/bucket_cache.hpp>
 
 #include <mbgl/map/geometry_tile.hpp>
 
@@ -27,8 +28,13 @@ public:
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
 
     bool hasData() const override;
+    std::size_t memoryUsage() const override;
     void addGeometry(const GeometryCollection&);
 
+    // Used by the BucketCache to store the parsed buffers, and to restore them instead of parsing.
+    void serialize(BucketCache::Writer&) const;
+    void deserialize(BucketCache::Reader&);
+
     void drawCircles(CircleShader& shader);
 
 private:
@@ -208,6 +208,26 @@ bool FillBucket::hasData() const {
     return !triangleGroups.empty() || !lineGroups.empty();
 }
 
+std::size_t FillBucket::memoryUsage() const {
+    return vertexBuffer.byteSize() + triangleElementsBuffer.byteSize() + lineElementsBuffer.byteSize();
+}
+
+void FillBucket::serialize(BucketCache::Writer& writer) const {
+    writer.writeBuffer(vertexBuffer);
+    writer.writeBuffer(triangleElementsBuffer);
+    writer.writeBuffer(lineElementsBuffer);
+    writer.writeGroups(triangleGroups);
+    writer.writeGroups(lineGroups);
+}
+
+void FillBucket::deserialize(BucketCache::Reader& reader) {
+    reader.readBuffer(vertexBuffer);
+    reader.readBuffer(triangleElementsBuffer);
+    reader.readBuffer(lineElementsBuffer);
+    reader.readGroups(triangleGroups, vertexBuffer, triangleElementsBuffer);
+    reader.readGroups(lineGroups, vertexBuffer, lineElementsBuffer);
+}
+
 void FillBucket::drawElements(PlainShader& shader) {
     GLbyte* vertex_index = BUFFER_OFFSET(0);
     GLbyte* elements_index = BUFFER_OFFSET(0);
@@ -2,6 +2,7 @@
 #define MBGL_RENDERER_FILLBUCKET
 
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/map/bucket_cache.hpp>
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/geometry/elements_buffer.hpp>
 #include <mbgl/geometry/fill_buffer.hpp>
@@ -35,10 +36,15 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t memoryUsage() const override;
 
     void addGeometry(const GeometryCollection&);
     void tessellate();
 
+    // Used by the BucketCache to store the parsed buffers, and to restore them instead of parsing.
+    void serialize(BucketCache::Writer&) const;
+    void deserialize(BucketCache::Reader&);
+
     void drawElements(PlainShader& shader);
     void drawElements(PatternShader& shader);
     void drawVertices(OutlineShader& shader);
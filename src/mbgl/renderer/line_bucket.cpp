@@ -398,6 +398,22 @@ bool LineBucket::hasData() const {
     return !triangleGroups.empty();
 }
 
+std::size_t LineBucket::memoryUsage() const {
+    return vertexBuffer.byteSize() + triangleElementsBuffer.byteSize();
+}
+
+void LineBucket::serialize(BucketCache::Writer& writer) const {
+    writer.writeBuffer(vertexBuffer);
+    writer.writeBuffer(triangleElementsBuffer);
+    writer.writeGroups(triangleGroups);
+}
+
+void LineBucket::deserialize(BucketCache::Reader& reader) {
+    reader.readBuffer(vertexBuffer);
+    reader.readBuffer(triangleElementsBuffer);
+    reader.readGroups(triangleGroups, vertexBuffer, triangleElementsBuffer);
+}
+
 void LineBucket::drawLines(LineShader& shader) {
     GLbyte* vertex_index = BUFFER_OFFSET(0);
     GLbyte* elements_index = BUFFER_OFFSET(0);
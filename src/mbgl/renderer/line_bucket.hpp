@@ -2,6 +2,7 @@
 #define MBGL_RENDERER_LINEBUCKET
 
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/map/bucket_cache.hpp>
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/geometry/vao.hpp>
 #include <mbgl/geometry/elements_buffer.hpp>
@@ -31,10 +32,15 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t memoryUsage() const override;
 
     void addGeometry(const GeometryCollection&);
     void addGeometry(const std::vector<Coordinate>& line);
 
+    // Used by the BucketCache to store the parsed buffers, and to restore them instead of parsing.
+    void serialize(BucketCache::Writer&) const;
+    void deserialize(BucketCache::Reader&);
+
     void drawLines(LineShader& shader);
     void drawLineSDF(LineSDFShader& shader);
     void drawLinePatterns(LinepatternShader& shader);
@@ -44,6 +44,10 @@
 
 using namespace mbgl;
 
+// Bytes that each atlas may upload per frame while continuously rendering, so that a burst of new
+// glyphs or icons is spread over several frames instead of stalling one.
+const std::size_t atlasUploadBudget = 256 * 1024;
+
 Painter::Painter(MapData& data_) : data(data_) {
     setup();
 }
@@ -52,7 +56,7 @@ Painter::~Painter() {
 }
 
 bool Painter::needsAnimation() const {
-    return frameHistory.needsAnimation(data.getDefaultFadeDuration());
+    return atlasUploadsPending || frameHistory.needsAnimation(data.getDefaultFadeDuration());
 }
 
 void Painter::setup() {
@@ -175,9 +179,12 @@ void Painter::render(const Style& style, TransformState state_, const FrameData&
 
         tileStencilBuffer.upload();
         tileBorderBuffer.upload();
-        spriteAtlas->upload();
-        lineAtlas->upload();
-        glyphAtlas->upload();
+        // Still images have to be complete after a single frame.
+        const std::size_t budget = data.mode == MapMode::Continuous ? atlasUploadBudget : 0;
+        spriteAtlas->upload(budget);
+        lineAtlas->upload(budget);
+        glyphAtlas->upload(budget);
+        atlasUploadsPending = spriteAtlas->isDirty() || lineAtlas->isDirty() || glyphAtlas->isDirty();
 
         for (const auto& item : order) {
             if (item.bucket && item.bucket->needsUpload()) {
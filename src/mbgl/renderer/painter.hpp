@@ -20,6 +20,7 @@
 #include <mbgl/util/chrono.hpp>
 
 #include <array>
+#include <functional>
 #include <vector>
 #include <set>
 
@@ -149,15 +150,14 @@ private:
     void prepareTile(const Tile& tile);
 
     template <typename BucketProperties, typename StyleProperties>
-    void renderSDF(SymbolBucket &bucket,
-                   const TileID &id,
+    void renderSDF(const TileID &id,
                    const mat4 &matrixSymbol,
                    const BucketProperties& bucketProperties,
                    const StyleProperties& styleProperties,
                    float scaleDivisor,
                    std::array<float, 2> texsize,
                    SDFShader& sdfShader,
-                   void (SymbolBucket::*drawSDF)(SDFShader&));
+                   std::function<void(SDFShader&)> drawSDF);
 
     void setDepthSublayer(int n);
 
@@ -212,6 +212,9 @@ public:
     GlyphAtlas* glyphAtlas;
     LineAtlas* lineAtlas;
 
+    // Set when an atlas didn't finish uploading within its budget and needs another frame.
+    bool atlasUploadsPending = false;
+
     std::unique_ptr<PlainShader> plainShader;
     std::unique_ptr<OutlineShader> outlineShader;
     std::unique_ptr<LineShader> lineShader;
@@ -15,15 +15,14 @@
 using namespace mbgl;
 
 template <typename BucketProperties, typename StyleProperties>
-void Painter::renderSDF(SymbolBucket &bucket,
-                        const TileID &id,
+void Painter::renderSDF(const TileID &id,
                         const mat4 &matrix,
                         const BucketProperties& bucketProperties,
                         const StyleProperties& styleProperties,
                         float sdfFontSize,
                         std::array<float, 2> texsize,
                         SDFShader& sdfShader,
-                        void (SymbolBucket::*drawSDF)(SDFShader&))
+                        std::function<void(SDFShader&)> drawSDF)
 {
     mat4 vtxMatrix = translatedMatrix(matrix, styleProperties.translate, id, styleProperties.translate_anchor);
 
@@ -100,7 +99,7 @@ void Painter::renderSDF(SymbolBucket &bucket,
         sdfShader.u_buffer = (haloOffset - styleProperties.halo_width / fontScale) / sdfPx;
 
         setDepthSublayer(0);
-        (bucket.*drawSDF)(sdfShader);
+        drawSDF(sdfShader);
     }
 
     // Then, we draw the text/icon over the halo
@@ -121,7 +120,7 @@ void Painter::renderSDF(SymbolBucket &bucket,
         sdfShader.u_buffer = (256.0f - 64.0f) / 256.0f;
 
         setDepthSublayer(1);
-        (bucket.*drawSDF)(sdfShader);
+        drawSDF(sdfShader);
     }
 }
 
@@ -179,15 +178,14 @@ void Painter::renderSymbol(SymbolBucket& bucket, const SymbolLayer& layer, const
                 || angleOffset != 0 || fontScale != 1 || sdf || state.getPitch() != 0);
 
         if (sdf) {
-            renderSDF(bucket,
-                      id,
+            renderSDF(id,
                       matrix,
                       layout.icon,
                       properties.icon,
                       1.0f,
                       {{ float(spriteAtlas->getWidth()) / 4.0f, float(spriteAtlas->getHeight()) / 4.0f }},
                       *sdfIconShader,
-                      &SymbolBucket::drawIcons);
+                      [&] (SDFShader& shader) { bucket.drawIcons(shader); });
         } else {
             mat4 vtxMatrix = translatedMatrix(matrix, properties.icon.translate, id, properties.icon.translate_anchor);
 
@@ -237,17 +235,14 @@ void Painter::renderSymbol(SymbolBucket& bucket, const SymbolLayer& layer, const
     if (bucket.hasTextData()) {
         config.depthTest = layout.text.rotation_alignment == RotationAlignmentType::Map;
 
-        glyphAtlas->bind();
-
-        renderSDF(bucket,
-                  id,
+        renderSDF(id,
                   matrix,
                   layout.text,
                   properties.text,
                   24.0f,
                   {{ float(glyphAtlas->width) / 4, float(glyphAtlas->height) / 4 }},
                   *sdfGlyphShader,
-                  &SymbolBucket::drawGlyphs);
+                  [&] (SDFShader& shader) { bucket.drawGlyphs(shader, *glyphAtlas); });
     }
 
 }
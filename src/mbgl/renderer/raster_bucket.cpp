@@ -38,3 +38,8 @@ void RasterBucket::drawRaster(RasterShader& shader, StaticVertexBuffer &vertices
 bool RasterBucket::hasData() const {
     return raster.isLoaded();
 }
+
+std::size_t RasterBucket::memoryUsage() const {
+    // Rasters are stored as RGBA textures.
+    return raster.isLoaded() ? std::size_t(raster.width) * std::size_t(raster.height) * 4 : 0;
+}
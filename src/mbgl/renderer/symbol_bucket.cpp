@@ -28,6 +28,13 @@
 
 namespace mbgl {
 
+namespace {
+
+// Used for features without a label.
+const Shaping noShaping;
+
+} // namespace
+
 SymbolInstance::SymbolInstance(Anchor& anchor, const std::vector<Coordinate>& line,
         const Shaping& shapedText, const PositionedIcon& shapedIcon,
         const SymbolLayoutProperties& layout, const bool addToBuffers,
@@ -90,8 +97,19 @@ bool SymbolBucket::hasIconData() const { return renderData && !renderData->icon.
 
 bool SymbolBucket::hasCollisionBoxData() const { return renderData && !renderData->collisionBox.groups.empty(); }
 
+std::size_t SymbolBucket::memoryUsage() const {
+    // Data that is still being placed on a worker thread isn't accounted for.
+    if (!renderData) {
+        return 0;
+    }
+
+    return renderData->text.vertices.byteSize() + renderData->text.triangles.byteSize() +
+           renderData->icon.vertices.byteSize() + renderData->icon.triangles.byteSize() +
+           renderData->collisionBox.vertices.byteSize();
+}
+
 void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
-                                 const FilterExpression& filter) {
+                                 const FilterExpression& filter_) {
     const bool has_text = !layout.text.field.empty() && !layout.text.font.empty();
     const bool has_icon = !layout.icon.image.empty();
 
@@ -99,19 +117,24 @@ void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
         return;
     }
 
+    const FilterExpression filter = compileFilterExpression(filter_, layer);
+    if (isFalseFilter(filter)) {
+        return;
+    }
+
     // Determine and load glyph ranges
     const GLsizei featureCount = static_cast<GLsizei>(layer.featureCount());
     for (GLsizei i = 0; i < featureCount; i++) {
-        auto feature = layer.getFeature(i);
+        const auto& feature = layer.getFeature(i);
 
-        GeometryTileFeatureExtractor extractor(*feature);
+        GeometryTileFeatureExtractor extractor(feature);
         if (!evaluate(filter, extractor))
             continue;
 
         SymbolFeature ft;
 
         auto getValue = [&feature](const std::string& key) -> std::string {
-            auto value = feature->getValue(key);
+            auto value = feature.getValue(key);
             return value ? toString(*value) : std::string();
         };
 
@@ -142,7 +165,7 @@ void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
 
             auto &multiline = ft.geometry;
 
-            GeometryCollection geometryCollection = feature->getGeometries();
+            GeometryCollection geometryCollection = feature.getGeometries();
             for (auto& line : geometryCollection) {
                 multiline.emplace_back();
                 for (auto& point : line) {
@@ -176,6 +199,7 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
                                SpriteAtlas& spriteAtlas,
                                GlyphAtlas& glyphAtlas,
                                GlyphStore& glyphStore,
+                               ShapingCache& shapingCache,
                                CollisionTile& collisionTile) {
     float horizontalAlign = 0.5;
     float verticalAlign = 0.5;
@@ -218,19 +242,20 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
         layout.text.justify == TextJustifyType::Left ? 0 :
         0.5;
 
-    auto fontStack = glyphStore.getFontStack(layout.text.font);
+    const FontStack& fontStack = glyphStore.getFontStack(layout.text.font);
 
     for (const auto& feature : features) {
         if (feature.geometry.empty()) continue;
 
-        Shaping shapedText;
+        std::shared_ptr<const Shaping> shapedText;
         PositionedIcon shapedIcon;
         GlyphPositions face;
 
         // if feature has text, shape the text
         if (feature.label.length()) {
-            shapedText = fontStack->getShaping(
-                /* string */ feature.label,
+            shapedText = shapingCache.get({
+                /* fontStack */ layout.text.font,
+                /* text */ feature.label,
                 /* maxWidth: ems */ layout.placement != PlacementType::Line ?
                     layout.text.max_width * 24 : 0,
                 /* lineHeight: ems */ layout.text.line_height * 24,
@@ -238,11 +263,12 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
                 /* verticalAlign */ verticalAlign,
                 /* justify */ justify,
                 /* spacing: ems */ layout.text.letter_spacing * 24,
-                /* translate */ vec2<float>(layout.text.offset[0], layout.text.offset[1]));
+                /* translate */ vec2<float>(layout.text.offset[0], layout.text.offset[1])
+            }, fontStack, &shapingStatistics);
 
             // Add the glyphs we need for this label to the glyph atlas.
-            if (shapedText) {
-                glyphAtlas.addGlyphs(tileUID, feature.label, layout.text.font, **fontStack, face);
+            if (*shapedText) {
+                glyphAtlas.addGlyphs(tileUID, feature.label, layout.text.font, fontStack, face);
             }
         }
 
@@ -259,8 +285,8 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
         }
 
         // if either shapedText or icon position is present, add the feature
-        if (shapedText || shapedIcon) {
-            addFeature(feature.geometry, shapedText, shapedIcon, face);
+        if ((shapedText && *shapedText) || shapedIcon) {
+            addFeature(feature.geometry, shapedText ? *shapedText : noShaping, shapedIcon, face);
         }
     }
 
@@ -392,6 +418,11 @@ void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediat
         });
     }
 
+    // Text is added after all symbols were placed, page by page, so that the number of groups
+    // doesn't depend on how labels with glyphs on different pages are interleaved.
+    std::vector<std::pair<const SymbolInstance*, float>> placedText;
+    std::set<uint16_t> textPages;
+
     for (SymbolInstance &symbolInstance : symbolInstances) {
 
         const bool hasText = symbolInstance.hasText;
@@ -426,9 +457,10 @@ void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediat
                 collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale);
             }
             if (glyphScale < collisionTile.maxScale) {
-                addSymbols<SymbolRenderData::TextBuffer, TextElementGroup>(
-                    renderDataInProgress->text, symbolInstance.glyphQuads, glyphScale,
-                    layout.text.keep_upright, textAlongLine, collisionTile.config.angle);
+                placedText.emplace_back(&symbolInstance, glyphScale);
+                for (const auto& quad : symbolInstance.glyphQuads) {
+                    textPages.insert(quad.page);
+                }
             }
         }
 
@@ -444,6 +476,14 @@ void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediat
         }
     }
 
+    for (const uint16_t page : textPages) {
+        for (const auto& placed : placedText) {
+            addSymbols<SymbolRenderData::TextBuffer, TextElementGroup>(
+                renderDataInProgress->text, placed.first->glyphQuads, placed.second,
+                layout.text.keep_upright, textAlongLine, collisionTile.config.angle, page);
+        }
+    }
+
     if (collisionTile.config.debug) {
         addToDebugBuffers(collisionTile);
     }
@@ -452,11 +492,13 @@ void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediat
 }
 
 template <typename Buffer, typename GroupType>
-void SymbolBucket::addSymbols(Buffer &buffer, const SymbolQuads &symbols, float scale, const bool keepUpright, const bool alongLine, const float placementAngle) {
+void SymbolBucket::addSymbols(Buffer &buffer, const SymbolQuads &symbols, float scale, const bool keepUpright, const bool alongLine, const float placementAngle, uint16_t page) {
 
     const float placementZoom = ::fmax(std::log(scale) / std::log(2) + zoom, 0);
 
     for (const auto& symbol : symbols) {
+        if (symbol.page != page) continue;
+
         const auto &tl = symbol.tl;
         const auto &tr = symbol.tr;
         const auto &bl = symbol.bl;
@@ -484,9 +526,11 @@ void SymbolBucket::addSymbols(Buffer &buffer, const SymbolQuads &symbols, float
 
         const int glyph_vertex_length = 4;
 
-        if (buffer.groups.empty() || (buffer.groups.back()->vertex_length + glyph_vertex_length > 65535)) {
-            // Move to a new group because the old one can't hold the geometry.
+        if (buffer.groups.empty() || (buffer.groups.back()->vertex_length + glyph_vertex_length > 65535) ||
+            buffer.groups.back()->page != page) {
+            // Move to a new group because the old one can't hold the geometry or uses another page.
             buffer.groups.emplace_back(std::make_unique<GroupType>());
+            buffer.groups.back()->page = page;
         }
 
         // We're generating triangle fans, so we always start with the first
@@ -571,12 +615,13 @@ void SymbolBucket::swapRenderData() {
     }
 }
 
-void SymbolBucket::drawGlyphs(SDFShader &shader) {
+void SymbolBucket::drawGlyphs(SDFShader &shader, GlyphAtlas &glyphAtlas) {
     GLbyte *vertex_index = BUFFER_OFFSET_0;
     GLbyte *elements_index = BUFFER_OFFSET_0;
     auto& text = renderData->text;
     for (auto &group : text.groups) {
         assert(group);
+        glyphAtlas.bind(group->page);
         group->array[0].bind(shader, text.vertices, text.triangles, vertex_index);
         MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, group->elements_length * 3, GL_UNSIGNED_SHORT, elements_index));
         vertex_index += group->vertex_length * text.vertices.itemSize;
@@ -12,6 +12,7 @@
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/text/shaping.hpp>
 #include <mbgl/text/quads.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/style/style_bucket.hpp>
 #include <mbgl/style/style_properties.hpp>
 
@@ -60,8 +61,14 @@ class SymbolInstance {
 };
 
 class SymbolBucket : public Bucket {
-    typedef ElementGroup<1> TextElementGroup;
-    typedef ElementGroup<2> IconElementGroup;
+    // Every group draws from one glyph atlas page, because each page has its own texture.
+    template <GLsizei count>
+    struct SymbolElementGroup : public ElementGroup<count> {
+        uint16_t page = 0;
+    };
+
+    typedef SymbolElementGroup<1> TextElementGroup;
+    typedef SymbolElementGroup<2> IconElementGroup;
     typedef ElementGroup<1> CollisionBoxElementGroup;
 
 public:
@@ -71,6 +78,7 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t memoryUsage() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
@@ -79,9 +87,13 @@ public:
                      SpriteAtlas&,
                      GlyphAtlas&,
                      GlyphStore&,
+                     ShapingCache&,
                      CollisionTile&);
 
-    void drawGlyphs(SDFShader& shader);
+    // Shaping cache lookups of the labels in this bucket.
+    const ShapingCache::Statistics& getShapingStatistics() const { return shapingStatistics; }
+
+    void drawGlyphs(SDFShader& shader, GlyphAtlas&);
     void drawIcons(SDFShader& shader);
     void drawIcons(IconShader& shader);
     void drawCollisionBoxes(CollisionBoxShader& shader);
@@ -104,10 +116,11 @@ private:
     void placeFeatures(CollisionTile& collisionTile, bool swapImmediately);
     void swapRenderData() override;
 
-    // Adds placed items to the buffer.
+    // Adds placed items on the given glyph atlas page to the buffer.
     template <typename Buffer, typename GroupType>
     void addSymbols(Buffer &buffer, const SymbolQuads &symbols, float scale,
-            const bool keepUpright, const bool alongLine, const float placementAngle);
+            const bool keepUpright, const bool alongLine, const float placementAngle,
+            uint16_t page = 0);
 
 public:
     SymbolLayoutProperties layout;
@@ -124,6 +137,7 @@ private:
     std::set<GlyphRange> ranges;
     std::vector<SymbolInstance> symbolInstances;
     std::vector<SymbolFeature> features;
+    ShapingCache::Statistics shapingStatistics;
 
     struct SymbolRenderData {
         struct TextBuffer {
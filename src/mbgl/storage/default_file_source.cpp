@@ -2,6 +2,7 @@
 #include <mbgl/storage/request.hpp>
 #include <mbgl/storage/asset_context_base.hpp>
 #include <mbgl/storage/http_context_base.hpp>
+#include <mbgl/storage/mbtiles_context_base.hpp>
 
 #include <mbgl/storage/response.hpp>
 #include <mbgl/platform/platform.hpp>
@@ -22,12 +23,30 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 
 namespace algo = boost::algorithm;
 
 namespace mbgl {
 
+namespace {
+
+// Similar to the limits of web browsers, so that servers treat us the same way.
+const std::size_t maxActiveRequests = 20;
+const std::size_t maxActiveRequestsPerHost = 6;
+
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(SystemClock::now().time_since_epoch()).count();
+}
+
+// Everything else is read from local files, which doesn't need a connection.
+bool isNetworkRequest(const Resource& resource) {
+    return !algo::starts_with(resource.url, "asset://") && !algo::starts_with(resource.url, "mbtiles://");
+}
+
+} // namespace
+
 DefaultFileSource::DefaultFileSource(FileCache* cache, const std::string& root)
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"FileSource", util::ThreadType::Unknown, util::ThreadPriority::Low}, cache, root)) {
 }
@@ -45,29 +64,7 @@ Request* DefaultFileSource::request(const Resource& resource,
         throw util::MisuseException("FileSource callback can't be empty");
     }
 
-    std::string url;
-
-    switch (resource.kind) {
-    case Resource::Kind::Style:
-        url = mbgl::util::mapbox::normalizeStyleURL(resource.url, accessToken);
-        break;
-
-    case Resource::Kind::Source:
-        url = util::mapbox::normalizeSourceURL(resource.url, accessToken);
-        break;
-
-    case Resource::Kind::Glyphs:
-        url = util::mapbox::normalizeGlyphsURL(resource.url, accessToken);
-        break;
-
-    case Resource::Kind::SpriteImage:
-    case Resource::Kind::SpriteJSON:
-        url = util::mapbox::normalizeSpriteURL(resource.url, accessToken);
-        break;
-
-    default:
-        url = resource.url;
-    }
+    const std::string url = util::mapbox::normalizeURL(resource, accessToken);
 
     auto req = new Request({ resource.kind, url }, l, std::move(callback));
     thread->invoke(&Impl::add, req);
@@ -80,6 +77,33 @@ void DefaultFileSource::cancel(Request *req) {
     thread->invoke(&Impl::cancel, req);
 }
 
+void DefaultFileSource::setPriority(Request* req, double rank, bool prefetch) {
+    assert(req);
+    if (req->setPriority(rank, prefetch)) {
+        thread->invoke(&Impl::reprioritize, req);
+    }
+}
+
+DefaultFileSource::Statistics DefaultFileSource::getStatistics() {
+    return thread->invokeSync<Statistics>(&Impl::getStatistics);
+}
+
+void DefaultFileSource::setMemoryCacheSize(std::size_t bytes) {
+    thread->invoke(&Impl::setMemoryCacheSize, bytes);
+}
+
+FileCache::Usage DefaultFileSource::getMemoryCacheUsage() {
+    return thread->invokeSync<FileCache::Usage>(&Impl::getMemoryCacheUsage);
+}
+
+void DefaultFileSource::setHTTPMultiplexing(bool enabled) {
+    thread->invoke(&Impl::setHTTPMultiplexing, enabled);
+}
+
+void DefaultFileSource::setMaxConnectionsPerHost(std::size_t connections) {
+    thread->invoke(&Impl::setMaxConnectionsPerHost, connections);
+}
+
 // ----- Impl -----
 
 DefaultFileSource::Impl::Impl(FileCache* cache_, const std::string& root)
@@ -87,7 +111,10 @@ DefaultFileSource::Impl::Impl(FileCache* cache_, const std::string& root)
       cache(cache_),
       assetRoot(root.empty() ? platform::assetRoot() : root),
       assetContext(AssetContextBase::createContext(loop)),
-      httpContext(HTTPContextBase::createContext(loop)) {
+      httpContext(HTTPContextBase::createContext(loop)),
+      mbtilesContext(MBTilesContextBase::createContext(loop)),
+      scheduler(maxActiveRequests, maxActiveRequestsPerHost),
+      expiryTimer(std::make_unique<uv::timer>(loop)) {
 }
 
 DefaultFileRequest* DefaultFileSource::Impl::find(const Resource& resource) {
@@ -109,6 +136,7 @@ void DefaultFileSource::Impl::add(Request* req) {
     // Add this request as an observer so that it'll get notified when something about this
     // request changes.
     request->observers.insert(req);
+    updatePriority(request);
 
     update(request);
 
@@ -132,17 +160,24 @@ void DefaultFileSource::Impl::update(DefaultFileRequest* request) {
             request->response = response;
         }
 
-        if (request->response->stale && !request->realRequest) {
+        if (request->response->stale && !request->realRequest && !request->queued) {
             // We've returned a stale response; now make sure the requester also gets a fresh
             // response eventually. It's possible that there's already a request in progress.
             // Note that this will also trigger updates to all other existing listeners.
             // Since we already have data, we're going to verify
             startRealRequest(request, request->response);
         }
-    } else if (!request->cacheRequest && !request->realRequest) {
-        // There is no request in progress, and we don't have a response yet. This means we'll have
-        // to start the request ourselves.
-        if (cache) {
+    } else if (!request->cacheRequest && !request->realRequest && !request->queued) {
+        // There is no request in progress, and we don't have a response yet. Responses that were
+        // used recently are still in memory, and can be returned right away, so that the new
+        // observer is notified by add(). Otherwise we'll have to start the request ourselves.
+        // MBTiles archives are local and never expire, so there's no point in storing a second
+        // copy of their contents in the cache.
+        if (auto response = memoryCache.get(request->resource)) {
+            request->response = response;
+            update(request);
+            scheduleUpdate(request);
+        } else if (cache && !algo::starts_with(request->resource.url, "mbtiles://")) {
             startCacheRequest(request);
         } else {
             startRealRequest(request);
@@ -174,10 +209,8 @@ void DefaultFileSource::Impl::startCacheRequest(DefaultFileRequest* request) {
 }
 
 void DefaultFileSource::Impl::startRealRequest(DefaultFileRequest* request, std::shared_ptr<const Response> response) {
-    // Cancel the timer if we have one.
-    if (request->timerRequest) {
-        request->timerRequest->stop();
-    }
+    // The response is being revalidated, so it no longer has to wait for its expiry.
+    removeExpiry(request);
 
     auto callback = [request, this] (std::shared_ptr<const Response> res, FileCache::Hint hint) {
         request->realRequest = nullptr;
@@ -186,8 +219,63 @@ void DefaultFileSource::Impl::startRealRequest(DefaultFileRequest* request, std:
 
     if (algo::starts_with(request->resource.url, "asset://")) {
         request->realRequest = assetContext->createRequest(request->resource, callback, loop, assetRoot);
+    } else if (algo::starts_with(request->resource.url, "mbtiles://")) {
+        request->realRequest = mbtilesContext->createRequest(request->resource, callback, loop);
     } else {
-        request->realRequest = httpContext->createRequest(request->resource, callback, loop, response);
+        // Network requests wait for a free connection.
+        request->queued = true;
+        scheduler.add(request, request->resource.url, getPriority(request), [this, request, response] {
+            request->queued = false;
+            startHTTPRequest(request, response);
+        });
+    }
+}
+
+void DefaultFileSource::Impl::startHTTPRequest(DefaultFileRequest* request, std::shared_ptr<const Response> response) {
+    auto callback = [request, this] (std::shared_ptr<const Response> res, FileCache::Hint hint) {
+        request->realRequest = nullptr;
+        scheduler.finished(request);
+        notify(request, res, hint);
+    };
+
+    request->realRequest = httpContext->createRequest(request->resource, callback, loop, response);
+}
+
+RequestScheduler::Priority DefaultFileSource::Impl::getPriority(const DefaultFileRequest* request) const {
+    using Category = RequestScheduler::Category;
+
+    switch (request->resource.kind) {
+    case Resource::Kind::Style:
+    case Resource::Kind::Source:
+        return { Category::Style, 0 };
+
+    case Resource::Kind::Tile: {
+        // Several requesters may share the same tile; the most urgent one wins.
+        bool prefetch = true;
+        double rank = std::numeric_limits<double>::infinity();
+        for (const auto req : request->observers) {
+            prefetch = prefetch && req->isPrefetch();
+            rank = std::min(rank, req->getRank());
+        }
+        return { prefetch ? Category::Prefetch : Category::Tile, rank };
+    }
+
+    default:
+        return { Category::Resource, 0 };
+    }
+}
+
+void DefaultFileSource::Impl::updatePriority(DefaultFileRequest* request) {
+    if (request->queued) {
+        scheduler.update(request, getPriority(request));
+    }
+}
+
+void DefaultFileSource::Impl::reprioritize(Request* req) {
+    // The request hasn't been destroyed yet: it is canceled on this thread, after this call.
+    DefaultFileRequest* request = find(req->resource);
+    if (request && request->observers.count(req)) {
+        updatePriority(request);
     }
 }
 
@@ -204,8 +292,17 @@ void DefaultFileSource::Impl::cancel(Request* req) {
             }
             if (request->realRequest) {
                 request->realRequest->cancel();
+                if (isNetworkRequest(request->resource)) {
+                    scheduler.finished(request);
+                }
+            } else if (request->queued) {
+                scheduler.remove(request);
             }
+            removeExpiry(request);
             pending.erase(request->resource);
+        } else {
+            // The most urgent observer may have been the one that left.
+            updatePriority(request);
         }
     } else {
         // There is no request for this URL anymore. Likely, the request already completed
@@ -217,6 +314,30 @@ void DefaultFileSource::Impl::cancel(Request* req) {
     req->destruct();
 }
 
+DefaultFileSource::Statistics DefaultFileSource::Impl::getStatistics() const {
+    auto statistics = scheduler.getStatistics();
+    statistics.expiry = expiryStatistics;
+    statistics.expiry.pending = expiries.size();
+    statistics.http = httpContext->getStatistics();
+    return statistics;
+}
+
+void DefaultFileSource::Impl::setMemoryCacheSize(std::size_t bytes) {
+    memoryCache.setMaxBytes(bytes);
+}
+
+FileCache::Usage DefaultFileSource::Impl::getMemoryCacheUsage() const {
+    return memoryCache.getUsage();
+}
+
+void DefaultFileSource::Impl::setHTTPMultiplexing(bool enabled) {
+    httpContext->setMultiplexing(enabled);
+}
+
+void DefaultFileSource::Impl::setMaxConnectionsPerHost(std::size_t connections) {
+    httpContext->setMaxConnectionsPerHost(connections);
+}
+
 void DefaultFileSource::Impl::notify(DefaultFileRequest* request, std::shared_ptr<const Response> response, FileCache::Hint hint) {
     // First, remove the request, since it might be destructed at any point now.
     assert(find(request->resource) == request);
@@ -233,26 +354,87 @@ void DefaultFileSource::Impl::notify(DefaultFileRequest* request, std::shared_pt
         cache->put(request->resource, response, hint);
     }
 
-    // Set timer for requests that have a known expiry times. Expiry times of 0 are technically
-    // expiring immediately, but we can't continually request.
-    if (!request->realRequest && response->expires > 0) {
-        const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
-                                    SystemClock::now().time_since_epoch()).count();
-        const int64_t timeout = response->expires - now;
+    // Errors are usually temporary, so the next request should try again. Local files can be
+    // read again quickly, and would only take the place of responses that came from the network.
+    if (response->status != Response::Error && isNetworkRequest(request->resource)) {
+        memoryCache.add(request->resource, response);
+    }
 
-        if (timeout <= 0) {
+    scheduleUpdate(request);
+}
+
+void DefaultFileSource::Impl::scheduleUpdate(DefaultFileRequest* request) {
+    const auto& response = request->response;
+
+    // Track requests that have a known expiry times. Expiry times of 0 are technically
+    // expiring immediately, but we can't continually request.
+    if (!request->realRequest && !request->queued && response->expires > 0) {
+        if (response->expires <= now()) {
             update(request);
         } else {
-            if (!request->timerRequest) {
-                request->timerRequest = std::make_unique<uv::timer>(util::RunLoop::getLoop());
-            }
-
-            // timeout is in seconds, but the timer takes milliseconds.
-            request->timerRequest->start(1000 * timeout, 0, [this, request] {
-                update(request);
-            });
+            removeExpiry(request);
+            request->expiry = expiries.emplace(response->expires, request);
+            request->expiring = true;
+            startExpiryTimer();
         }
     }
 }
 
+void DefaultFileSource::Impl::removeExpiry(DefaultFileRequest* request) {
+    if (request->expiring) {
+        expiries.erase(request->expiry);
+        request->expiring = false;
+    }
+
+    // A running timer keeps the run loop alive, which would prevent the thread from stopping.
+    if (expiries.empty() && expiryTimerTarget != 0) {
+        expiryTimer->stop();
+        expiryTimerTarget = 0;
+    }
+}
+
+void DefaultFileSource::Impl::startExpiryTimer() {
+    if (expiries.empty()) {
+        return;
+    }
+
+    // Expiry times have a resolution of seconds, so all responses that expire in the same second
+    // are revalidated by the same wakeup.
+    const int64_t target = expiries.begin()->first;
+    if (expiryTimerTarget != 0 && expiryTimerTarget <= target) {
+        // The timer is already going to fire early enough.
+        return;
+    }
+
+    // Round the timeout up, since a timer that fires before the target finds nothing expired.
+    expiryTimerTarget = target;
+    const auto timeout = std::chrono::seconds(target) - SystemClock::now().time_since_epoch()
+        + std::chrono::milliseconds(1) - SystemClock::duration(1);
+    expiryTimer->start(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count()), 0, [this] {
+        revalidateExpired();
+    });
+}
+
+void DefaultFileSource::Impl::revalidateExpired() {
+    expiryTimerTarget = 0;
+    expiryStatistics.wakeups++;
+
+    // Take the expired requests out of the queue first; updating them may add them again.
+    std::vector<DefaultFileRequest*> expired;
+    const int64_t time = now();
+    while (!expiries.empty() && expiries.begin()->first <= time) {
+        DefaultFileRequest* request = expiries.begin()->second;
+        request->expiring = false;
+        expiries.erase(expiries.begin());
+        expired.push_back(request);
+    }
+
+    for (auto request : expired) {
+        expiryStatistics.revalidations++;
+        update(request);
+    }
+
+    startExpiryTimer();
+}
+
 }
@@ -4,7 +4,11 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/asset_context_base.hpp>
 #include <mbgl/storage/http_context_base.hpp>
+#include <mbgl/storage/mbtiles_context_base.hpp>
+#include <mbgl/storage/request_scheduler.hpp>
+#include <mbgl/storage/response_cache.hpp>
 
+#include <map>
 #include <set>
 #include <unordered_map>
 
@@ -12,6 +16,11 @@ namespace mbgl {
 
 class RequestBase;
 
+struct DefaultFileRequest;
+
+// Requests whose response expires, ordered by the expiry time in seconds since the epoch.
+using ExpiryQueue = std::multimap<int64_t, DefaultFileRequest*>;
+
 struct DefaultFileRequest {
     const Resource resource;
     std::set<Request*> observers;
@@ -19,7 +28,11 @@ struct DefaultFileRequest {
 
     std::unique_ptr<WorkRequest> cacheRequest;
     RequestBase* realRequest = nullptr;
-    std::unique_ptr<uv::timer> timerRequest;
+    bool queued = false; // Waiting for the scheduler to start the real request.
+
+    // Position in the expiry queue while waiting for the response to expire.
+    bool expiring = false;
+    ExpiryQueue::iterator expiry;
 
     inline DefaultFileRequest(const Resource& resource_)
         : resource(resource_) {}
@@ -37,6 +50,12 @@ public:
 
     void add(Request*);
     void cancel(Request*);
+    void reprioritize(Request*);
+    DefaultFileSource::Statistics getStatistics() const;
+    void setMemoryCacheSize(std::size_t);
+    FileCache::Usage getMemoryCacheUsage() const;
+    void setHTTPMultiplexing(bool);
+    void setMaxConnectionsPerHost(std::size_t);
 
 private:
     DefaultFileRequest* find(const Resource&);
@@ -44,7 +63,14 @@ private:
     void update(DefaultFileRequest*);
     void startCacheRequest(DefaultFileRequest*);
     void startRealRequest(DefaultFileRequest*, std::shared_ptr<const Response> = nullptr);
+    void startHTTPRequest(DefaultFileRequest*, std::shared_ptr<const Response>);
+    RequestScheduler::Priority getPriority(const DefaultFileRequest*) const;
+    void updatePriority(DefaultFileRequest*);
     void notify(DefaultFileRequest*, std::shared_ptr<const Response>, FileCache::Hint);
+    void scheduleUpdate(DefaultFileRequest*);
+    void removeExpiry(DefaultFileRequest*);
+    void startExpiryTimer();
+    void revalidateExpired();
 
     std::unordered_map<Resource, DefaultFileRequest, Resource::Hash> pending;
     uv_loop_t* loop = nullptr;
@@ -52,6 +78,14 @@ private:
     const std::string assetRoot;
     std::unique_ptr<AssetContextBase> assetContext;
     std::unique_ptr<HTTPContextBase> httpContext;
+    std::unique_ptr<MBTilesContextBase> mbtilesContext;
+    RequestScheduler scheduler;
+    ResponseCache memoryCache;
+
+    ExpiryQueue expiries;
+    std::unique_ptr<uv::timer> expiryTimer;
+    int64_t expiryTimerTarget = 0; // Time at which the timer fires; 0 when it isn't running.
+    DefaultFileSource::Statistics::Expiry expiryStatistics;
 };
 
 }
@@ -0,0 +1,10 @@
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
+
+namespace mbgl {
+
+void FileSource::setPriority(Request* req, double rank, bool prefetch) {
+    req->setPriority(rank, prefetch);
+}
+
+}
@@ -4,6 +4,7 @@
 #include <mbgl/storage/request_base.hpp>
 #include <mbgl/storage/http_request_base.hpp>
 #include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/util/uv_detail.hpp>
 
 #include <set>
@@ -25,6 +26,17 @@ public:
     void addRequest(HTTPRequestBase*);
     void removeRequest(HTTPRequestBase*);
 
+    // Connection settings for requests that start afterwards. Implementations that can't
+    // control their connections ignore them.
+    virtual void setMultiplexing(bool) {}
+    virtual void setMaxConnectionsPerHost(std::size_t) {}
+
+    using Statistics = DefaultFileSource::Statistics::HTTP;
+    Statistics getStatistics() const { return statistics; }
+
+protected:
+    Statistics statistics;
+
 private:
     void retryRequests();
 
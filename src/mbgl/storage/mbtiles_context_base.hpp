@@ -0,0 +1,25 @@
+#ifndef MBGL_STORAGE_MBTILES_CONTEXT_BASE
+#define MBGL_STORAGE_MBTILES_CONTEXT_BASE
+
+#include <mbgl/storage/request_base.hpp>
+
+typedef struct uv_loop_s uv_loop_t;
+
+namespace mbgl {
+
+// Serves mbtiles:// URLs from MBTiles archives on disk. A URL of kind Source points to an archive
+// (e.g. mbtiles:///path/to/region.mbtiles) and yields a TileJSON document generated from the
+// archive's metadata, whose tile URLs append /{z}/{x}/{y} to the archive path.
+class MBTilesContextBase {
+public:
+    static std::unique_ptr<MBTilesContextBase> createContext(uv_loop_t*);
+
+    virtual ~MBTilesContextBase() = default;
+    virtual RequestBase* createRequest(const Resource&,
+                                       RequestBase::Callback,
+                                       uv_loop_t*) = 0;
+};
+
+} // namespace mbgl
+
+#endif // MBGL_STORAGE_MBTILES_CONTEXT_BASE
@@ -0,0 +1,366 @@
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/file_cache.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/style/style_parser.hpp>
+#include <mbgl/style/style_layer.hpp>
+#include <mbgl/style/style_bucket.hpp>
+#include <mbgl/style/property_evaluator.hpp>
+#include <mbgl/style/style_properties.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/math.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/token.hpp>
+#include <mbgl/util/url.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <list>
+#include <set>
+#include <unordered_set>
+
+namespace mbgl {
+
+class OfflineDownload::Impl {
+public:
+    Impl(const std::string& pack, const OfflineRegion&, FileSource&, FileCache&, Callback);
+    ~Impl();
+
+private:
+    using Parser = std::function<void(const std::string& data)>;
+
+    struct Download {
+        Resource resource;
+        Parser parse; // Only set for documents that reference further resources.
+        Request* request = nullptr;
+    };
+
+    // Tiles of one zoom level of a source. They are generated one at a time as requests become
+    // available, so that large regions don't need a list of all of their tiles.
+    struct TileRange {
+        std::shared_ptr<const SourceInfo> info;
+        int32_t z;
+        int32_t minX, maxX, maxY; // Exclusive maximum.
+        int32_t x, y;
+    };
+
+    void start(std::vector<std::string> urls);
+    void add(const Resource&, Parser = nullptr);
+    bool activateNext();
+    void next();
+    void handle(std::list<Download>::iterator, const Response&);
+
+    std::string cacheURL(const Resource&) const;
+
+    void parseStyle(const std::string& data);
+    void addTiles(std::shared_ptr<const SourceInfo>);
+    void addGlyphs(const std::string& glyphURL, const std::set<std::string>& fontStacks);
+
+    const std::string pack;
+    const OfflineRegion region;
+    FileSource& fileSource;
+    FileCache& cache;
+    const Callback callback;
+
+    // Canonical URLs of the responses that are part of the pack already.
+    std::unordered_set<std::string> completed;
+    std::unique_ptr<WorkRequest> packRequest;
+
+    std::deque<Download> queue;
+    std::deque<TileRange> tiles;
+    std::list<Download> active;
+    Progress progress;
+};
+
+const std::size_t OfflineDownload::maxConcurrentRequests = 8;
+
+OfflineDownload::OfflineDownload(const std::string& pack,
+                                 const OfflineRegion& region,
+                                 FileSource& fileSource,
+                                 FileCache& cache,
+                                 Callback callback)
+    : impl(std::make_unique<Impl>(pack, region, fileSource, cache, callback)) {
+}
+
+OfflineDownload::~OfflineDownload() = default;
+
+OfflineDownload::Impl::Impl(const std::string& pack_,
+                            const OfflineRegion& region_,
+                            FileSource& fileSource_,
+                            FileCache& cache_,
+                            Callback callback_)
+    : pack(pack_),
+      region(region_),
+      fileSource(fileSource_),
+      cache(cache_),
+      callback(callback_) {
+    // Find out what has been downloaded before we start downloading anything.
+    packRequest = cache.getPack(pack, [this] (std::vector<std::string> urls) {
+        packRequest.reset();
+        start(std::move(urls));
+    });
+}
+
+OfflineDownload::Impl::~Impl() {
+    for (auto& download : active) {
+        fileSource.cancel(download.request);
+    }
+}
+
+void OfflineDownload::Impl::start(std::vector<std::string> urls) {
+    completed.insert(urls.begin(), urls.end());
+    add({ Resource::Kind::Style, region.styleURL }, [this] (const std::string& data) {
+        parseStyle(data);
+    });
+}
+
+void OfflineDownload::Impl::add(const Resource& resource, Parser parse) {
+    queue.push_back({ resource, std::move(parse), nullptr });
+    progress.requiredResources++;
+    next();
+}
+
+bool OfflineDownload::Impl::activateNext() {
+    if (!queue.empty()) {
+        active.push_back(std::move(queue.front()));
+        queue.pop_front();
+        return true;
+    }
+
+    while (!tiles.empty()) {
+        TileRange& range = tiles.front();
+        if (range.y < range.maxY) {
+            const TileID id(range.z, range.x, range.y, range.z);
+            active.push_back({ { Resource::Kind::Tile, range.info->tileURL(id, region.pixelRatio) }, nullptr, nullptr });
+            if (++range.x == range.maxX) {
+                range.x = range.minX;
+                range.y++;
+            }
+            return true;
+        }
+        tiles.pop_front();
+    }
+
+    return false;
+}
+
+void OfflineDownload::Impl::next() {
+    while (active.size() < maxConcurrentRequests && activateNext()) {
+        auto it = std::prev(active.end());
+        if (!it->parse && completed.count(cacheURL(it->resource))) {
+            // Don't download it again. Documents we have to parse are still loaded, but they'll be
+            // served by the cache, even if they're stale.
+            active.erase(it);
+            progress.completedResources++;
+            continue;
+        }
+
+        it->request = fileSource.request(it->resource, util::RunLoop::getLoop(), [this, it] (const Response& res) {
+            handle(it, res);
+        });
+    }
+
+    if (queue.empty() && tiles.empty() && active.empty() && !packRequest && !progress.complete) {
+        progress.complete = true;
+        callback(progress);
+    }
+}
+
+void OfflineDownload::Impl::handle(std::list<Download>::iterator it, const Response& res) {
+    const Resource resource = it->request->resource;
+    if (res.stale && !completed.count(util::mapbox::canonicalURL(resource.url))) {
+        // Wait for a fresh response, unless this one was already good enough for the pack.
+        return;
+    }
+
+    const Parser parse = std::move(it->parse);
+    fileSource.cancel(it->request);
+    active.erase(it);
+
+    if (res.status == Response::Error) {
+        Log::Warning(Event::HttpRequest, "Failed to download [%s]: %s", resource.url.c_str(), res.message.c_str());
+        progress.failedResources++;
+    } else {
+        // A tile that doesn't exist is still a valid answer; keep it so that we don't ask again.
+        cache.addToPack(pack, resource);
+        progress.completedResources++;
+        if (res.data) {
+            progress.completedBytes += res.data->size();
+            if (parse && res.status == Response::Successful) {
+                parse(*res.data);
+            }
+        }
+    }
+
+    callback(progress);
+    next();
+}
+
+std::string OfflineDownload::Impl::cacheURL(const Resource& resource) const {
+    // The same URL that the file source requests and stores the response under.
+    return util::mapbox::canonicalURL(util::mapbox::normalizeURL(resource, region.accessToken));
+}
+
+void OfflineDownload::Impl::parseStyle(const std::string& data) {
+    rapidjson::Document doc;
+    doc.Parse<0>(data.c_str());
+    if (doc.HasParseError()) {
+        Log::Error(Event::ParseStyle, "Failed to parse style of offline pack '%s'", pack.c_str());
+        return;
+    }
+
+    StyleParser parser;
+    parser.parse(doc);
+
+    for (const auto& source : parser.getSources()) {
+        const SourceInfo& info = source->info;
+        if (info.type != SourceType::Vector && info.type != SourceType::Raster) {
+            continue;
+        }
+
+        if (info.url.empty()) {
+            auto inlineInfo = std::make_shared<SourceInfo>();
+            inlineInfo->type = info.type;
+            inlineInfo->tiles = info.tiles;
+            inlineInfo->tile_size = info.tile_size;
+            inlineInfo->min_zoom = info.min_zoom;
+            inlineInfo->max_zoom = info.max_zoom;
+            inlineInfo->source_id = info.source_id;
+            addTiles(inlineInfo);
+            continue;
+        }
+
+        // The tile URLs are in the TileJSON document.
+        auto tileJSON = std::make_shared<SourceInfo>();
+        tileJSON->type = info.type;
+        tileJSON->url = info.url;
+        tileJSON->tile_size = info.tile_size;
+        tileJSON->source_id = info.source_id;
+        add({ Resource::Kind::Source, info.url }, [this, tileJSON] (const std::string& json) {
+            rapidjson::Document tileDoc;
+            tileDoc.Parse<0>(json.c_str());
+            if (tileDoc.HasParseError()) {
+                Log::Error(Event::ParseStyle, "Failed to parse [%s]", tileJSON->url.c_str());
+                return;
+            }
+            tileJSON->parseTileJSONProperties(tileDoc);
+            addTiles(tileJSON);
+        });
+    }
+
+    const std::string sprite = parser.getSprite();
+    if (!sprite.empty()) {
+        const std::string ratio = region.pixelRatio > 1 ? "@2x" : "";
+        add({ Resource::Kind::SpriteJSON, sprite + ratio + ".json" });
+        add({ Resource::Kind::SpriteImage, sprite + ratio + ".png" });
+    }
+
+    // Collect the font stacks that labels use at any zoom level of the region.
+    std::set<std::string> fontStacks;
+    for (const auto& layer : parser.getLayers()) {
+        if (layer->type != StyleLayerType::Symbol || !layer->bucket) {
+            continue;
+        }
+
+        const auto& properties = layer->bucket->layout.properties;
+        const auto font = properties.find(PropertyKey::TextFont);
+        if (font == properties.end()) {
+            if (properties.count(PropertyKey::TextField)) {
+                fontStacks.insert(SymbolLayoutProperties().text.font);
+            }
+            continue;
+        }
+
+        for (int z = std::floor(region.minZoom); z <= std::ceil(region.maxZoom); z++) {
+            const PropertyEvaluator<std::string> evaluator(z);
+            const std::string fontStack = mapbox::util::apply_visitor(evaluator, font->second);
+            if (!fontStack.empty()) {
+                fontStacks.insert(fontStack);
+            }
+        }
+    }
+
+    const std::string glyphURL = parser.getGlyphURL();
+    if (!glyphURL.empty()) {
+        addGlyphs(glyphURL, fontStacks);
+    }
+}
+
+void OfflineDownload::Impl::addTiles(std::shared_ptr<const SourceInfo> info) {
+    if (info->tiles.empty()) {
+        return;
+    }
+
+    // Sources with smaller tiles need tiles of a higher zoom level for the same map zoom level.
+    const int32_t offset = std::round(std::log2(double(util::tileSize) / info->tile_size));
+    const int32_t minZoom = std::max<int32_t>(std::floor(region.minZoom + offset), info->min_zoom);
+    const int32_t maxZoom = std::min<int32_t>(std::ceil(region.maxZoom + offset), info->max_zoom);
+
+    const vec2<double> nw = LatLng(region.bounds.ne.latitude, region.bounds.sw.longitude).project();
+    const vec2<double> se = LatLng(region.bounds.sw.latitude, region.bounds.ne.longitude).project();
+
+    // The western edge is east of the eastern one when the region crosses the antimeridian.
+    const bool antimeridian = region.bounds.sw.longitude > region.bounds.ne.longitude;
+
+    for (int32_t z = minZoom; z <= maxZoom; z++) {
+        const double scale = std::pow(2.0, z);
+        const auto clamp = [&] (double value) {
+            return int32_t(util::clamp(value, 0.0, scale));
+        };
+
+        const int32_t minX = clamp(std::floor(nw.x * scale));
+        const int32_t maxX = clamp(std::ceil(se.x * scale));
+        const int32_t minY = clamp(std::floor(nw.y * scale));
+        const int32_t maxY = clamp(std::ceil(se.y * scale));
+
+        const auto addRange = [&] (int32_t fromX, int32_t toX) {
+            if (fromX >= toX || minY >= maxY) {
+                return;
+            }
+
+            // The tiles are only counted here; next() generates them.
+            progress.requiredResources += uint64_t(toX - fromX) * (maxY - minY);
+            tiles.push_back({ info, z, fromX, toX, maxY, fromX, minY });
+        };
+
+        if (!antimeridian) {
+            addRange(minX, maxX);
+        } else if (maxX >= minX) {
+            // Both sides of the antimeridian share a column, so the region spans the whole row.
+            addRange(0, clamp(scale));
+        } else {
+            addRange(minX, clamp(scale));
+            addRange(0, maxX);
+        }
+    }
+
+    next();
+}
+
+void OfflineDownload::Impl::addGlyphs(const std::string& glyphURL, const std::set<std::string>& fontStacks) {
+    // We can't know which characters the labels of the region use without downloading and parsing
+    // all of its tiles first, so download every range.
+    for (const auto& fontStack : fontStacks) {
+        for (uint32_t start = 0; start < 65536; start += 256) {
+            const std::string url = util::replaceTokens(glyphURL, [&](const std::string &name) -> std::string {
+                if (name == "fontstack") return util::percentEncode(fontStack);
+                if (name == "range") return util::toString(start) + "-" + util::toString(start + 255);
+                return "";
+            });
+            add({ Resource::Kind::Glyphs, url });
+        }
+    }
+}
+
+}
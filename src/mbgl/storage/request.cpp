@@ -60,6 +60,12 @@ void Request::cancel() {
 }
 
 
+bool Request::setPriority(double rank_, bool prefetch_) {
+    const double previousRank = rank.exchange(rank_);
+    const bool previousPrefetch = prefetch.exchange(prefetch_);
+    return previousRank != rank_ || previousPrefetch != prefetch_;
+}
+
 // Called in the FileSource thread.
 // Will only ever be invoked after cancel() was called in the original requesting thread.
 void Request::destruct() {
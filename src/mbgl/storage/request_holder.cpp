@@ -4,6 +4,12 @@
 
 namespace mbgl {
 
+void RequestHolder::setPriority(double rank, bool prefetch) {
+    if (ptr) {
+        util::ThreadContext::getFileSource()->setPriority(ptr.get(), rank, prefetch);
+    }
+}
+
 void RequestHolder::Deleter::operator()(Request* req) const {
     // This function is called by the unique_ptr's Deleter.
     util::ThreadContext::getFileSource()->cancel(req);
@@ -14,6 +14,13 @@ public:
         return *this;
     }
 
+    inline Request* get() const {
+        return ptr.get();
+    }
+
+    // Changes the priority of the request, if there is one; see Request::setPriority().
+    void setPriority(double rank, bool prefetch);
+
 private:
     struct Deleter {
         void operator()(Request*) const;
@@ -0,0 +1,140 @@
+#include <mbgl/storage/request_scheduler.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+
+namespace {
+
+std::string getHost(const std::string& url) {
+    const auto start = url.find("://");
+    if (start == std::string::npos) {
+        return "";
+    }
+    const auto end = url.find_first_of("/?#", start + 3);
+    return url.substr(start + 3, end == std::string::npos ? end : end - start - 3);
+}
+
+} // namespace
+
+RequestScheduler::RequestScheduler(std::size_t maxActive_, std::size_t maxActivePerHost_)
+    : maxActive(maxActive_),
+      maxActivePerHost(maxActivePerHost_) {
+    assert(maxActive > 0 && maxActivePerHost > 0);
+}
+
+void RequestScheduler::add(Key key, const std::string& url, Priority priority, std::function<void()> start) {
+    assert(waiting.find(key) == waiting.end());
+    const Order order { priority, sequence++, key };
+    const auto& entry = waiting.emplace(key, Entry { getHost(url), order, std::move(start), Clock::now() }).first->second;
+    waitingPerHost[entry.host].insert(order);
+    statistics.queued = waiting.size();
+    statistics.maxQueued = std::max(statistics.maxQueued, statistics.queued);
+    next();
+}
+
+void RequestScheduler::update(Key key, Priority priority) {
+    const auto it = waiting.find(key);
+    if (it == waiting.end()) {
+        return;
+    }
+
+    Order& order = it->second.order;
+    if (!(order.priority < priority) && !(priority < order.priority)) {
+        return;
+    }
+
+    auto& orders = waitingPerHost[it->second.host];
+    orders.erase(order);
+    order.priority = priority;
+    orders.insert(order);
+}
+
+void RequestScheduler::remove(Key key) {
+    const auto it = waiting.find(key);
+    if (it == waiting.end()) {
+        return;
+    }
+
+    const auto host = waitingPerHost.find(it->second.host);
+    host->second.erase(it->second.order);
+    if (host->second.empty()) {
+        waitingPerHost.erase(host);
+    }
+    waiting.erase(it);
+    statistics.queued = waiting.size();
+}
+
+void RequestScheduler::finished(Key key) {
+    const auto it = active.find(key);
+    assert(it != active.end());
+    if (--activePerHost[it->second] == 0) {
+        activePerHost.erase(it->second);
+    }
+    active.erase(it);
+    statistics.active = active.size();
+    next();
+}
+
+void RequestScheduler::next() {
+    while (!waiting.empty() && active.size() < maxActive) {
+        // The most important request of every host that has a free slot competes.
+        const Order* best = nullptr;
+        for (const auto& host : waitingPerHost) {
+            const auto it = activePerHost.find(host.first);
+            if (it != activePerHost.end() && it->second >= maxActivePerHost) {
+                continue;
+            }
+
+            const Order& first = *host.second.begin();
+            if (!best || first < *best) {
+                best = &first;
+            }
+        }
+
+        if (!best) {
+            // Every waiting request is for a host that is busy.
+            return;
+        }
+
+        const Category category = best->priority.category;
+        const auto it = waiting.find(best->key);
+        const Key key = it->first;
+        Entry entry = std::move(it->second);
+        waiting.erase(it);
+
+        const auto host = waitingPerHost.find(entry.host);
+        host->second.erase(host->second.begin());
+        if (host->second.empty()) {
+            waitingPerHost.erase(host);
+        }
+
+        active.emplace(key, entry.host);
+        activePerHost[entry.host]++;
+
+        Statistics::Wait* wait = nullptr;
+        switch (category) {
+            case Category::Style:    wait = &statistics.style;     break;
+            case Category::Resource: wait = &statistics.resources; break;
+            case Category::Tile:     wait = &statistics.tiles;     break;
+            case Category::Prefetch: wait = &statistics.prefetch;  break;
+        }
+
+        const Duration waited = Clock::now() - entry.added;
+        wait->started++;
+        wait->total += waited;
+        wait->max = std::max(wait->max, waited);
+        statistics.queued = waiting.size();
+        statistics.active = active.size();
+
+        // This may finish the request right away, which calls next() again.
+        entry.start();
+    }
+}
+
+RequestScheduler::Statistics RequestScheduler::getStatistics() const {
+    return statistics;
+}
+
+} // namespace mbgl
@@ -0,0 +1,100 @@
+#ifndef MBGL_STORAGE_REQUEST_SCHEDULER
+#define MBGL_STORAGE_REQUEST_SCHEDULER
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// Decides when network requests may start: at most `maxActive` requests are in flight at the same
+// time, and at most `maxActivePerHost` of them to the same host. Whenever a slot becomes free, the
+// waiting request with the most important category starts, and within a category the one with
+// the lowest rank. Requests with the same priority start in the order they were added. Waiting
+// requests are kept ordered by priority for each host, so that starting one only has to look at
+// the first request of every host; they're reordered when update() changes their priority.
+//
+// Not thread-safe; DefaultFileSource uses it on its own thread only.
+class RequestScheduler : private util::noncopyable {
+public:
+    enum class Category : uint8_t {
+        Style,     // Styles and TileJSON documents, which everything else depends on.
+        Resource,  // Glyphs, sprites and other resources.
+        Tile,      // Tiles that are visible.
+        Prefetch,  // Tiles that aren't visible yet.
+    };
+
+    struct Priority {
+        Category category;
+        double rank;
+
+        bool operator<(const Priority& other) const {
+            return category != other.category ? category < other.category : rank < other.rank;
+        }
+    };
+
+    using Key = const void*;
+    using Statistics = DefaultFileSource::Statistics;
+
+    RequestScheduler(std::size_t maxActive, std::size_t maxActivePerHost);
+
+    // Invokes start() as soon as the request may start, which may be right away. Every request
+    // that was started must be reported with finished() once it completed or was canceled.
+    void add(Key, const std::string& url, Priority, std::function<void()> start);
+
+    // Changes the priority of a request that hasn't started yet.
+    void update(Key, Priority);
+
+    // Removes a request that hasn't started yet.
+    void remove(Key);
+
+    void finished(Key);
+
+    Statistics getStatistics() const;
+
+private:
+    struct Order {
+        Priority priority;
+        uint64_t sequence;
+        Key key;
+
+        bool operator<(const Order& other) const {
+            if (priority < other.priority) return true;
+            if (other.priority < priority) return false;
+            return sequence < other.sequence;
+        }
+    };
+
+    struct Entry {
+        std::string host;
+        Order order;
+        std::function<void()> start;
+        TimePoint added;
+    };
+
+    void next();
+
+    const std::size_t maxActive;
+    const std::size_t maxActivePerHost;
+
+    // Requests that haven't started yet, and the same requests ordered by priority for each host.
+    std::unordered_map<Key, Entry> waiting;
+    std::unordered_map<std::string, std::set<Order>> waitingPerHost;
+    uint64_t sequence = 0;
+
+    // Maps requests that have started to their host.
+    std::unordered_map<Key, std::string> active;
+    std::unordered_map<std::string, std::size_t> activePerHost;
+
+    Statistics statistics;
+};
+
+} // namespace mbgl
+
+#endif
@@ -0,0 +1,71 @@
+#include <mbgl/storage/response_cache.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+const std::size_t ResponseCache::defaultMaxBytes = 16 * 1024 * 1024;
+
+ResponseCache::ResponseCache(std::size_t maxBytes_)
+    : maxBytes(maxBytes_) {
+}
+
+void ResponseCache::setMaxBytes(std::size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    evict();
+}
+
+void ResponseCache::add(const Resource& resource, std::shared_ptr<const Response> response) {
+    assert(response);
+
+    auto it = index.find(resource);
+    if (it != index.end()) {
+        totalBytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    // The data is shared with everyone who received the response, but it is the only part that
+    // is large enough to matter.
+    const std::size_t bytes = sizeof(Response) + resource.url.size() + response->etag.size() +
+                              response->message.size() + (response->data ? response->data->size() : 0);
+    entries.push_back({ resource, std::move(response), bytes });
+    index.emplace(resource, std::prev(entries.end()));
+    totalBytes += bytes;
+
+    evict();
+}
+
+std::shared_ptr<const Response> ResponseCache::get(const Resource& resource) {
+    auto it = index.find(resource);
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+
+    hits++;
+    entries.splice(entries.end(), entries, it->second);
+    return it->second->response;
+}
+
+FileCache::Usage ResponseCache::getUsage() const {
+    FileCache::Usage usage;
+    usage.size = totalBytes;
+    usage.hits = hits;
+    usage.misses = misses;
+    return usage;
+}
+
+void ResponseCache::evict() {
+    while (!entries.empty() && totalBytes > maxBytes) {
+        const Entry& oldest = entries.front();
+        totalBytes -= oldest.bytes;
+        index.erase(oldest.resource);
+        entries.pop_front();
+    }
+
+    assert(totalBytes <= maxBytes);
+}
+
+} // namespace mbgl
@@ -0,0 +1,62 @@
+#ifndef MBGL_STORAGE_RESPONSE_CACHE
+#define MBGL_STORAGE_RESPONSE_CACHE
+
+#include <mbgl/storage/file_cache.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Response;
+
+// Least recently used cache of responses held in memory, bounded by the number of bytes they use.
+// DefaultFileSource consults it before the FileCache, so that resources that were used recently
+// don't need a round trip to the database thread. All operations take constant time.
+//
+// Not thread-safe; DefaultFileSource uses it on its own thread only.
+class ResponseCache : private util::noncopyable {
+public:
+    ResponseCache(std::size_t maxBytes = defaultMaxBytes);
+
+    void setMaxBytes(std::size_t);
+
+    void add(const Resource&, std::shared_ptr<const Response>);
+    // Marks the response as the most recently used one.
+    std::shared_ptr<const Response> get(const Resource&);
+
+    // Number of responses and bytes that are currently held by the cache.
+    std::size_t count() const { return entries.size(); }
+    std::size_t bytes() const { return totalBytes; }
+
+    FileCache::Usage getUsage() const;
+
+    static const std::size_t defaultMaxBytes;
+
+private:
+    struct Entry {
+        Resource resource;
+        std::shared_ptr<const Response> response;
+        std::size_t bytes;
+    };
+
+    void evict();
+
+    // Ordered from least to most recently used.
+    std::list<Entry> entries;
+    std::unordered_map<Resource, std::list<Entry>::iterator, Resource::Hash> index;
+
+    std::size_t maxBytes;
+    std::size_t totalBytes = 0;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+} // namespace mbgl
+
+#endif
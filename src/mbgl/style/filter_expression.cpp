@@ -1,7 +1,10 @@
 #include <mbgl/style/filter_expression.hpp>
 #include <mbgl/map/geometry_tile.hpp>
+#include <mbgl/style/value_comparison.hpp>
 #include <mbgl/platform/log.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 Value parseFeatureType(const Value& value) {
@@ -32,10 +35,10 @@ FilterExpression parseBinaryFilter(const rapidjson::Value& value) {
     }
 
     Expression expression;
-    expression.key = { value[1u].GetString(), value[1u].GetStringLength() };
+    expression.key.name = { value[1u].GetString(), value[1u].GetStringLength() };
     expression.value = parseValue(value[2u]);
 
-    if (expression.key == "$type") {
+    if (expression.key.name == "$type") {
         expression.value = parseFeatureType(expression.value);
     }
 
@@ -57,10 +60,10 @@ FilterExpression parseSetFilter(const rapidjson::Value& value) {
     }
 
     Expression expression;
-    expression.key = { value[1u].GetString(), value[1u].GetStringLength() };
+    expression.key.name = { value[1u].GetString(), value[1u].GetStringLength() };
     for (rapidjson::SizeType i = 2; i < value.Size(); ++i) {
         Value parsedValue = parseValue(value[i]);
-        if (expression.key == "$type") {
+        if (expression.key.name == "$type") {
             parsedValue = parseFeatureType(parsedValue);
         }
         expression.values.push_back(parsedValue);
@@ -125,4 +128,267 @@ FilterExpression parseFilterExpression(const rapidjson::Value& value) {
     }
 }
 
+namespace {
+
+// Integers beyond this magnitude can't be converted to double without losing precision.
+const int64_t maxExactInteger = int64_t(1) << 53;
+
+bool isExactInteger(int64_t value) {
+    return value >= -maxExactInteger && value <= maxExactInteger;
+}
+
+bool isExactInteger(uint64_t value) {
+    return value <= uint64_t(maxExactInteger);
+}
+
+}
+
+FilterValueSet::FilterValueSet(const std::vector<Value>& values_)
+    : values(values_) {
+    for (const auto& value : values) {
+        if (value.is<std::string>()) {
+            strings.insert(value.get<std::string>());
+        } else if (value.is<bool>()) {
+            (value.get<bool>() ? hasTrue : hasFalse) = true;
+        } else if (value.is<double>()) {
+            numbers.insert(value.get<double>());
+        } else if (value.is<int64_t>() && isExactInteger(value.get<int64_t>())) {
+            numbers.insert(double(value.get<int64_t>()));
+        } else if (value.is<uint64_t>() && isExactInteger(value.get<uint64_t>())) {
+            numbers.insert(double(value.get<uint64_t>()));
+        } else {
+            inexact.push_back(value);
+        }
+    }
+}
+
+bool FilterValueSet::contains(const Value& actual) const {
+    if (actual.is<std::string>()) {
+        return strings.count(actual.get<std::string>());
+    } else if (actual.is<bool>()) {
+        return actual.get<bool>() ? hasTrue : hasFalse;
+    }
+
+    if ((actual.is<int64_t>() && !isExactInteger(actual.get<int64_t>())) ||
+        (actual.is<uint64_t>() && !isExactInteger(actual.get<uint64_t>()))) {
+        // Relaxed comparisons of large integers depend on the type of both operands.
+        for (const auto& value : values) {
+            if (util::relaxed_equal(actual, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const double number = actual.is<double>() ? actual.get<double>()
+                        : actual.is<int64_t>() ? double(actual.get<int64_t>())
+                        : double(actual.get<uint64_t>());
+    if (numbers.count(number)) {
+        return true;
+    }
+
+    for (const auto& value : inexact) {
+        if (util::relaxed_equal(actual, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+
+// "in" and "!in" filters with at least this many values are evaluated with a hashed lookup.
+const std::size_t minHashedValues = 8;
+
+// An empty "any" filter never matches and is used as the constant false filter, while the null
+// filter is the constant true filter.
+bool isFalse(const FilterExpression& expression) {
+    return expression.is<AnyExpression>() && expression.get<AnyExpression>().expressions.empty();
+}
+
+bool isTrue(const FilterExpression& expression) {
+    return expression.is<NullExpression>();
+}
+
+// Relative cost of evaluating an expression, used to order the children of compound filters so
+// that cheap tests can short-circuit the evaluation of expensive ones.
+struct FilterCost : public mapbox::util::static_visitor<std::size_t> {
+    std::size_t operator()(const NullExpression&) const {
+        return 0;
+    }
+
+    template <class Expression>
+    std::size_t operator()(const Expression& expression) const {
+        return expression.key.name == "$type" ? 1 : 2;
+    }
+
+    std::size_t operator()(const InExpression& expression) const {
+        return setCost(expression);
+    }
+
+    std::size_t operator()(const NotInExpression& expression) const {
+        return setCost(expression);
+    }
+
+    std::size_t operator()(const AnyExpression& expression) const {
+        return compoundCost(expression);
+    }
+
+    std::size_t operator()(const AllExpression& expression) const {
+        return compoundCost(expression);
+    }
+
+    std::size_t operator()(const NoneExpression& expression) const {
+        return compoundCost(expression);
+    }
+
+private:
+    template <class Expression>
+    std::size_t setCost(const Expression& expression) const {
+        if (expression.key.name == "$type") {
+            return 1;
+        }
+        return expression.set ? 3 : 2 + expression.values.size() / 4;
+    }
+
+    template <class Expression>
+    std::size_t compoundCost(const Expression& expression) const {
+        std::size_t cost = 1;
+        for (const auto& e : expression.expressions) {
+            cost += mapbox::util::apply_visitor(*this, e);
+        }
+        return cost;
+    }
+};
+
+void sortByCost(std::vector<FilterExpression>& expressions) {
+    std::vector<std::pair<std::size_t, FilterExpression>> costed;
+    costed.reserve(expressions.size());
+    for (auto& e : expressions) {
+        costed.emplace_back(mapbox::util::apply_visitor(FilterCost(), e), std::move(e));
+    }
+
+    std::stable_sort(costed.begin(), costed.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    expressions.clear();
+    for (auto& c : costed) {
+        expressions.push_back(std::move(c.second));
+    }
+}
+
+class FilterOptimizer : public mapbox::util::static_visitor<FilterExpression> {
+public:
+    FilterExpression operator()(const NullExpression& expression) const {
+        return expression;
+    }
+
+    template <class Expression>
+    FilterExpression operator()(const Expression& expression) const {
+        return expression;
+    }
+
+    FilterExpression operator()(const InExpression& expression) const {
+        if (expression.values.empty()) {
+            return AnyExpression();
+        }
+        return withSet(expression);
+    }
+
+    FilterExpression operator()(const NotInExpression& expression) const {
+        if (expression.values.empty()) {
+            return NullExpression();
+        }
+        return withSet(expression);
+    }
+
+    FilterExpression operator()(const AllExpression& expression) const {
+        AllExpression result;
+        for (const auto& child : flatten<AllExpression>(expression.expressions)) {
+            if (isFalse(child)) {
+                return AnyExpression();
+            } else if (!isTrue(child)) {
+                result.expressions.push_back(child);
+            }
+        }
+        return finish(std::move(result), NullExpression());
+    }
+
+    FilterExpression operator()(const AnyExpression& expression) const {
+        AnyExpression result;
+        for (const auto& child : flatten<AnyExpression>(expression.expressions)) {
+            if (isTrue(child)) {
+                return NullExpression();
+            } else if (!isFalse(child)) {
+                result.expressions.push_back(child);
+            }
+        }
+        return finish(std::move(result), AnyExpression());
+    }
+
+    FilterExpression operator()(const NoneExpression& expression) const {
+        // none(a, any(b, c)) is equivalent to none(a, b, c).
+        NoneExpression result;
+        for (const auto& child : flatten<AnyExpression>(expression.expressions)) {
+            if (isTrue(child)) {
+                return AnyExpression();
+            } else if (!isFalse(child)) {
+                result.expressions.push_back(child);
+            }
+        }
+        if (result.expressions.empty()) {
+            return NullExpression();
+        }
+        sortByCost(result.expressions);
+        return result;
+    }
+
+private:
+    template <class Expression>
+    FilterExpression withSet(Expression expression) const {
+        if (expression.values.size() >= minHashedValues && !expression.set) {
+            expression.set = std::make_shared<FilterValueSet>(expression.values);
+        }
+        return expression;
+    }
+
+    // Optimizes the children and inlines the children of nested expressions of the same kind.
+    template <class Nested>
+    std::vector<FilterExpression> flatten(const std::vector<FilterExpression>& expressions) const {
+        std::vector<FilterExpression> result;
+        for (const auto& e : expressions) {
+            FilterExpression child = mapbox::util::apply_visitor(*this, e);
+            if (child.is<Nested>() && !isFalse(child)) {
+                const auto& nested = child.get<Nested>().expressions;
+                result.insert(result.end(), nested.begin(), nested.end());
+            } else {
+                result.push_back(std::move(child));
+            }
+        }
+        return result;
+    }
+
+    template <class Expression>
+    FilterExpression finish(Expression expression, FilterExpression identity) const {
+        if (expression.expressions.empty()) {
+            return identity;
+        } else if (expression.expressions.size() == 1) {
+            return expression.expressions.front();
+        }
+        sortByCost(expression.expressions);
+        return expression;
+    }
+};
+
+}
+
+FilterExpression optimizeFilterExpression(const FilterExpression& expression) {
+    return mapbox::util::apply_visitor(FilterOptimizer(), expression);
+}
+
+bool isFalseFilter(const FilterExpression& expression) {
+    return isFalse(expression);
+}
+
 }
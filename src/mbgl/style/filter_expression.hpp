@@ -7,6 +7,8 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -27,6 +29,33 @@ typedef mapbox::util::variant<
 
 FilterExpression parseFilterExpression(const rapidjson::Value&);
 
+// Returns an equivalent filter that is cheaper to evaluate: constant subexpressions are folded,
+// nested compound expressions are flattened, the children of compound expressions are ordered
+// by their estimated cost, and large "in" and "!in" lists are converted to hashed sets.
+FilterExpression optimizeFilterExpression(const FilterExpression&);
+
+// Returns true when the filter has been folded to a constant and doesn't match any features.
+bool isFalseFilter(const FilterExpression&);
+
+// A property key referenced by a filter. Filters can be compiled against the key table of a
+// particular layer, which resolves the key to an index so that evaluating the filter doesn't
+// need to compare strings.
+struct FilterKey {
+    enum : int32_t {
+        Unresolved = -1, // Look up the value by name.
+        Missing = -2,    // The layer doesn't contain this key.
+        Type = -3,       // The special "$type" key.
+    };
+
+    FilterKey() = default;
+    FilterKey(std::string name_) : name(std::move(name_)) {}
+
+    operator const std::string&() const { return name; }
+
+    std::string name;
+    int32_t index = Unresolved;
+};
+
 template <class Extractor>
 bool evaluate(const FilterExpression&, const Extractor&);
 
@@ -36,7 +65,7 @@ struct NullExpression {
 };
 
 struct EqualsExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
@@ -44,7 +73,7 @@ struct EqualsExpression {
 };
 
 struct NotEqualsExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
@@ -52,7 +81,7 @@ struct NotEqualsExpression {
 };
 
 struct LessThanExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
@@ -60,7 +89,7 @@ struct LessThanExpression {
 };
 
 struct LessThanEqualsExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
@@ -68,7 +97,7 @@ struct LessThanEqualsExpression {
 };
 
 struct GreaterThanExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
@@ -76,24 +105,45 @@ struct GreaterThanExpression {
 };
 
 struct GreaterThanEqualsExpression {
-    std::string key;
+    FilterKey key;
     Value value;
 
     template <class Extractor>
     bool evaluate(const Extractor&) const;
 };
 
+// Hashed lookup table for the values of large "in" and "!in" filters. Lookups yield the same
+// result as comparing against every value with util::relaxed_equal.
+class FilterValueSet {
+public:
+    explicit FilterValueSet(const std::vector<Value>&);
+
+    bool contains(const Value&) const;
+
+private:
+    std::vector<Value> values;
+    std::unordered_set<std::string> strings;
+    std::unordered_set<double> numbers;
+    bool hasTrue = false;
+    bool hasFalse = false;
+
+    // Integers that can't be represented exactly as a double are compared one by one.
+    std::vector<Value> inexact;
+};
+
 struct InExpression {
-    std::string key;
+    FilterKey key;
     std::vector<Value> values;
+    std::shared_ptr<const FilterValueSet> set;
 
     template <class Extractor>
     bool evaluate(const Extractor&) const;
 };
 
 struct NotInExpression {
-    std::string key;
+    FilterKey key;
     std::vector<Value> values;
+    std::shared_ptr<const FilterValueSet> set;
 
     template <class Extractor>
     bool evaluate(const Extractor&) const;
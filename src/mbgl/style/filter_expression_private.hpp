@@ -62,6 +62,8 @@ bool InExpression::evaluate(const Extractor& extractor) const {
     mapbox::util::optional<Value> actual = extractor.getValue(key);
     if (!actual)
         return false;
+    if (set)
+        return set->contains(*actual);
     for (const auto& v: values) {
         if (util::relaxed_equal(*actual, v)) {
             return true;
@@ -75,6 +77,8 @@ bool NotInExpression::evaluate(const Extractor& extractor) const {
     mapbox::util::optional<Value> actual = extractor.getValue(key);
     if (!actual)
         return true;
+    if (set)
+        return !set->contains(*actual);
     for (const auto& v: values) {
         if (util::relaxed_equal(*actual, v)) {
             return false;
@@ -11,6 +11,7 @@
 #include <mbgl/geometry/glyph_atlas.hpp>
 #include <mbgl/geometry/sprite_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/platform/log.hpp>
 #include <csscolorparser/csscolorparser.hpp>
@@ -26,6 +27,7 @@ Style::Style(MapData& data_)
     : data(data_),
       glyphStore(std::make_unique<GlyphStore>()),
       glyphAtlas(std::make_unique<GlyphAtlas>(1024, 1024)),
+      shapingCache(std::make_unique<ShapingCache>()),
       spriteStore(std::make_unique<SpriteStore>()),
       spriteAtlas(std::make_unique<SpriteAtlas>(512, 512, data.pixelRatio, *spriteStore)),
       lineAtlas(std::make_unique<LineAtlas>(512, 512)),
@@ -72,6 +74,8 @@ Style::~Style() {
 }
 
 void Style::addSource(std::unique_ptr<Source> source) {
+    source->setCacheMaxBytes(sourceCacheBytes);
+    source->setParentPrefetchLevels(sourceParentPrefetchLevels);
     source->setObserver(this);
     source->load();
     sources.emplace_back(std::move(source));
@@ -119,6 +123,14 @@ void Style::update(const TransformState& transform,
     }
 }
 
+void Style::prefetch(const std::vector<TransformState>& states, TexturePool& texturePool) {
+    for (const auto& source : sources) {
+        if (source->enabled) {
+            source->prefetch(data, states, *this, texturePool);
+        }
+    }
+}
+
 void Style::cascade() {
     for (const auto& layer : layers) {
         layer->cascade(data.getClasses(),
@@ -21,10 +21,12 @@ namespace mbgl {
 
 class GlyphAtlas;
 class GlyphStore;
+class ShapingCache;
 class SpriteStore;
 class SpriteAtlas;
 class LineAtlas;
 class StyleLayer;
+class BucketCache;
 
 class Style : public GlyphStore::Observer,
               public Source::Observer,
@@ -52,6 +54,9 @@ public:
     // a tile is ready so observers can render the tile.
     void update(const TransformState&, TexturePool&);
 
+    // Loads the tiles that future states will need, at a lower priority than the current ones.
+    void prefetch(const std::vector<TransformState>&, TexturePool&);
+
     void cascade();
     void recalculate(float z);
 
@@ -72,11 +77,21 @@ public:
     MapData& data;
     std::unique_ptr<GlyphStore> glyphStore;
     std::unique_ptr<GlyphAtlas> glyphAtlas;
+    std::unique_ptr<ShapingCache> shapingCache;
     util::ptr<Sprite> sprite;
     std::unique_ptr<SpriteStore> spriteStore;
     std::unique_ptr<SpriteAtlas> spriteAtlas;
     std::unique_ptr<LineAtlas> lineAtlas;
 
+    // Used by the workers of tiles that are created afterwards; may be null.
+    std::shared_ptr<BucketCache> bucketCache;
+
+    // Memory limit of the tile cache of sources that are added afterwards.
+    size_t sourceCacheBytes = TileCache::defaultMaxBytes;
+
+    // Ancestor levels that sources which are added afterwards keep loaded.
+    std::vector<int32_t> sourceParentPrefetchLevels;
+
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<util::ptr<StyleLayer>> layers;
 
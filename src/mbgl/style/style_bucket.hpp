@@ -25,6 +25,10 @@ public:
     float min_zoom = -std::numeric_limits<float>::infinity();
     float max_zoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
+
+    // Identifies everything that affects how the bucket is parsed from a tile. Parsed buckets are
+    // only restored from the BucketCache when it is unchanged; buckets without a key aren't cached.
+    std::string cacheKey;
 };
 
 };
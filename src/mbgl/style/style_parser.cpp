@@ -7,6 +7,9 @@
 #include <mbgl/platform/log.hpp>
 #include <csscolorparser/csscolorparser.hpp>
 
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
@@ -20,6 +23,17 @@ namespace mbgl {
 
 using JSVal = const rapidjson::Value&;
 
+namespace {
+
+std::string stringify(JSVal value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+} // namespace
+
 void StyleParser::parse(JSVal document) {
     if (document.HasMember("version")) {
         version = document["version"].GetInt();
@@ -768,13 +782,18 @@ void StyleParser::parseLayer(const std::string& id, JSVal value, util::ptr<Style
         }
 
         if (value.HasMember("filter")) {
-            bucket->filter = parseFilterExpression(value["filter"]);
+            bucket->filter = optimizeFilterExpression(parseFilterExpression(value["filter"]));
         }
 
         if (value.HasMember("layout")) {
             parseLayout(value["layout"], bucket);
         }
 
+        // The zoom range and visibility only decide whether the bucket is parsed at all.
+        bucket->cacheKey = type + '\n' + bucket->source_layer + '\n' +
+            (value.HasMember("filter") ? stringify(value["filter"]) : "") + '\n' +
+            (value.HasMember("layout") ? stringify(value["layout"]) : "");
+
         if (value.HasMember("minzoom")) {
             JSVal min_zoom = value["minzoom"];
             if (min_zoom.IsNumber()) {
@@ -1,11 +1,28 @@
 #include <mbgl/text/collision_tile.hpp>
+
+#include <algorithm>
 #include <cmath>
 
 namespace mbgl {
 
-CollisionTile::CollisionTile(PlacementConfig config_) : config(config_) {
-    tree.clear();
+namespace {
+
+// Tile coordinates of the area the grid covers; labels in the buffer of a tile lie outside of
+// the 4096 unit extent.
+const float gridMin = -2048;
+const float gridMax = 6144;
+
+int32_t cellIndex(float value, float origin, float scale, int32_t size) {
+    const float cell = (value - origin) * scale;
+    if (!(cell >= 0)) {
+        return 0;
+    }
+    return cell >= size ? size - 1 : int32_t(cell);
+}
 
+} // namespace
+
+CollisionTile::CollisionTile(PlacementConfig config_) : config(config_) {
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -17,6 +34,32 @@ CollisionTile::CollisionTile(PlacementConfig config_) : config(config_) {
     // The amount the map is squished depends on the y position.
     // Sort of account for this by making all boxes a bit bigger.
     yStretch = std::pow(_yStretch, 1.3);
+
+    // Fit the grid to the rotated tile area.
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (const auto& corner : { vec2<float>(gridMin, gridMin), vec2<float>(gridMax, gridMin),
+                                vec2<float>(gridMin, gridMax), vec2<float>(gridMax, gridMax) }) {
+        const auto rotated = corner.matMul(rotationMatrix);
+        minX = std::min(minX, rotated.x);
+        minY = std::min(minY, rotated.y);
+        maxX = std::max(maxX, rotated.x);
+        maxY = std::max(maxY, rotated.y);
+    }
+    gridX = minX;
+    gridY = minY;
+    cellScaleX = gridSize / (maxX - minX);
+    cellScaleY = gridSize / (maxY - minY);
+
+    cells.assign(gridSize * gridSize, -1);
+}
+
+CollisionTile::CellRange CollisionTile::getCells(float x1, float y1, float x2, float y2) const {
+    return {
+        cellIndex(x1, gridX, cellScaleX, gridSize),
+        cellIndex(y1, gridY, cellScaleY, gridSize),
+        cellIndex(x2, gridX, cellScaleX, gridSize),
+        cellIndex(y2, gridY, cellScaleY, gridSize)
+    };
 }
 
 float CollisionTile::placeFeature(const CollisionFeature &feature) {
@@ -26,47 +69,77 @@ float CollisionTile::placeFeature(const CollisionFeature &feature) {
     for (auto& box : feature.boxes) {
         const auto anchor = box.anchor.matMul(rotationMatrix);
 
-        std::vector<CollisionTreeBox> blockingBoxes;
-        tree.query(bgi::intersects(getTreeBox(anchor, box)), std::back_inserter(blockingBoxes));
-
-        for (auto& blockingTreeBox : blockingBoxes) {
-            const auto& blocking = std::get<1>(blockingTreeBox);
-            auto blockingAnchor = blocking.anchor.matMul(rotationMatrix);
+        const float x1 = anchor.x + box.x1;
+        const float y1 = anchor.y + box.y1 * yStretch;
+        const float x2 = anchor.x + box.x2;
+        const float y2 = anchor.y + box.y2 * yStretch;
 
-            // Find the lowest scale at which the two boxes can fit side by side without overlapping.
-            // Original algorithm:
-            float s1 = (blocking.x1 - box.x2) / (anchor.x - blockingAnchor.x); // scale at which new box is to the left of old box
-            float s2 = (blocking.x2 - box.x1) / (anchor.x - blockingAnchor.x); // scale at which new box is to the right of old box
-            float s3 = (blocking.y1 - box.y2) * yStretch / (anchor.y - blockingAnchor.y); // scale at which new box is to the top of old box
-            float s4 = (blocking.y2 - box.y1) * yStretch / (anchor.y - blockingAnchor.y); // scale at which new box is to the bottom of old box
-
-            if (std::isnan(s1) || std::isnan(s2)) s1 = s2 = 1;
-            if (std::isnan(s3) || std::isnan(s4)) s3 = s4 = 1;
-
-            float collisionFreeScale = ::fmin(::fmax(s1, s2), ::fmax(s3, s4));
-
-            if (collisionFreeScale > blocking.maxScale) {
-                // After a box's maxScale the label has shrunk enough that the box is no longer needed to cover it,
-                // so unblock the new box at the scale that the old box disappears.
-                collisionFreeScale = blocking.maxScale;
-            }
-
-            if (collisionFreeScale > box.maxScale) {
-                // If the box can only be shown after it is visible, then the box can never be shown.
-                // But the label can be shown after this box is not visible.
-                collisionFreeScale = box.maxScale;
-            }
-
-            if (collisionFreeScale > minPlacementScale &&
-                    collisionFreeScale >= blocking.placementScale) {
-                // If this collision occurs at a lower scale than previously found collisions
-                // and the collision occurs while the other label is visible
+        if (++query == 0) {
+            // The counter wrapped around; forget which boxes were visited.
+            std::fill(visited.begin(), visited.end(), 0);
+            query = 1;
+        }
 
-                // this this is the lowest scale at which the label won't collide with anything
-                minPlacementScale = collisionFreeScale;
+        const CellRange range = getCells(x1, y1, x2, y2);
+        for (int32_t cy = range.y1; cy <= range.y2; cy++) {
+            for (int32_t cx = range.x1; cx <= range.x2; cx++) {
+                for (int32_t entry = cells[cy * gridSize + cx]; entry != -1; entry = entryNext[entry]) {
+                    const uint32_t i = entryBoxes[entry];
+                    if (visited[i] == query) {
+                        continue;
+                    }
+                    visited[i] = query;
+
+                    const float blockingAnchorX = anchorX[i];
+                    const float blockingAnchorY = anchorY[i];
+                    const float blockingX1 = boxX1[i];
+                    const float blockingY1 = boxY1[i];
+                    const float blockingX2 = boxX2[i];
+                    const float blockingY2 = boxY2[i];
+
+                    // Boxes that touch count as intersecting.
+                    if (blockingAnchorX + blockingX1 > x2 || blockingAnchorX + blockingX2 < x1 ||
+                        blockingAnchorY + blockingY1 * yStretch > y2 ||
+                        blockingAnchorY + blockingY2 * yStretch < y1) {
+                        continue;
+                    }
+
+                    // Find the lowest scale at which the two boxes can fit side by side without overlapping.
+                    // Original algorithm:
+                    float s1 = (blockingX1 - box.x2) / (anchor.x - blockingAnchorX); // scale at which new box is to the left of old box
+                    float s2 = (blockingX2 - box.x1) / (anchor.x - blockingAnchorX); // scale at which new box is to the right of old box
+                    float s3 = (blockingY1 - box.y2) * yStretch / (anchor.y - blockingAnchorY); // scale at which new box is to the top of old box
+                    float s4 = (blockingY2 - box.y1) * yStretch / (anchor.y - blockingAnchorY); // scale at which new box is to the bottom of old box
+
+                    if (std::isnan(s1) || std::isnan(s2)) s1 = s2 = 1;
+                    if (std::isnan(s3) || std::isnan(s4)) s3 = s4 = 1;
+
+                    float collisionFreeScale = ::fmin(::fmax(s1, s2), ::fmax(s3, s4));
+
+                    if (collisionFreeScale > boxMaxScale[i]) {
+                        // After a box's maxScale the label has shrunk enough that the box is no longer needed to cover it,
+                        // so unblock the new box at the scale that the old box disappears.
+                        collisionFreeScale = boxMaxScale[i];
+                    }
+
+                    if (collisionFreeScale > box.maxScale) {
+                        // If the box can only be shown after it is visible, then the box can never be shown.
+                        // But the label can be shown after this box is not visible.
+                        collisionFreeScale = box.maxScale;
+                    }
+
+                    if (collisionFreeScale > minPlacementScale &&
+                            collisionFreeScale >= boxPlacementScale[i]) {
+                        // If this collision occurs at a lower scale than previously found collisions
+                        // and the collision occurs while the other label is visible
+
+                        // this this is the lowest scale at which the label won't collide with anything
+                        minPlacementScale = collisionFreeScale;
+                    }
+
+                    if (minPlacementScale >= maxScale) return minPlacementScale;
+                }
             }
-
-            if (minPlacementScale >= maxScale) return minPlacementScale;
         }
     }
 
@@ -79,26 +152,33 @@ void CollisionTile::insertFeature(CollisionFeature &feature, const float minPlac
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
         for (auto& box : feature.boxes) {
-            treeBoxes.emplace_back(getTreeBox(box.anchor.matMul(rotationMatrix), box), box);
+            const auto anchor = box.anchor.matMul(rotationMatrix);
+            const uint32_t i = anchorX.size();
+
+            anchorX.push_back(anchor.x);
+            anchorY.push_back(anchor.y);
+            boxX1.push_back(box.x1);
+            boxY1.push_back(box.y1);
+            boxX2.push_back(box.x2);
+            boxY2.push_back(box.y2);
+            boxMaxScale.push_back(box.maxScale);
+            boxPlacementScale.push_back(box.placementScale);
+            visited.push_back(0);
+
+            const CellRange range = getCells(anchor.x + box.x1, anchor.y + box.y1 * yStretch,
+                                             anchor.x + box.x2, anchor.y + box.y2 * yStretch);
+            for (int32_t cy = range.y1; cy <= range.y2; cy++) {
+                for (int32_t cx = range.x1; cx <= range.x2; cx++) {
+                    int32_t& cell = cells[cy * gridSize + cx];
+                    entryBoxes.push_back(i);
+                    entryNext.push_back(cell);
+                    cell = int32_t(entryBoxes.size()) - 1;
+                }
+            }
         }
-        tree.insert(treeBoxes.begin(), treeBoxes.end());
     }
 
 }
 
-Box CollisionTile::getTreeBox(const vec2<float> &anchor, const CollisionBox &box) {
-    return Box{
-        CollisionPoint{
-            anchor.x + box.x1,
-            anchor.y + box.y1 * yStretch
-        },
-        CollisionPoint{
-            anchor.x + box.x2,
-            anchor.y + box.y2 * yStretch
-        }
-    };
-}
-
 }
@@ -4,35 +4,12 @@
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/text/placement_config.hpp>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-function"
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#pragma GCC diagnostic ignored "-Wunused-variable"
-#pragma GCC diagnostic ignored "-Wshadow"
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wunknown-pragmas"
-#endif
-#pragma GCC diagnostic ignored "-Wpragmas"
-#pragma GCC diagnostic ignored "-Wdeprecated-register"
-#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
-#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point.hpp>
-#include <boost/geometry/geometries/box.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#pragma GCC diagnostic pop
+#include <array>
+#include <cstdint>
+#include <vector>
 
 namespace mbgl {
 
-namespace bg = boost::geometry;
-namespace bgm = bg::model;
-namespace bgi = bg::index;
-typedef bgm::point<float, 2, bg::cs::cartesian> CollisionPoint;
-typedef bgm::box<CollisionPoint> Box;
-typedef std::pair<Box, CollisionBox> CollisionTreeBox;
-typedef bgi::rtree<CollisionTreeBox, bgi::linear<16, 4>> Tree;
-
 class CollisionTile {
 public:
     explicit CollisionTile(PlacementConfig);
@@ -47,10 +24,45 @@ public:
     float yStretch;
 
 private:
-    Box getTreeBox(const vec2<float>& anchor, const CollisionBox& box);
+    // Inserted boxes are found through a fixed grid of cells that covers the tile and its buffer,
+    // rotated by the placement angle. Boxes outside of the grid are put in the border cells, so
+    // every box is found no matter where it is. Each cell holds a linked list of entries in a flat
+    // array, so that neither inserts nor queries allocate once the arrays have grown.
+    static const int32_t gridSize = 64;
+
+    struct CellRange {
+        int32_t x1, y1, x2, y2;
+    };
+
+    CellRange getCells(float x1, float y1, float x2, float y2) const;
 
-    Tree tree;
     std::array<float, 4> rotationMatrix;
+
+    float gridX;
+    float gridY;
+    float cellScaleX;
+    float cellScaleY;
+
+    // The first entry of each cell, or -1.
+    std::vector<int32_t> cells;
+
+    // The box of each entry and the next entry in the same cell, or -1.
+    std::vector<uint32_t> entryBoxes;
+    std::vector<int32_t> entryNext;
+
+    // Fields of the inserted boxes, one element per box. Anchors are rotated.
+    std::vector<float> anchorX;
+    std::vector<float> anchorY;
+    std::vector<float> boxX1;
+    std::vector<float> boxY1;
+    std::vector<float> boxX2;
+    std::vector<float> boxY2;
+    std::vector<float> boxMaxScale;
+    std::vector<float> boxPlacementScale;
+
+    // The last query that visited each box, so that boxes in several cells are checked once.
+    std::vector<uint32_t> visited;
+    uint32_t query = 0;
 };
 
 } // namespace mbgl
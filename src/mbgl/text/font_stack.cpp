@@ -1,21 +1,57 @@
 #include <mbgl/text/font_stack.hpp>
 #include <cassert>
+#include <algorithm>
 #include <mbgl/util/math.hpp>
 
 namespace mbgl {
 
+namespace {
+
+std::size_t rangeIndex(uint32_t id) {
+    return getGlyphRange(id).first / 256;
+}
+
+} // namespace
+
 void FontStack::insert(uint32_t id, const SDFGlyph &glyph) {
-    metrics.emplace(id, glyph.metrics);
-    bitmaps.emplace(id, glyph.bitmap);
-    sdfs.emplace(id, glyph);
+    const std::size_t index = rangeIndex(id);
+    if (index >= glyphs.size()) {
+        glyphs.resize(index + 1);
+    }
+
+    auto& range = glyphs[index];
+    if (!range) {
+        range = std::make_shared<Glyphs>();
+    } else if (range.use_count() > 1) {
+        // Another snapshot uses these glyphs.
+        range = std::make_shared<Glyphs>(*range);
+    }
+
+    range->emplace(id, glyph);
+}
+
+const SDFGlyph* FontStack::getGlyph(uint32_t id) const {
+    const std::size_t index = rangeIndex(id);
+    if (index >= glyphs.size() || !glyphs[index]) {
+        return nullptr;
+    }
+
+    auto it = glyphs[index]->find(id);
+    return it != glyphs[index]->end() ? &it->second : nullptr;
+}
+
+bool FontStack::empty() const {
+    return std::none_of(glyphs.begin(), glyphs.end(), [] (const std::shared_ptr<Glyphs>& range) {
+        return range && !range->empty();
+    });
 }
 
-const std::map<uint32_t, GlyphMetrics> &FontStack::getMetrics() const {
-    return metrics;
+void FontStack::addRange(const GlyphRange& range) {
+    ranges.set(rangeIndex(range.first));
 }
 
-const std::map<uint32_t, SDFGlyph> &FontStack::getSDFs() const {
-    return sdfs;
+bool FontStack::hasRange(const GlyphRange& range) const {
+    return ranges.test(rangeIndex(range.first));
 }
 
 const Shaping FontStack::getShaping(const std::u32string &string, const float maxWidth,
@@ -32,10 +68,10 @@ const Shaping FontStack::getShaping(const std::u32string &string, const float ma
 
     // Loop through all characters of this label and shape.
     for (uint32_t chr : string) {
-        auto metric = metrics.find(chr);
-        if (metric != metrics.end()) {
+        const SDFGlyph* glyph = getGlyph(chr);
+        if (glyph) {
             shaping.positionedGlyphs.emplace_back(chr, x, y);
-            x += metric->second.advance + spacing;
+            x += glyph->metrics.advance + spacing;
         }
     }
 
@@ -59,12 +95,12 @@ void align(Shaping &shaping, const float justify, const float horizontalAlign,
     }
 }
 
-void justifyLine(std::vector<PositionedGlyph> &positionedGlyphs, const std::map<uint32_t, GlyphMetrics> &metrics, uint32_t start,
+void justifyLine(std::vector<PositionedGlyph> &positionedGlyphs, const FontStack &fontStack, uint32_t start,
                  uint32_t end, float justify) {
     PositionedGlyph &glyph = positionedGlyphs[end];
-    auto metric = metrics.find(glyph.glyph);
-    if (metric != metrics.end()) {
-        const uint32_t lastAdvance = metric->second.advance;
+    const SDFGlyph* sdf = fontStack.getGlyph(glyph.glyph);
+    if (sdf) {
+        const uint32_t lastAdvance = sdf->metrics.advance;
         const float lineIndent = float(glyph.x + lastAdvance) * justify;
 
         for (uint32_t j = start; j <= end; j++) {
@@ -112,7 +148,7 @@ void FontStack::lineWrap(Shaping &shaping, const float lineHeight, const float m
                         lineEnd--;
                     }
 
-                    justifyLine(positionedGlyphs, metrics, lineStartIndex, lineEnd, justify);
+                    justifyLine(positionedGlyphs, *this, lineStartIndex, lineEnd, justify);
                 }
 
                 lineStartIndex = lastSafeBreak + 1;
@@ -138,14 +174,14 @@ void FontStack::lineWrap(Shaping &shaping, const float lineHeight, const float m
     }
 
     const PositionedGlyph& lastPositionedGlyph = positionedGlyphs.back();
-    const auto lastGlyphMetric = metrics.find(lastPositionedGlyph.glyph);
-    assert(lastGlyphMetric != metrics.end());
-    const uint32_t lastLineLength = lastPositionedGlyph.x + lastGlyphMetric->second.advance;
+    const SDFGlyph* lastGlyph = getGlyph(lastPositionedGlyph.glyph);
+    assert(lastGlyph);
+    const uint32_t lastLineLength = lastPositionedGlyph.x + lastGlyph->metrics.advance;
     maxLineLength = std::max(maxLineLength, lastLineLength);
 
     const uint32_t height = (line + 1) * lineHeight;
 
-    justifyLine(positionedGlyphs, metrics, lineStartIndex, uint32_t(positionedGlyphs.size()) - 1, justify);
+    justifyLine(positionedGlyphs, *this, lineStartIndex, uint32_t(positionedGlyphs.size()) - 1, justify);
     align(shaping, justify, horizontalAlign, verticalAlign, maxLineLength, lineHeight, line);
 
     // Calculate the bounding box
@@ -4,13 +4,27 @@
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/util/vec.hpp>
 
+#include <bitset>
+#include <memory>
+
 namespace mbgl {
 
+// The glyphs of a font stack, grouped by glyph range. Copies share the glyphs of each range until
+// either copy inserts into it, so that the GlyphStore can cheaply publish a new snapshot whenever
+// a range is loaded. Copying and inserting isn't thread-safe, but a snapshot that is no longer
+// modified can be read from any number of threads.
 class FontStack {
 public:
     void insert(uint32_t id, const SDFGlyph &glyph);
-    const std::map<uint32_t, GlyphMetrics> &getMetrics() const;
-    const std::map<uint32_t, SDFGlyph> &getSDFs() const;
+
+    // Returns nullptr if the font stack doesn't contain the glyph.
+    const SDFGlyph* getGlyph(uint32_t id) const;
+    bool empty() const;
+
+    // Ranges are added once all of their glyphs were inserted.
+    void addRange(const GlyphRange&);
+    bool hasRange(const GlyphRange&) const;
+
     const Shaping getShaping(const std::u32string &string, float maxWidth, float lineHeight,
                              float horizontalAlign, float verticalAlign, float justify,
                              float spacing, const vec2<float> &translate) const;
@@ -18,9 +32,13 @@ public:
                   float verticalAlign, float justify) const;
 
 private:
-    std::map<uint32_t, std::string> bitmaps;
-    std::map<uint32_t, GlyphMetrics> metrics;
-    std::map<uint32_t, SDFGlyph> sdfs;
+    static const std::size_t rangeCount = 256;
+
+    using Glyphs = std::map<uint32_t, SDFGlyph>;
+
+    // Indexed by the first glyph of the range divided by 256.
+    std::vector<std::shared_ptr<Glyphs>> glyphs;
+    std::bitset<rangeCount> ranges;
 };
 
 } // end namespace mbgl
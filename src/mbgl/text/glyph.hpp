@@ -32,8 +32,9 @@ struct GlyphMetrics {
 struct Glyph {
     inline explicit Glyph() : rect(0, 0, 0, 0), metrics() {}
     inline explicit Glyph(const Rect<uint16_t> &rect_,
-                          const GlyphMetrics &metrics_)
-        : rect(rect_), metrics(metrics_) {}
+                          const GlyphMetrics &metrics_,
+                          uint16_t page_ = 0)
+        : rect(rect_), metrics(metrics_), page(page_) {}
 
     operator bool() const {
         return metrics || rect.hasArea();
@@ -41,6 +42,9 @@ struct Glyph {
 
     const Rect<uint16_t> rect;
     const GlyphMetrics metrics;
+
+    // Glyph atlas page that holds the bitmap.
+    const uint16_t page = 0;
 };
 
 typedef std::map<uint32_t, Glyph> GlyphPositions;
@@ -74,7 +74,7 @@ GlyphPBF::GlyphPBF(GlyphStore* store,
         return "";
     });
 
-    auto requestCallback = [this, store, fontStack, url](const Response &res) {
+    auto requestCallback = [this, store, fontStack, glyphRange, url](const Response &res) {
         if (res.stale) {
             // Only handle fresh responses.
             return;
@@ -87,7 +87,7 @@ GlyphPBF::GlyphPBF(GlyphStore* store,
             emitGlyphPBFLoadingFailed(message.str());
         } else {
             data = res.data;
-            parse(store, fontStack, url);
+            parse(store, fontStack, glyphRange, url);
         }
     };
 
@@ -97,7 +97,8 @@ GlyphPBF::GlyphPBF(GlyphStore* store,
 
 GlyphPBF::~GlyphPBF() = default;
 
-void GlyphPBF::parse(GlyphStore* store, const std::string& fontStack, const std::string& url) {
+void GlyphPBF::parse(GlyphStore* store, const std::string& fontStack,
+                     const GlyphRange& glyphRange, const std::string& url) {
     assert(data);
     if (data->empty()) {
         // If there is no data, this means we either haven't
@@ -105,8 +106,11 @@ void GlyphPBF::parse(GlyphStore* store, const std::string& fontStack, const std:
         return;
     }
 
+    // Parse into a copy of the current snapshot, which shares the glyphs of the other ranges.
+    FontStack snapshot = store->getFontStack(fontStack);
+
     try {
-        parseGlyphPBF(**store->getFontStack(fontStack), *data);
+        parseGlyphPBF(snapshot, *data);
     } catch (const std::exception& ex) {
         std::stringstream message;
         message <<  "Failed to parse [" << url << "]: " << ex.what();
@@ -114,6 +118,9 @@ void GlyphPBF::parse(GlyphStore* store, const std::string& fontStack, const std:
         return;
     }
 
+    snapshot.addRange(glyphRange);
+    store->setFontStack(fontStack, std::move(snapshot));
+
     parsed = true;
 
     emitGlyphPBFLoaded();
@@ -40,7 +40,8 @@ private:
     void emitGlyphPBFLoaded();
     void emitGlyphPBFLoadingFailed(const std::string& message);
 
-    void parse(GlyphStore* store, const std::string& fontStack, const std::string& url);
+    void parse(GlyphStore* store, const std::string& fontStack,
+               const GlyphRange& glyphRange, const std::string& url);
 
     std::shared_ptr<const std::string> data;
     std::atomic<bool> parsed;
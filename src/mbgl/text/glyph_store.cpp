@@ -5,11 +5,55 @@
 
 namespace mbgl {
 
+GlyphStore::Stack::Stack()
+    : current(nullptr) {
+    for (auto& bits : requested) {
+        bits = 0;
+    }
+
+    snapshots.emplace_back(std::make_unique<FontStack>());
+    current = snapshots.back().get();
+}
+
+GlyphStore::GlyphStore()
+    : stacks(nullptr) {
+    stackMaps.emplace_back(std::make_unique<Stacks>());
+    stacks = stackMaps.back().get();
+}
+
+GlyphStore::~GlyphStore() = default;
+
+GlyphStore::Stack& GlyphStore::getStack(const std::string& fontStack) {
+    const Stacks* current = stacks.load(std::memory_order_acquire);
+    auto it = current->find(fontStack);
+    if (it != current->end()) {
+        return *it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(stacksMutex);
+
+    // Another thread may have added the font stack in the meantime.
+    current = stacks.load(std::memory_order_acquire);
+    it = current->find(fontStack);
+    if (it != current->end()) {
+        return *it->second;
+    }
+
+    stackEntries.emplace_back(std::make_unique<Stack>());
+    Stack* stack = stackEntries.back().get();
+
+    auto next = std::make_unique<Stacks>(*current);
+    next->emplace(fontStack, stack);
+    stacks.store(next.get(), std::memory_order_release);
+    stackMaps.emplace_back(std::move(next));
+
+    return *stack;
+}
+
 void GlyphStore::requestGlyphRange(const std::string& fontStackName, const GlyphRange& range) {
     assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
 
-    std::lock_guard<std::mutex> lock(rangesMutex);
-    auto& rangeSets = ranges[fontStackName];
+    auto& rangeSets = getStack(fontStackName).ranges;
 
     const auto& rangeSetsIt = rangeSets.find(range);
     if (rangeSetsIt != rangeSets.end()) {
@@ -28,40 +72,39 @@ bool GlyphStore::hasGlyphRanges(const std::string& fontStackName, const std::set
         return true;
     }
 
-    std::lock_guard<std::mutex> lock(rangesMutex);
-    const auto& rangeSets = ranges[fontStackName];
+    Stack& stack = getStack(fontStackName);
+    const FontStack& fontStack = *stack.current.load(std::memory_order_acquire);
 
     bool hasRanges = true;
     for (const auto& range : glyphRanges) {
-        const auto& rangeSetsIt = rangeSets.find(range);
-        if (rangeSetsIt == rangeSets.end()) {
-            // Push the request to the MapThread, so we can easly cancel
-            // if it is still pending when we destroy this object.
-            workQueue.push(std::bind(&GlyphStore::requestGlyphRange, this, fontStackName, range));
-
-            hasRanges = false;
+        if (fontStack.hasRange(range)) {
             continue;
         }
 
-        if (!rangeSetsIt->second->isParsed()) {
-            hasRanges = false;
+        hasRanges = false;
+
+        const std::size_t index = range.first / 256;
+        const uint64_t bit = uint64_t(1) << (index % 64);
+        if (!(stack.requested[index / 64].fetch_or(bit) & bit)) {
+            // Push the request to the MapThread, so we can easly cancel
+            // if it is still pending when we destroy this object.
+            workQueue.push(std::bind(&GlyphStore::requestGlyphRange, this, fontStackName, range));
         }
     }
 
     return hasRanges;
 }
 
-util::exclusive<FontStack> GlyphStore::getFontStack(const std::string& fontStack) {
-    auto lock = std::make_unique<std::lock_guard<std::mutex>>(stacksMutex);
+const FontStack& GlyphStore::getFontStack(const std::string& fontStack) {
+    return *getStack(fontStack).current.load(std::memory_order_acquire);
+}
 
-    auto it = stacks.find(fontStack);
-    if (it == stacks.end()) {
-        it = stacks.emplace(fontStack, std::make_unique<FontStack>()).first;
-    }
+void GlyphStore::setFontStack(const std::string& fontStack, FontStack snapshot) {
+    assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
 
-    // FIXME: We lock all FontStacks, but what we should
-    // really do is lock only the one we are returning.
-    return { it->second.get(), std::move(lock) };
+    Stack& stack = getStack(fontStack);
+    stack.snapshots.emplace_back(std::make_unique<FontStack>(std::move(snapshot)));
+    stack.current.store(stack.snapshots.back().get(), std::memory_order_release);
 }
 
 void GlyphStore::onGlyphPBFLoaded() {
@@ -4,21 +4,28 @@
 #include <mbgl/text/font_stack.hpp>
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
-#include <mbgl/util/exclusive.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/work_queue.hpp>
 
+#include <array>
+#include <atomic>
 #include <exception>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
 // The GlyphStore manages the loading and storage of Glyphs
 // and creation of FontStack objects. The GlyphStore lives
 // on the MapThread but can be queried from any thread.
+//
+// Every time a glyph range is loaded, a new immutable snapshot of its
+// FontStack is published. Readers don't take a lock: they get the
+// latest snapshot, which stays valid for the lifetime of the GlyphStore.
 class GlyphStore : public GlyphPBF::Observer, private util::noncopyable {
 public:
     class Observer {
@@ -29,10 +36,16 @@ public:
         virtual void onGlyphRangeLoadingFailed(std::exception_ptr error) = 0;
     };
 
-    GlyphStore() = default;
-    virtual ~GlyphStore() = default;
+    GlyphStore();
+    virtual ~GlyphStore();
 
-    util::exclusive<FontStack> getFontStack(const std::string& fontStack);
+    // Returns the latest snapshot of the font stack. This method can
+    // be called from any thread.
+    const FontStack& getFontStack(const std::string& fontStack);
+
+    // Publishes a new snapshot of the font stack. Must be called on
+    // the MapThread.
+    void setFontStack(const std::string& fontStack, FontStack snapshot);
 
     // Returns true if the set of GlyphRanges are available and parsed or false
     // if they are not. For the missing ranges, a request on the FileSource is
@@ -60,10 +73,32 @@ private:
 
     std::string glyphURL;
 
-    std::unordered_map<std::string, std::map<GlyphRange, std::unique_ptr<GlyphPBF>>> ranges;
-    std::mutex rangesMutex;
+    // Everything we know about a font stack. Entries are never removed,
+    // so readers can keep using them without a lock.
+    struct Stack {
+        std::atomic<const FontStack*> current;
+
+        // One bit per glyph range that was requested. The first reader
+        // that sets the bit pushes the request to the MapThread.
+        std::array<std::atomic<uint64_t>, 4> requested;
+
+        // Published snapshots; older ones may still be in use by readers.
+        // Only accessed on the MapThread.
+        std::vector<std::unique_ptr<const FontStack>> snapshots;
+        std::map<GlyphRange, std::unique_ptr<GlyphPBF>> ranges;
+
+        Stack();
+    };
+
+    Stack& getStack(const std::string& fontStack);
 
-    std::unordered_map<std::string, std::unique_ptr<FontStack>> stacks;
+    // Lookups use the latest published map. Adding a font stack copies
+    // the map under the mutex; older maps are kept for readers that may
+    // still use them.
+    using Stacks = std::unordered_map<std::string, Stack*>;
+    std::atomic<const Stacks*> stacks;
+    std::vector<std::unique_ptr<const Stacks>> stackMaps;
+    std::vector<std::unique_ptr<Stack>> stackEntries;
     std::mutex stacksMutex;
 
     util::WorkQueue workQueue;
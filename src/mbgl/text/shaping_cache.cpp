@@ -0,0 +1,116 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/font_stack.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+const std::size_t ShapingCache::defaultSize = 8192;
+
+bool ShapingCache::Key::operator==(const Key& other) const {
+    return fontStack == other.fontStack && text == other.text && maxWidth == other.maxWidth &&
+           lineHeight == other.lineHeight && horizontalAlign == other.horizontalAlign &&
+           verticalAlign == other.verticalAlign && justify == other.justify &&
+           spacing == other.spacing && translate == other.translate;
+}
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t hash = std::hash<std::u32string>()(key.text);
+    boost::hash_combine(hash, key.fontStack);
+    boost::hash_combine(hash, key.maxWidth);
+    boost::hash_combine(hash, key.lineHeight);
+    boost::hash_combine(hash, key.horizontalAlign);
+    boost::hash_combine(hash, key.verticalAlign);
+    boost::hash_combine(hash, key.justify);
+    boost::hash_combine(hash, key.spacing);
+    boost::hash_combine(hash, key.translate.x);
+    boost::hash_combine(hash, key.translate.y);
+    return hash;
+}
+
+Duration ShapingCache::Statistics::saved() const {
+    if (misses == 0) {
+        return Duration::zero();
+    }
+    return shapingTime / misses * hits;
+}
+
+ShapingCache::Statistics& ShapingCache::Statistics::operator+=(const Statistics& other) {
+    hits += other.hits;
+    misses += other.misses;
+    shapingTime += other.shapingTime;
+    return *this;
+}
+
+ShapingCache::ShapingCache(std::size_t size_)
+    : size(size_) {
+    index.reserve(size);
+}
+
+std::shared_ptr<const Shaping> ShapingCache::get(const Key& key, const FontStack& fontStack,
+                                                 Statistics* tileStatistics) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            // Mark the entry as the most recently used one.
+            entries.splice(entries.end(), entries, it->second);
+            statistics.hits++;
+            if (tileStatistics) {
+                tileStatistics->hits++;
+            }
+            return it->second->shaping;
+        }
+    }
+
+    // Shape without holding the lock so that other workers aren't blocked. Two workers may shape
+    // the same label at the same time; the second one then uses the first one's result.
+    const TimePoint start = Clock::now();
+    auto shaping = std::make_shared<const Shaping>(fontStack.getShaping(
+        key.text, key.maxWidth, key.lineHeight, key.horizontalAlign, key.verticalAlign,
+        key.justify, key.spacing, key.translate));
+    const Duration elapsed = Clock::now() - start;
+
+    if (tileStatistics) {
+        tileStatistics->misses++;
+        tileStatistics->shapingTime += elapsed;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    statistics.misses++;
+    statistics.shapingTime += elapsed;
+
+    if (size == 0) {
+        return shaping;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        return it->second->shaping;
+    }
+
+    entries.push_back({ key, shaping });
+    index.emplace(key, std::prev(entries.end()));
+
+    if (entries.size() > size) {
+        index.erase(entries.front().key);
+        entries.pop_front();
+    }
+
+    assert(entries.size() <= size);
+    return shaping;
+}
+
+std::size_t ShapingCache::count() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries.size();
+}
+
+ShapingCache::Statistics ShapingCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return statistics;
+}
+
+} // namespace mbgl
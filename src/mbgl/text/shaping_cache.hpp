@@ -0,0 +1,90 @@
+#ifndef MBGL_TEXT_SHAPING_CACHE
+#define MBGL_TEXT_SHAPING_CACHE
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/vec.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class FontStack;
+
+// Least recently used cache of shaped labels that is shared by all tile workers, so that labels
+// that repeat across tiles, like road names, are only shaped once. Shapings are immutable once
+// they are in the cache and are handed out by reference count instead of being copied.
+//
+// A label is only shaped once all glyph ranges it needs are loaded, and loading further ranges
+// doesn't change the metrics of the glyphs it uses, so entries never have to be invalidated.
+//
+// Thread-safe; the workers use it concurrently.
+class ShapingCache : private util::noncopyable {
+public:
+    struct Key {
+        std::string fontStack;
+        std::u32string text;
+        float maxWidth;
+        float lineHeight;
+        float horizontalAlign;
+        float verticalAlign;
+        float justify;
+        float spacing;
+        vec2<float> translate;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        Duration shapingTime = Duration::zero(); // Time spent shaping the misses.
+
+        // Estimated time the hits saved, assuming each would have taken as long as an average miss.
+        Duration saved() const;
+
+        Statistics& operator+=(const Statistics&);
+    };
+
+    ShapingCache(std::size_t size = defaultSize);
+
+    // Returns the cached shaping for the key, or shapes the label with the font stack and adds it
+    // to the cache. The font stack must be the one named by the key. When `tileStatistics` is set,
+    // the lookup is also counted there, e.g. to report the hit rate of a single tile.
+    std::shared_ptr<const Shaping> get(const Key&, const FontStack&,
+                                       Statistics* tileStatistics = nullptr);
+
+    std::size_t count() const;
+    Statistics getStatistics() const;
+
+    static const std::size_t defaultSize;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const Shaping> shaping;
+    };
+
+    const std::size_t size;
+
+    // Ordered from least to most recently used.
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    Statistics statistics;
+    mutable std::mutex mtx;
+};
+
+} // namespace mbgl
+
+#endif
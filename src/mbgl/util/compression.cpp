@@ -60,16 +60,21 @@ std::string compress(const std::string &raw) {
 }
 
 std::string decompress(const std::string &raw) {
+    return decompress(raw.data(), raw.size());
+}
+
+std::string decompress(const char *data, std::size_t size) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Adding 32 to the window size enables automatic detection of the gzip header.
+    if (inflateInit2(&inflate_stream, 32 + MAX_WBITS) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    inflate_stream.next_in = (Bytef *)data;
+    inflate_stream.avail_in = uInt(size);
 
     std::string result;
     char out[15384];
@@ -93,5 +98,118 @@ std::string decompress(const std::string &raw) {
 
     return result;
 }
+
+namespace {
+
+// Size of the prefix that holds the uncompressed size of Codec::Deflate data.
+const std::size_t sizePrefix = 4;
+
+// Deflate can't shrink data by more than this factor, so a larger size in the prefix means that
+// the data is corrupt. Checking it keeps damaged data from allocating up to 4 GB.
+const std::size_t maxDeflateRatio = 1032;
+
+std::string deflateSized(const std::string &raw) {
+    if (raw.size() > UINT32_MAX) {
+        throw std::runtime_error("data is too large to compress");
+    }
+
+    z_stream deflate_stream;
+    memset(&deflate_stream, 0, sizeof(deflate_stream));
+
+    // Negative window bits write a raw deflate stream without header and checksum.
+    if (deflateInit2(&deflate_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+
+    std::string result(sizePrefix + deflateBound(&deflate_stream, uLong(raw.size())), '\0');
+    for (std::size_t i = 0; i < sizePrefix; i++) {
+        result[i] = char((raw.size() >> (8 * i)) & 0xFF);
+    }
+
+    deflate_stream.next_in = (Bytef *)raw.data();
+    deflate_stream.avail_in = uInt(raw.size());
+    deflate_stream.next_out = reinterpret_cast<Bytef *>(&result[sizePrefix]);
+    deflate_stream.avail_out = uInt(result.size() - sizePrefix);
+
+    // The output buffer is large enough for the whole stream.
+    const int code = deflate(&deflate_stream, Z_FINISH);
+    result.resize(sizePrefix + deflate_stream.total_out);
+    deflateEnd(&deflate_stream);
+
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error(deflate_stream.msg ? deflate_stream.msg : "compression error");
+    }
+
+    return result;
+}
+
+std::string inflateSized(const char *data, std::size_t size) {
+    if (size < sizePrefix) {
+        throw std::runtime_error("decompression error");
+    }
+
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < sizePrefix; i++) {
+        length |= std::size_t(uint8_t(data[i])) << (8 * i);
+    }
+
+    if (length > (size - sizePrefix) * maxDeflateRatio) {
+        throw std::runtime_error("decompression error");
+    }
+
+    z_stream inflate_stream;
+    memset(&inflate_stream, 0, sizeof(inflate_stream));
+
+    if (inflateInit2(&inflate_stream, -MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("failed to initialize inflate");
+    }
+
+    std::string result(length, '\0');
+    inflate_stream.next_in = (Bytef *)(data + sizePrefix);
+    inflate_stream.avail_in = uInt(size - sizePrefix);
+    inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+    inflate_stream.avail_out = uInt(length);
+
+    // Inflating everything at once means that zlib doesn't need to allocate a sliding window.
+    const int code = inflate(&inflate_stream, Z_FINISH);
+    const uLong total = inflate_stream.total_out;
+    inflateEnd(&inflate_stream);
+
+    if (code != Z_STREAM_END || total != length) {
+        throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
+    }
+
+    return result;
+}
+
+} // namespace
+
+std::string encode(Codec codec, const std::string &raw) {
+    switch (codec) {
+    case Codec::None:
+        return raw;
+    case Codec::Zlib:
+        return compress(raw);
+    case Codec::Deflate:
+        return deflateSized(raw);
+    }
+
+    throw std::runtime_error("unknown codec");
+}
+
+std::string decode(Codec codec, const char *data, std::size_t size) {
+    switch (codec) {
+    case Codec::None:
+        return { data, size };
+    case Codec::Zlib:
+        return decompress(data, size);
+    case Codec::Deflate:
+        return inflateSized(data, size);
+    }
+
+    throw std::runtime_error("unknown codec");
+}
+
 }
 }
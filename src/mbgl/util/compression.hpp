@@ -1,6 +1,9 @@
 #ifndef MBGL_UTIL_COMPRESSION
 #define MBGL_UTIL_COMPRESSION
 
+#include <mbgl/util/codec.hpp>
+
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
@@ -9,6 +12,13 @@ namespace util {
 std::string compress(const std::string &raw);
 std::string decompress(const std::string &raw);
 
+// Accepts both zlib and gzip streams.
+std::string decompress(const char *data, std::size_t size);
+
+// Throws std::runtime_error when the data is corrupt or the codec is unknown.
+std::string encode(Codec, const std::string &raw);
+std::string decode(Codec, const char *data, std::size_t size);
+
 }
 }
 
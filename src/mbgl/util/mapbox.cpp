@@ -118,6 +118,25 @@ std::string normalizeTileURL(const std::string& url, const std::string& sourceUR
     return normalizedURL;
 }
 
+std::string normalizeURL(const Resource& resource, const std::string& accessToken) {
+    switch (resource.kind) {
+    case Resource::Kind::Style:
+        return normalizeStyleURL(resource.url, accessToken);
+
+    case Resource::Kind::Source:
+        return normalizeSourceURL(resource.url, accessToken);
+
+    case Resource::Kind::Glyphs:
+        return normalizeGlyphsURL(resource.url, accessToken);
+
+    case Resource::Kind::SpriteImage:
+    case Resource::Kind::SpriteJSON:
+        return normalizeSpriteURL(resource.url, accessToken);
+
+    default:
+        return resource.url;
+    }
+}
 
 std::string removeAccessTokenFromURL(const std::string &url) {
     const size_t token_start = url.find("access_token=");
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <mbgl/style/types.hpp>
+#include <mbgl/storage/resource.hpp>
 
 namespace mbgl {
 namespace util {
@@ -14,6 +15,9 @@ std::string normalizeSpriteURL(const std::string& url, const std::string& access
 std::string normalizeGlyphsURL(const std::string& url, const std::string& accessToken);
 std::string normalizeTileURL(const std::string& url, const std::string& sourceURL, SourceType sourceType);
 
+// Applies the normalization above that matches the kind of the resource.
+std::string normalizeURL(const Resource&, const std::string& accessToken);
+
 // Canonicalizes Mapbox URLs by removing [a-d] subdomain prefixes, access tokens, and protocol.
 // Note that this is close, but not exactly the reverse operation as above, as this retains certain
 // information, such as the API version. It is used to cache resources retrieved from the URL, that
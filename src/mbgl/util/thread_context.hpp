@@ -95,6 +95,7 @@ private:
 
     friend class MainThreadContextRegistrar;
     template <class Object> friend class Thread;
+    friend class WorkScheduler;
 };
 
 }
@@ -9,6 +9,10 @@ namespace mbgl {
 
 class WorkTask;
 
+namespace util {
+class WorkScheduler;
+}
+
 class WorkRequest : public util::noncopyable {
 public:
     using Task = std::shared_ptr<WorkTask>;
@@ -16,6 +20,7 @@ public:
     ~WorkRequest();
 
 private:
+    friend class util::WorkScheduler;
     std::shared_ptr<WorkTask> task;
 };
 
@@ -0,0 +1,106 @@
+#include <mbgl/util/work_scheduler.hpp>
+#include <mbgl/platform/platform.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+namespace util {
+
+WorkScheduler::WorkScheduler(const ThreadContext& context_, std::size_t count)
+    : context(context_) {
+    assert(count > 0);
+    for (std::size_t i = 0; i < count; i++) {
+        threads.emplace_back([this] { run(); });
+    }
+}
+
+WorkScheduler::~WorkScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminating = true;
+    }
+    condition.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkScheduler::push(WorkPriority priority,
+                         std::shared_ptr<WorkTask> task,
+                         std::shared_ptr<std::atomic<bool>> canceled) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({ priority, sequence++, Clock::now(), std::move(task), std::move(canceled) });
+        std::push_heap(queue.begin(), queue.end());
+
+        statistics.queued = queue.size();
+        statistics.maxQueued = std::max(statistics.maxQueued, statistics.queued);
+    }
+    condition.notify_one();
+}
+
+void WorkScheduler::raisePriority(const WorkRequest& request, WorkPriority priority) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = std::find_if(queue.begin(), queue.end(), [&] (const Entry& entry) {
+        return entry.task == request.task;
+    });
+    if (it != queue.end() && it->priority < priority) {
+        it->priority = priority;
+        std::make_heap(queue.begin(), queue.end());
+    }
+}
+
+void WorkScheduler::run() {
+    ThreadContext threadContext = context;
+
+    #ifdef __APPLE__
+    pthread_setname_np(threadContext.name.c_str());
+    #endif
+
+    if (threadContext.priority == ThreadPriority::Low) {
+        platform::makeThreadLowPriority();
+    }
+
+    ThreadContext::current.set(&threadContext);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        condition.wait(lock, [this] { return terminating || !queue.empty(); });
+        if (terminating) {
+            break;
+        }
+
+        std::pop_heap(queue.begin(), queue.end());
+        Entry entry = std::move(queue.back());
+        queue.pop_back();
+        statistics.queued = queue.size();
+
+        if (*entry.canceled) {
+            // The request was destroyed while the task was waiting; don't bother running it.
+            statistics.dropped++;
+            continue;
+        }
+
+        const Duration wait = Clock::now() - entry.added;
+        statistics.completed++;
+        statistics.totalWait += wait;
+        statistics.maxWait = std::max(statistics.maxWait, wait);
+
+        lock.unlock();
+        (*entry.task)();
+        entry.task.reset();
+        lock.lock();
+    }
+
+    ThreadContext::current.set(nullptr);
+}
+
+WorkScheduler::Statistics WorkScheduler::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+}
+}
@@ -0,0 +1,140 @@
+#ifndef MBGL_UTIL_WORK_SCHEDULER
+#define MBGL_UTIL_WORK_SCHEDULER
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_context.hpp>
+#include <mbgl/util/work_task.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+enum class WorkPriority : uint8_t {
+    Low,     // e.g. tiles that aren't visible yet
+    Regular, // e.g. parsing visible tiles
+    High,    // e.g. placing symbols of tiles that are already parsed
+};
+
+// Runs work on a pool of threads that share a single queue: whenever a thread becomes idle, it
+// picks the queued task with the highest priority, so that one long running task can't hold up
+// the tasks behind it while other threads are idle. Tasks of the same priority run in the order
+// they were added. Tasks that are canceled while they're still waiting are dropped.
+class WorkScheduler : private util::noncopyable {
+public:
+    struct Statistics {
+        std::size_t queued = 0;    // Number of tasks currently waiting to run.
+        std::size_t maxQueued = 0; // Largest number of tasks that were waiting at the same time.
+        uint64_t completed = 0;    // Number of tasks that were run.
+        uint64_t dropped = 0;      // Number of tasks that were canceled before they ran.
+        Duration totalWait = Duration::zero(); // Time spent waiting by all tasks that were run.
+        Duration maxWait = Duration::zero();   // Longest time a task waited before it was run.
+    };
+
+    WorkScheduler(const ThreadContext&, std::size_t count);
+    ~WorkScheduler();
+
+    // Invoke fn(after) on one of the threads of the pool, where after(results...) invokes
+    // callback(results...) on the current RunLoop. The returned request has the same semantics
+    // as the one returned by RunLoop::invokeWithCallback().
+    template <class Fn, class Cb>
+    std::unique_ptr<WorkRequest>
+    invokeWithCallback(WorkPriority priority, Fn&& fn, Cb&& callback) {
+        auto flag = std::make_shared<std::atomic<bool>>(false);
+
+        auto after = RunLoop::Get()->bind([flag, callback] (auto&&... results) {
+            if (!*flag) {
+                callback(std::move(results)...);
+            }
+        });
+
+        auto task = std::make_shared<Invoker<std::decay_t<Fn>, decltype(after)>>(
+            std::move(fn),
+            std::move(after),
+            flag);
+
+        push(priority, task, flag);
+
+        return std::make_unique<WorkRequest>(task);
+    }
+
+    // Moves a task that is still waiting up to the given priority, e.g. when a tile that was
+    // prefetched becomes visible. Tasks that are running, done, or already have a higher priority
+    // are left alone.
+    void raisePriority(const WorkRequest&, WorkPriority);
+
+    Statistics getStatistics() const;
+
+private:
+    template <class F, class A>
+    class Invoker : public WorkTask {
+    public:
+        Invoker(F&& f, A&& a, std::shared_ptr<std::atomic<bool>> canceled_)
+          : canceled(canceled_),
+            func(std::move(f)),
+            after(std::move(a)) {
+        }
+
+        void operator()() override {
+            // Lock the mutex while processing so that cancel() will block.
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            if (!*canceled) {
+                func(after);
+            }
+        }
+
+        void cancel() override {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            *canceled = true;
+        }
+
+    private:
+        std::recursive_mutex mutex;
+        std::shared_ptr<std::atomic<bool>> canceled;
+
+        F func;
+        A after;
+    };
+
+    struct Entry {
+        WorkPriority priority;
+        uint64_t sequence;
+        TimePoint added;
+        std::shared_ptr<WorkTask> task;
+        std::shared_ptr<std::atomic<bool>> canceled;
+
+        // Orders the heap so that the top is the oldest task with the highest priority.
+        bool operator<(const Entry& other) const {
+            return priority != other.priority ? priority < other.priority
+                                              : sequence > other.sequence;
+        }
+    };
+
+    void push(WorkPriority, std::shared_ptr<WorkTask>, std::shared_ptr<std::atomic<bool>> canceled);
+    void run();
+
+    const ThreadContext context;
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<Entry> queue;
+    uint64_t sequence = 0;
+    bool terminating = false;
+    Statistics statistics;
+
+    std::vector<std::thread> threads;
+};
+
+}
+}
+
+#endif
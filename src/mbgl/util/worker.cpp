@@ -14,11 +14,9 @@ namespace mbgl {
 
 class Worker::Impl {
 public:
-    Impl() = default;
-
-    void parseRasterTile(std::unique_ptr<RasterBucket> bucket,
-                         const std::shared_ptr<const std::string> data,
-                         std::function<void(TileParseResult)> callback) {
+    static void parseRasterTile(std::unique_ptr<RasterBucket> bucket,
+                                const std::shared_ptr<const std::string> data,
+                                std::function<void(TileParseResult)> callback) {
         std::unique_ptr<util::Image> image(new util::Image(*data));
         if (!(*image)) {
             callback(TileParseResult("error parsing raster image"));
@@ -35,20 +33,21 @@ public:
         callback(std::move(result));
     }
 
-    void parseVectorTile(TileWorker* worker,
-                         const std::shared_ptr<const std::string> data,
-                         PlacementConfig config,
-                         std::function<void(TileParseResult)> callback) {
+    static void parseVectorTile(TileWorker* worker,
+                                const std::shared_ptr<const std::string> data,
+                                const std::string& cacheKey,
+                                PlacementConfig config,
+                                std::function<void(TileParseResult)> callback) {
         try {
             pbf tilePBF(reinterpret_cast<const unsigned char*>(data->data()), data->size());
-            callback(worker->parseAllLayers(VectorTile(tilePBF), config));
+            callback(worker->parseAllLayers(VectorTile(tilePBF), config, cacheKey));
         } catch (const std::exception& ex) {
             callback(TileParseResult(ex.what()));
         }
     }
 
-    void parsePendingVectorTileLayers(TileWorker* worker,
-                                      std::function<void(TileParseResult)> callback) {
+    static void parsePendingVectorTileLayers(TileWorker* worker,
+                                             std::function<void(TileParseResult)> callback) {
         try {
             callback(worker->parsePendingLayers());
         } catch (const std::exception& ex) {
@@ -56,10 +55,10 @@ public:
         }
     }
 
-    void parseLiveTile(TileWorker* worker,
-                       const AnnotationTile* tile,
-                       PlacementConfig config,
-                       std::function<void(TileParseResult)> callback) {
+    static void parseLiveTile(TileWorker* worker,
+                              const AnnotationTile* tile,
+                              PlacementConfig config,
+                              std::function<void(TileParseResult)> callback) {
         try {
             callback(worker->parseAllLayers(*tile, config));
         } catch (const std::exception& ex) {
@@ -67,20 +66,17 @@ public:
         }
     }
 
-    void redoPlacement(TileWorker* worker,
-                       const std::unordered_map<std::string, std::unique_ptr<Bucket>>* buckets,
-                       PlacementConfig config,
-                       std::function<void()> callback) {
+    static void redoPlacement(TileWorker* worker,
+                              const std::unordered_map<std::string, std::unique_ptr<Bucket>>* buckets,
+                              PlacementConfig config,
+                              std::function<void()> callback) {
         worker->redoPlacement(buckets, config);
         callback();
     }
 };
 
-Worker::Worker(std::size_t count) {
-    util::ThreadContext context = { "Worker", util::ThreadType::Worker, util::ThreadPriority::Low };
-    for (std::size_t i = 0; i < count; i++) {
-        threads.emplace_back(std::make_unique<util::Thread<Impl>>(context));
-    }
+Worker::Worker(std::size_t count)
+    : scheduler({ "Worker", util::ThreadType::Worker, util::ThreadPriority::Low }, count) {
 }
 
 Worker::~Worker() = default;
@@ -88,37 +84,42 @@ Worker::~Worker() = default;
 std::unique_ptr<WorkRequest>
 Worker::parseRasterTile(std::unique_ptr<RasterBucket> bucket,
                         const std::shared_ptr<const std::string> data,
-                        std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parseRasterTile, callback, bucket,
-                                                data);
+                        std::function<void(TileParseResult)> callback,
+                        Priority priority) {
+    return scheduler.invokeWithCallback(priority, [bucket = std::move(bucket), data] (auto after) mutable {
+        Impl::parseRasterTile(std::move(bucket), data, after);
+    }, callback);
 }
 
 std::unique_ptr<WorkRequest>
 Worker::parseVectorTile(TileWorker& worker,
                         const std::shared_ptr<const std::string> data,
+                        std::string cacheKey,
                         PlacementConfig config,
-                        std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parseVectorTile, callback, &worker,
-                                                data, config);
+                        std::function<void(TileParseResult)> callback,
+                        Priority priority) {
+    return scheduler.invokeWithCallback(priority, [&worker, data, cacheKey = std::move(cacheKey), config] (auto after) {
+        Impl::parseVectorTile(&worker, data, cacheKey, config, after);
+    }, callback);
 }
 
 std::unique_ptr<WorkRequest>
 Worker::parsePendingVectorTileLayers(TileWorker& worker,
-                                     std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parsePendingVectorTileLayers,
-                                                callback, &worker);
+                                     std::function<void(TileParseResult)> callback,
+                                     Priority priority) {
+    return scheduler.invokeWithCallback(priority, [&worker] (auto after) {
+        Impl::parsePendingVectorTileLayers(&worker, after);
+    }, callback);
 }
 
 std::unique_ptr<WorkRequest> Worker::parseLiveTile(TileWorker& worker,
                                                    const AnnotationTile& tile,
                                                    PlacementConfig config,
-                                                   std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parseLiveTile, callback, &worker,
-                                                &tile, config);
+                                                   std::function<void(TileParseResult)> callback,
+                                                   Priority priority) {
+    return scheduler.invokeWithCallback(priority, [&worker, &tile, config] (auto after) {
+        Impl::parseLiveTile(&worker, &tile, config, after);
+    }, callback);
 }
 
 std::unique_ptr<WorkRequest>
@@ -126,9 +127,19 @@ Worker::redoPlacement(TileWorker& worker,
                       const std::unordered_map<std::string, std::unique_ptr<Bucket>>& buckets,
                       PlacementConfig config,
                       std::function<void()> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::redoPlacement, callback, &worker,
-                                                &buckets, config);
+    return scheduler.invokeWithCallback(Priority::High, [&worker, &buckets, config] (auto after) {
+        Impl::redoPlacement(&worker, &buckets, config, after);
+    }, callback);
+}
+
+void Worker::raisePriority(const Request& request, Priority priority) {
+    if (request) {
+        scheduler.raisePriority(*request, priority);
+    }
+}
+
+Worker::Statistics Worker::getStatistics() const {
+    return scheduler.getStatistics();
 }
 
 } // end namespace mbgl
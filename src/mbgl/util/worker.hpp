@@ -2,7 +2,7 @@
 #define MBGL_UTIL_WORKER
 
 #include <mbgl/util/noncopyable.hpp>
-#include <mbgl/util/thread.hpp>
+#include <mbgl/util/work_scheduler.hpp>
 #include <mbgl/map/tile_worker.hpp>
 
 #include <functional>
@@ -29,34 +29,52 @@ public:
     // bind references to itself, and if and when those lambdas execute, the references
     // will still be valid.
 
+    //
+    // Parsing requests are run at the given priority; tiles that aren't visible should be
+    // parsed with a low priority. Placement requests always run at a high priority, since
+    // they only affect tiles that are already being displayed.
+
     using Request = std::unique_ptr<WorkRequest>;
+    using Priority = util::WorkPriority;
+    using Statistics = util::WorkScheduler::Statistics;
 
     Request parseRasterTile(std::unique_ptr<RasterBucket> bucket,
                             std::shared_ptr<const std::string> data,
-                            std::function<void(TileParseResult)> callback);
+                            std::function<void(TileParseResult)> callback,
+                            Priority = Priority::Regular);
 
+    // See TileWorker::parseAllLayers() for the cache key.
     Request parseVectorTile(TileWorker&,
                             std::shared_ptr<const std::string> data,
+                            std::string cacheKey,
                             PlacementConfig config,
-                            std::function<void(TileParseResult)> callback);
+                            std::function<void(TileParseResult)> callback,
+                            Priority = Priority::Regular);
 
     Request parsePendingVectorTileLayers(TileWorker&,
-                                         std::function<void(TileParseResult)> callback);
+                                         std::function<void(TileParseResult)> callback,
+                                         Priority = Priority::Regular);
 
     Request parseLiveTile(TileWorker&,
                           const AnnotationTile&,
                           PlacementConfig config,
-                          std::function<void(TileParseResult)> callback);
+                          std::function<void(TileParseResult)> callback,
+                          Priority = Priority::Regular);
 
     Request redoPlacement(TileWorker&,
                           const std::unordered_map<std::string, std::unique_ptr<Bucket>>&,
                           PlacementConfig config,
                           std::function<void()> callback);
 
+    // Moves a request that is still waiting up to the given priority.
+    void raisePriority(const Request&, Priority);
+
+    // Queue depth and wait time counters of the thread pool.
+    Statistics getStatistics() const;
+
 private:
     class Impl;
-    std::vector<std::unique_ptr<util::Thread<Impl>>> threads;
-    std::size_t current = 0;
+    util::WorkScheduler scheduler;
 };
 }
 
@@ -0,0 +1,244 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/bucket_cache.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/line_bucket.hpp>
+
+#include <mbgl/util/io.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace mbgl;
+
+namespace {
+
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() {
+        char name[] = "/tmp/mbgl-bucket-cache-XXXXXX";
+        path = mkdtemp(name);
+    }
+
+    ~TemporaryDirectory() {
+        if (DIR* dir = opendir(path.c_str())) {
+            while (const dirent* entry = readdir(dir)) {
+                const std::string name = entry->d_name;
+                if (name != "." && name != "..") {
+                    unlink((path + "/" + name).c_str());
+                }
+            }
+            closedir(dir);
+        }
+        rmdir(path.c_str());
+    }
+
+    std::size_t count() const {
+        std::size_t result = 0;
+        if (DIR* dir = opendir(path.c_str())) {
+            while (const dirent* entry = readdir(dir)) {
+                const std::string name = entry->d_name;
+                if (name != "." && name != "..") {
+                    result++;
+                }
+            }
+            closedir(dir);
+        }
+        return result;
+    }
+
+    std::string path;
+};
+
+template <typename Bucket>
+std::string serialize(const Bucket& bucket) {
+    BucketCache::Writer writer;
+    bucket.serialize(writer);
+    return writer.data;
+}
+
+const GeometryCollection square = {{ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 }, { 0, 0 } }};
+
+} // namespace
+
+TEST(BucketCache, FillBucket) {
+    TemporaryDirectory directory;
+    BucketCache cache(directory.path);
+
+    FillBucket bucket;
+    bucket.addGeometry(square);
+    ASSERT_TRUE(bucket.hasData());
+
+    const std::string key = BucketCache::bucketKey("water", "fill\nwater\n\n");
+    cache.put("tile", {{ key, serialize(bucket) }});
+
+    auto buckets = cache.get("tile");
+    ASSERT_EQ(1u, buckets.size());
+    ASSERT_EQ(1u, buckets.count(key));
+
+    FillBucket restored;
+    BucketCache::Reader reader(buckets[key]);
+    restored.deserialize(reader);
+    EXPECT_TRUE(reader.atEnd());
+
+    EXPECT_TRUE(restored.hasData());
+    EXPECT_EQ(bucket.memoryUsage(), restored.memoryUsage());
+    EXPECT_EQ(serialize(bucket), serialize(restored));
+    EXPECT_EQ(1u, cache.getStatistics().writes);
+}
+
+TEST(BucketCache, LineBucket) {
+    TemporaryDirectory directory;
+    BucketCache cache(directory.path);
+
+    LineBucket bucket;
+    bucket.addGeometry(square);
+    ASSERT_TRUE(bucket.hasData());
+
+    cache.put("tile", {{ "road", serialize(bucket) }});
+
+    auto buckets = cache.get("tile");
+    ASSERT_EQ(1u, buckets.count("road"));
+
+    LineBucket restored;
+    BucketCache::Reader reader(buckets["road"]);
+    restored.deserialize(reader);
+
+    EXPECT_EQ(bucket.memoryUsage(), restored.memoryUsage());
+    EXPECT_EQ(serialize(bucket), serialize(restored));
+}
+
+TEST(BucketCache, Replace) {
+    TemporaryDirectory directory;
+    BucketCache cache(directory.path);
+
+    cache.put("tile", {{ "a", "1" }, { "b", "2" }});
+    cache.put("tile", {{ "a", "3" }});
+    cache.put("other", {{ "a", "4" }});
+
+    EXPECT_EQ((BucketCache::Buckets {{ "a", "3" }}), cache.get("tile"));
+    EXPECT_EQ((BucketCache::Buckets {{ "a", "4" }}), cache.get("other"));
+    EXPECT_TRUE(cache.get("missing").empty());
+    EXPECT_EQ(3u, cache.getStatistics().writes);
+}
+
+TEST(BucketCache, MissingDirectory) {
+    BucketCache cache("test/fixtures/bucket_cache/missing");
+
+    cache.put("tile", {{ "a", "1" }});
+    EXPECT_TRUE(cache.get("tile").empty());
+    EXPECT_EQ(0u, cache.getStatistics().writes);
+}
+
+TEST(BucketCache, Truncated) {
+    FillBucket bucket;
+    bucket.addGeometry(square);
+
+    std::string data = serialize(bucket);
+    data.resize(data.size() - 1);
+
+    FillBucket restored;
+    BucketCache::Reader reader(data);
+    EXPECT_THROW(restored.deserialize(reader), std::runtime_error);
+}
+
+TEST(BucketCache, Groups) {
+    // Empty buffers with a single group that would be drawn from them.
+    const auto data = [](int32_t vertexLength, int32_t elementsLength) {
+        BucketCache::Writer writer;
+        writer.write<uint32_t>(0);
+        writer.write<uint32_t>(0);
+        writer.write<uint32_t>(1);
+        writer.write<int32_t>(vertexLength);
+        writer.write<int32_t>(elementsLength);
+        return writer.data;
+    };
+
+    LineBucket bucket;
+    const std::string empty = data(0, 0);
+    BucketCache::Reader valid(empty);
+    bucket.deserialize(valid);
+    EXPECT_TRUE(valid.atEnd());
+
+    const std::string vertices = data(4, 0);
+    BucketCache::Reader verticesReader(vertices);
+    EXPECT_THROW(bucket.deserialize(verticesReader), std::runtime_error);
+
+    const std::string elements = data(0, 2);
+    BucketCache::Reader elementsReader(elements);
+    EXPECT_THROW(bucket.deserialize(elementsReader), std::runtime_error);
+
+    const std::string negative = data(-1, 0);
+    BucketCache::Reader negativeReader(negative);
+    EXPECT_THROW(bucket.deserialize(negativeReader), std::runtime_error);
+}
+
+TEST(BucketCache, Header) {
+    TemporaryDirectory directory;
+    BucketCache cache(directory.path);
+
+    cache.put("tile", {{ "a", "1" }});
+    ASSERT_EQ(1u, directory.count());
+    ASSERT_EQ(1u, cache.get("tile").size());
+
+    DIR* dir = opendir(directory.path.c_str());
+    std::string file;
+    while (const dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            file = directory.path + "/" + entry->d_name;
+        }
+    }
+    closedir(dir);
+
+    const std::string data = util::read_file(file);
+
+    // The version.
+    std::string corrupted = data;
+    corrupted[4]++;
+    util::write_file(file, corrupted);
+    EXPECT_TRUE(cache.get("tile").empty());
+
+    // The byte order.
+    corrupted = data;
+    std::reverse(corrupted.begin() + 8, corrupted.begin() + 12);
+    util::write_file(file, corrupted);
+    EXPECT_TRUE(cache.get("tile").empty());
+
+    util::write_file(file, data);
+    EXPECT_EQ(1u, cache.get("tile").size());
+}
+
+TEST(BucketCache, Limit) {
+    TemporaryDirectory directory;
+    const std::string value(1000, 'x');
+
+    {
+        // Room for two tiles.
+        BucketCache cache(directory.path, 2500);
+
+        cache.put("a", {{ "bucket", value }});
+        cache.put("b", {{ "bucket", value }});
+        EXPECT_EQ(2u, directory.count());
+
+        // Reading a tile makes it the most recently used one.
+        EXPECT_EQ(1u, cache.get("a").size());
+        cache.put("c", {{ "bucket", value }});
+
+        EXPECT_EQ(2u, directory.count());
+        EXPECT_EQ(1u, cache.get("a").size());
+        EXPECT_TRUE(cache.get("b").empty());
+        EXPECT_EQ(1u, cache.get("c").size());
+
+        const auto statistics = cache.getStatistics();
+        EXPECT_EQ(1u, statistics.evictions);
+        EXPECT_GE(2500u, statistics.bytes);
+        EXPECT_LT(2000u, statistics.bytes);
+    }
+
+    // Files of previous runs count against the limit.
+    BucketCache cache(directory.path, 1500);
+    EXPECT_EQ(1u, directory.count());
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+}
@@ -0,0 +1,59 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/collision_tile.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+// A point label with a 100x20 box around the anchor.
+CollisionFeature makeFeature(float x, float y) {
+    return CollisionFeature({{ int16_t(x), int16_t(y) }}, Anchor(x, y, 0, 0.5f),
+                            -10, 10, -50, 50, 1, 0, false);
+}
+
+float place(CollisionTile& tile, CollisionFeature feature) {
+    const float scale = tile.placeFeature(feature);
+    tile.insertFeature(feature, scale);
+    return scale;
+}
+
+} // namespace
+
+TEST(CollisionTile, Collides) {
+    CollisionTile tile(PlacementConfig(0, 0));
+
+    EXPECT_EQ(0.5f, place(tile, makeFeature(1000, 1000)));
+
+    // Overlaps at scale 1, but fits beside the first box at twice the scale.
+    EXPECT_FLOAT_EQ(1.25f, place(tile, makeFeature(1080, 1000)));
+
+    // Far enough away to be placed at any scale.
+    EXPECT_EQ(0.5f, place(tile, makeFeature(1300, 1000)));
+}
+
+TEST(CollisionTile, OutsideOfGrid) {
+    // Boxes outside of the area covered by the grid still collide.
+    for (const float angle : { 0.0f, float(M_PI / 4) }) {
+        CollisionTile tile(PlacementConfig(angle, 0));
+
+        EXPECT_EQ(0.5f, place(tile, makeFeature(-20000, 30000)));
+        EXPECT_LT(0.5f, place(tile, makeFeature(-20010, 30005)));
+        EXPECT_EQ(0.5f, place(tile, makeFeature(-20000, 28000)));
+    }
+}
+
+TEST(CollisionTile, ManyBoxes) {
+    // Boxes that span many cells are only checked once per query.
+    CollisionTile tile(PlacementConfig(0, 0));
+
+    CollisionFeature wide({{ 2048, 2048 }}, Anchor(2048, 2048, 0, 0.5f), -10, 10, -2000, 2000, 1, 0, false);
+    EXPECT_EQ(0.5f, place(tile, wide));
+
+    for (int16_t x = 100; x < 4000; x += 200) {
+        EXPECT_LT(0.5f, place(tile, makeFeature(x, 2050))) << x;
+        EXPECT_EQ(0.5f, place(tile, makeFeature(x, 3000))) << x;
+    }
+}
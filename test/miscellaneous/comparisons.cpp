@@ -108,3 +108,83 @@ TEST(FilterComparison, None) {
     ASSERT_FALSE(evaluate(parse("[\"none\", [\"==\", \"foo\", 0], [\"==\", \"foo\", 1]]"),
                           {{ std::string("foo"), int64_t(1) }}));
 }
+
+TEST(FilterComparison, OptimizeConstants) {
+    ASSERT_TRUE(isFalseFilter(optimizeFilterExpression(parse("[\"in\", \"foo\"]"))));
+    ASSERT_TRUE(optimizeFilterExpression(parse("[\"!in\", \"foo\"]")).is<NullExpression>());
+    ASSERT_TRUE(optimizeFilterExpression(parse("[\"all\", [\"all\"], [\"none\"]]")).is<NullExpression>());
+    ASSERT_TRUE(isFalseFilter(optimizeFilterExpression(parse("[\"all\", [\"==\", \"foo\", 1], [\"any\"]]"))));
+    ASSERT_TRUE(optimizeFilterExpression(parse("[\"any\", [\"==\", \"foo\", 1], [\"all\"]]")).is<NullExpression>());
+    ASSERT_TRUE(isFalseFilter(optimizeFilterExpression(parse("[\"none\", [\"==\", \"foo\", 1], [\"all\"]]"))));
+    ASSERT_TRUE(optimizeFilterExpression(parse("[\"all\", [\"==\", \"foo\", 1]]")).is<EqualsExpression>());
+}
+
+TEST(FilterComparison, OptimizeOrdering) {
+    FilterExpression f = optimizeFilterExpression(parse(
+        "[\"all\", [\"in\", \"foo\", 1, 2, 3, 4, 5, 6, 7, 8], [\"all\", [\"==\", \"$type\", \"Point\"], [\"==\", \"bar\", 1]]]"));
+    ASSERT_TRUE(f.is<AllExpression>());
+
+    const auto& expressions = f.get<AllExpression>().expressions;
+    ASSERT_EQ(3u, expressions.size());
+    ASSERT_EQ("$type", expressions[0].get<EqualsExpression>().key.name);
+    ASSERT_EQ("bar", expressions[1].get<EqualsExpression>().key.name);
+    ASSERT_TRUE(expressions[2].is<InExpression>());
+    ASSERT_NE(nullptr, expressions[2].get<InExpression>().set);
+}
+
+TEST(FilterComparison, InHashed) {
+    FilterExpression f = optimizeFilterExpression(parse(
+        "[\"in\", \"foo\", \"a\", \"b\", \"c\", \"d\", \"e\", \"f\", \"g\", 0, 2.5, true, -9007199254740993]"));
+    ASSERT_NE(nullptr, f.get<InExpression>().set);
+
+    ASSERT_TRUE(evaluate(f, {{ "foo", std::string("e") }}));
+    ASSERT_FALSE(evaluate(f, {{ "foo", std::string("0") }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", int64_t(0) }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", uint64_t(0) }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", double(0) }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", double(2.5) }}));
+    ASSERT_FALSE(evaluate(f, {{ "foo", int64_t(2) }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", true }}));
+    ASSERT_FALSE(evaluate(f, {{ "foo", false }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", int64_t(-9007199254740993) }}));
+    ASSERT_FALSE(evaluate(f, {{ "foo", int64_t(-9007199254740992) }}));
+    ASSERT_TRUE(evaluate(f, {{ "foo", double(-9007199254740992) }}));
+    ASSERT_FALSE(evaluate(f, {{}}));
+
+    FilterExpression n = optimizeFilterExpression(parse(
+        "[\"!in\", \"foo\", \"a\", \"b\", \"c\", \"d\", \"e\", \"f\", \"g\", 0, 2.5, true]"));
+    ASSERT_NE(nullptr, n.get<NotInExpression>().set);
+    ASSERT_FALSE(evaluate(n, {{ "foo", std::string("e") }}));
+    ASSERT_FALSE(evaluate(n, {{ "foo", uint64_t(0) }}));
+    ASSERT_TRUE(evaluate(n, {{ "foo", std::string("z") }}));
+    ASSERT_TRUE(evaluate(n, {{}}));
+}
+
+TEST(FilterComparison, OptimizeEquivalence) {
+    const char* filters[] = {
+        "[\"all\", [\"any\", [\"==\", \"foo\", 1], [\"!=\", \"bar\", \"x\"]], [\"none\", [\"<\", \"foo\", 0]]]",
+        "[\"any\", [\"in\", \"foo\", 1, 2, 3, 4, 5, 6, 7, 8, 9], [\"all\", [\">=\", \"foo\", 10], [\"<=\", \"foo\", 20]]]",
+        "[\"none\", [\"any\", [\"==\", \"bar\", \"x\"], [\"==\", \"bar\", \"y\"]], [\"!in\", \"foo\", 1, 2]]",
+        "[\"all\", [\"==\", \"$type\", \"Point\"], [\"any\"], [\">\", \"foo\", 1]]",
+        "[\"none\", [\"all\"], [\"==\", \"foo\", 1]]",
+    };
+
+    const std::vector<Properties> cases = {
+        {},
+        {{ "foo", int64_t(1) }},
+        {{ "foo", double(15) }},
+        {{ "foo", int64_t(-1) }, { "bar", std::string("x") }},
+        {{ "foo", uint64_t(5) }, { "bar", std::string("y") }},
+        {{ "bar", std::string("z") }},
+    };
+
+    for (const auto json : filters) {
+        const FilterExpression raw = parse(json);
+        const FilterExpression optimized = optimizeFilterExpression(raw);
+        for (const auto& properties : cases) {
+            for (auto type : { FeatureType::Point, FeatureType::LineString }) {
+                EXPECT_EQ(evaluate(raw, properties, type), evaluate(optimized, properties, type)) << json;
+            }
+        }
+    }
+}
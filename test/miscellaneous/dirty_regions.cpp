@@ -0,0 +1,82 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/dirty_regions.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+using Rects = std::vector<Rect<uint16_t>>;
+
+TEST(DirtyRegions, MergesAdjacent) {
+    DirtyRegions regions(1024, 1024, 1);
+
+    // Glyphs next to each other in the same row.
+    regions.add({ 0, 0, 24, 32 });
+    regions.add({ 24, 0, 20, 32 });
+    regions.add({ 44, 0, 28, 28 });
+    EXPECT_EQ(1u, regions.size());
+
+    // A glyph far away is kept separately.
+    regions.add({ 512, 512, 24, 32 });
+    EXPECT_EQ(2u, regions.size());
+
+    EXPECT_EQ((Rects {{ 0, 0, 72, 32 }, { 512, 512, 24, 32 }}), regions.take(0));
+    EXPECT_TRUE(regions.empty());
+}
+
+TEST(DirtyRegions, MergesContained) {
+    DirtyRegions regions(256, 256, 4);
+
+    regions.add({ 10, 10, 100, 100 });
+    regions.add({ 20, 20, 10, 10 });
+    regions.add({ 5, 5, 110, 110 });
+
+    EXPECT_EQ((Rects {{ 5, 5, 110, 110 }}), regions.take(0));
+}
+
+TEST(DirtyRegions, ClipsToTexture) {
+    DirtyRegions regions(64, 64, 1);
+
+    regions.add({ 60, 60, 8, 8 });
+    regions.add({ 64, 0, 8, 8 });
+    regions.add({ 0, 0, 0, 8 });
+
+    EXPECT_EQ((Rects {{ 60, 60, 4, 4 }}), regions.take(0));
+}
+
+TEST(DirtyRegions, MaxRegions) {
+    DirtyRegions regions(1024, 1024, 1);
+
+    for (uint16_t i = 0; i < DirtyRegions::maxRegions + 8; i++) {
+        regions.add({ uint16_t(i * 24), uint16_t(i * 24), 8, 8 });
+    }
+
+    EXPECT_EQ(DirtyRegions::maxRegions, regions.size());
+
+    // Every pixel that was added is still covered.
+    const auto taken = regions.take(0);
+    for (uint16_t i = 0; i < DirtyRegions::maxRegions + 8; i++) {
+        const uint16_t p = i * 24;
+        EXPECT_TRUE(std::any_of(taken.begin(), taken.end(), [&] (const Rect<uint16_t>& rect) {
+            return rect.x <= p && rect.y <= p && p + 8 <= rect.x + rect.w && p + 8 <= rect.y + rect.h;
+        })) << i;
+    }
+}
+
+TEST(DirtyRegions, Budget) {
+    DirtyRegions regions(256, 256, 4);
+
+    regions.add({ 0, 0, 16, 16 });     // 1024 bytes
+    regions.add({ 128, 128, 16, 16 }); // 1024 bytes
+
+    // The second region is split along its rows.
+    EXPECT_EQ((Rects {{ 0, 0, 16, 16 }, { 128, 128, 16, 4 }}), regions.take(1024 + 256));
+    EXPECT_EQ(1u, regions.size());
+
+    // A budget smaller than a row still makes progress.
+    EXPECT_EQ((Rects {{ 128, 132, 16, 1 }}), regions.take(1));
+    EXPECT_EQ((Rects {{ 128, 133, 16, 11 }}), regions.take(4096));
+    EXPECT_TRUE(regions.empty());
+    EXPECT_TRUE(regions.take(4096).empty());
+}
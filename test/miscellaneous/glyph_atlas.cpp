@@ -0,0 +1,112 @@
+#include "../fixtures/util.hpp"
+#include "../fixtures/fixture_log_observer.hpp"
+
+#include <mbgl/geometry/glyph_atlas.hpp>
+#include <mbgl/text/font_stack.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Glyphs of this size take a 32x32 rectangle in the atlas, so that four fit on a 64x64 page.
+FontStack makeFontStack(uint32_t count) {
+    FontStack stack;
+    for (uint32_t id = 0; id < count; id++) {
+        SDFGlyph glyph;
+        glyph.id = id;
+        glyph.metrics.width = 20;
+        glyph.metrics.height = 20;
+        glyph.metrics.advance = 20;
+        glyph.bitmap = std::string(26 * 26, char(id + 1));
+        stack.insert(id, glyph);
+    }
+    return stack;
+}
+
+std::u32string text(char32_t first, char32_t last) {
+    std::u32string result;
+    for (char32_t chr = first; chr <= last; chr++) {
+        result += chr;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(GlyphAtlas, AddsPages) {
+    const FontStack stack = makeFontStack(12);
+    GlyphAtlas atlas(64, 64, 4);
+    EXPECT_EQ(0u, atlas.getPageCount());
+
+    GlyphPositions first;
+    atlas.addGlyphs(1, text(0, 3), "Test", stack, first);
+    EXPECT_EQ(1u, atlas.getPageCount());
+
+    GlyphPositions second;
+    atlas.addGlyphs(2, text(4, 8), "Test", stack, second);
+    EXPECT_EQ(3u, atlas.getPageCount());
+
+    ASSERT_EQ(4u, first.size());
+    for (const auto& glyph : first) {
+        EXPECT_EQ(0, glyph.second.page);
+        EXPECT_EQ(32, glyph.second.rect.w);
+    }
+
+    ASSERT_EQ(5u, second.size());
+    EXPECT_EQ(1, second.at(4).page);
+    EXPECT_EQ(1, second.at(7).page);
+    EXPECT_EQ(2, second.at(8).page);
+
+    // Glyphs that are already in the atlas keep their page.
+    GlyphPositions shared;
+    atlas.addGlyphs(3, text(3, 4), "Test", stack, shared);
+    EXPECT_EQ(0, shared.at(3).page);
+    EXPECT_EQ(1, shared.at(4).page);
+    EXPECT_EQ(3u, atlas.getPageCount());
+    EXPECT_TRUE(atlas.isDirty());
+}
+
+TEST(GlyphAtlas, ReleasesPages) {
+    const FontStack stack = makeFontStack(12);
+    GlyphAtlas atlas(64, 64, 4);
+
+    GlyphPositions positions;
+    atlas.addGlyphs(1, text(0, 3), "Test", stack, positions);
+    atlas.addGlyphs(2, text(4, 7), "Test", stack, positions);
+    atlas.addGlyphs(3, text(7, 7), "Test", stack, positions);
+    EXPECT_EQ(2u, atlas.getPageCount());
+
+    // The page is still used by the third tile.
+    atlas.removeGlyphs(2);
+    EXPECT_EQ(2u, atlas.getPageCount());
+
+    atlas.removeGlyphs(3);
+    EXPECT_EQ(1u, atlas.getPageCount());
+
+    // New glyphs fill the free slot of the released page first.
+    GlyphPositions added;
+    atlas.addGlyphs(4, text(8, 11), "Test", stack, added);
+    EXPECT_EQ(2u, atlas.getPageCount());
+    EXPECT_EQ(1, added.at(8).page);
+    EXPECT_EQ(0, added.at(8).rect.x);
+    EXPECT_EQ(0, added.at(8).rect.y);
+
+    atlas.removeGlyphs(1);
+    atlas.removeGlyphs(4);
+    EXPECT_EQ(0u, atlas.getPageCount());
+}
+
+TEST(GlyphAtlas, Overflow) {
+    FixtureLog log;
+
+    const FontStack stack = makeFontStack(12);
+    GlyphAtlas atlas(64, 64, 2);
+
+    GlyphPositions positions;
+    atlas.addGlyphs(1, text(0, 8), "Test", stack, positions);
+    EXPECT_EQ(2u, atlas.getPageCount());
+
+    ASSERT_EQ(9u, positions.size());
+    EXPECT_FALSE(positions.at(8).rect.hasArea());
+    EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::OpenGL, -1, "glyph bitmap overflow" }));
+}
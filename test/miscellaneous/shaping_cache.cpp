@@ -0,0 +1,145 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+FontStack makeFontStack() {
+    FontStack fontStack;
+    for (uint32_t chr = 'A'; chr <= 'z'; chr++) {
+        SDFGlyph glyph;
+        glyph.id = chr;
+        glyph.metrics.width = 10;
+        glyph.metrics.height = 16;
+        glyph.metrics.advance = 12;
+        fontStack.insert(chr, glyph);
+    }
+    return fontStack;
+}
+
+ShapingCache::Key makeKey(const std::u32string& text) {
+    return { "Open Sans Regular", text, 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 } };
+}
+
+} // namespace
+
+TEST(ShapingCache, SharesShapings) {
+    const FontStack fontStack = makeFontStack();
+    ShapingCache cache;
+
+    auto first = cache.get(makeKey(U"Main"), fontStack);
+    auto second = cache.get(makeKey(U"Main"), fontStack);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(4u, first->positionedGlyphs.size());
+
+    // The result is the same as shaping without the cache.
+    const Shaping shaping = fontStack.getShaping(U"Main", 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 });
+    EXPECT_EQ(shaping.left, first->left);
+    EXPECT_EQ(shaping.right, first->right);
+    EXPECT_EQ(shaping.top, first->top);
+    EXPECT_EQ(shaping.bottom, first->bottom);
+
+    const auto statistics = cache.getStatistics();
+    EXPECT_EQ(1u, statistics.hits);
+    EXPECT_EQ(1u, statistics.misses);
+}
+
+TEST(ShapingCache, KeyFields) {
+    const FontStack fontStack = makeFontStack();
+    ShapingCache cache;
+
+    auto key = makeKey(U"Main");
+    auto original = cache.get(key, fontStack);
+
+    key.spacing = 2.4;
+    auto spaced = cache.get(key, fontStack);
+    EXPECT_NE(original, spaced);
+    EXPECT_GT(spaced->right, original->right);
+
+    key = makeKey(U"Main");
+    key.fontStack = "Open Sans Bold";
+    EXPECT_NE(original, cache.get(key, fontStack));
+
+    key = makeKey(U"Main");
+    key.translate = { 1, 0 };
+    EXPECT_NE(original, cache.get(key, fontStack));
+
+    EXPECT_EQ(4u, cache.count());
+    EXPECT_EQ(0u, cache.getStatistics().hits);
+}
+
+TEST(ShapingCache, Evicts) {
+    const FontStack fontStack = makeFontStack();
+    ShapingCache cache(2);
+
+    auto a = cache.get(makeKey(U"A"), fontStack);
+    cache.get(makeKey(U"B"), fontStack);
+    EXPECT_EQ(a, cache.get(makeKey(U"A"), fontStack));
+
+    // B is the least recently used entry.
+    cache.get(makeKey(U"C"), fontStack);
+    EXPECT_EQ(2u, cache.count());
+    EXPECT_EQ(a, cache.get(makeKey(U"A"), fontStack));
+
+    cache.get(makeKey(U"B"), fontStack);
+    const auto statistics = cache.getStatistics();
+    EXPECT_EQ(2u, statistics.hits);
+    EXPECT_EQ(4u, statistics.misses);
+
+    // Shapings that were handed out stay valid after they were evicted.
+    EXPECT_EQ(1u, a->positionedGlyphs.size());
+}
+
+TEST(ShapingCache, TileStatistics) {
+    const FontStack fontStack = makeFontStack();
+    ShapingCache cache;
+
+    ShapingCache::Statistics first;
+    cache.get(makeKey(U"Main"), fontStack, &first);
+    cache.get(makeKey(U"Main"), fontStack, &first);
+
+    ShapingCache::Statistics second;
+    cache.get(makeKey(U"Main"), fontStack, &second);
+
+    EXPECT_EQ(1u, first.hits);
+    EXPECT_EQ(1u, first.misses);
+    EXPECT_EQ(1u, second.hits);
+    EXPECT_EQ(0u, second.misses);
+    EXPECT_EQ(Duration::zero(), second.saved());
+
+    first += second;
+    EXPECT_EQ(2u, first.hits);
+    EXPECT_EQ(first.shapingTime * 2, first.saved());
+}
+
+TEST(ShapingCache, Threads) {
+    const FontStack fontStack = makeFontStack();
+    ShapingCache cache(64);
+
+    const std::vector<std::u32string> labels = { U"Main", U"Market", U"Broadway", U"Elm" };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                const auto& label = labels[i % labels.size()];
+                auto shaping = cache.get(makeKey(label), fontStack);
+                ASSERT_EQ(label.size(), shaping->positionedGlyphs.size());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto statistics = cache.getStatistics();
+    EXPECT_EQ(4000u, statistics.hits + statistics.misses);
+    EXPECT_EQ(labels.size(), cache.count());
+}
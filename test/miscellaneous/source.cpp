@@ -0,0 +1,216 @@
+#include "../fixtures/util.hpp"
+#include "../fixtures/mock_file_source.hpp"
+#include "../fixtures/mock_view.hpp"
+
+#include <mbgl/map/map_data.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/map/tile.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/texture_pool.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <future>
+
+using namespace mbgl;
+
+namespace {
+
+struct SourceState {
+    std::vector<TileID> tiles;
+    std::size_t readyTiles = 0;
+    std::size_t parents = 0;
+    std::size_t requests = 0;
+    uint64_t cacheHits = 0;
+};
+
+// Owns a vector source without layers on a thread of the Map type, so that every tile is parsed
+// as soon as it arrives.
+class SourceThread : public Source::Observer, public FileSource {
+public:
+    SourceThread(FileSource& fileSource_)
+        : fileSource(fileSource_),
+          data(MapMode::Continuous, GLContextMode::Unique, view.getPixelRatio()),
+          transform(view),
+          style(std::make_unique<Style>(data)) {
+        util::ThreadContext::setFileSource(this);
+
+        transform.resize({{ 512, 512 }});
+        style->setJSON(R"({ "version": 8, "sources": {}, "layers": [] })", "");
+
+        source.info.type = SourceType::Vector;
+        source.info.tiles = { "test/fixtures/resources/vector.pbf" };
+        source.setCacheSize(16);
+        source.setObserver(this);
+        source.load();
+    }
+
+    ~SourceThread() {
+        cleanup();
+    }
+
+    void cleanup() {
+        source.invalidateTiles();
+        style.reset();
+    }
+
+    // Moves the camera and updates the source. The callback is invoked once all tiles that were
+    // requested have arrived.
+    void moveTo(LatLng latLng, double zoom, std::function<void()> callback) {
+        transform.setLatLngZoom(latLng, zoom);
+        onLoaded = callback;
+        update();
+    }
+
+    void setParentPrefetchLevels(std::vector<int32_t> levels) {
+        source.setParentPrefetchLevels(std::move(levels));
+    }
+
+    SourceState getState() {
+        SourceState state;
+        for (const auto tile : source.getTiles()) {
+            state.tiles.push_back(tile->id);
+            if (tile->data->isReady()) {
+                state.readyTiles++;
+            }
+        }
+        state.parents = source.getParentPrefetchStatistics().tiles;
+        state.requests = requests;
+        state.cacheHits = source.getCacheStatistics().hits;
+        return state;
+    }
+
+    // FileSource implementation; counts the requests of the source.
+    Request* request(const Resource& resource, uv_loop_t* loop, Callback callback) override {
+        requests++;
+        return fileSource.request(resource, loop, std::move(callback));
+    }
+
+    void cancel(Request* req) override {
+        fileSource.cancel(req);
+    }
+
+    // Source::Observer implementation.
+    void onSourceLoaded() override {}
+    void onSourceLoadingFailed(std::exception_ptr) override {}
+
+    void onTileLoaded(bool isNewTile) override {
+        if (isNewTile) {
+            loadedTiles++;
+        }
+        update();
+    }
+
+    void onTileLoadingFailed(std::exception_ptr) override {}
+
+private:
+    void update() {
+        data.setAnimationTime(Clock::now());
+        source.update(data, transform.getState(), *style, texturePool, false);
+
+        if (onLoaded && loadedTiles == requests) {
+            auto callback = std::move(onLoaded);
+            onLoaded = nullptr;
+            callback();
+        }
+    }
+
+    FileSource& fileSource;
+    std::size_t requests = 0;
+    std::size_t loadedTiles = 0;
+
+    MockView view;
+    MapData data;
+    Transform transform;
+    TexturePool texturePool;
+    std::unique_ptr<Style> style;
+    Source source;
+    std::function<void()> onLoaded;
+};
+
+class SourceTest {
+public:
+    SourceTest()
+        : fileSource(MockFileSource::Success, ""),
+          thread({ "Map", util::ThreadType::Map, util::ThreadPriority::Regular }, fileSource) {
+    }
+
+    ~SourceTest() {
+        thread.invokeSync(&SourceThread::cleanup);
+    }
+
+    SourceState moveTo(LatLng latLng, double zoom) {
+        std::promise<void> loaded;
+        thread.invoke(&SourceThread::moveTo, latLng, zoom, [&] { loaded.set_value(); });
+        loaded.get_future().get();
+        return getState();
+    }
+
+    void setParentPrefetchLevels(std::vector<int32_t> levels) {
+        thread.invokeSync(&SourceThread::setParentPrefetchLevels, std::move(levels));
+    }
+
+    SourceState getState() {
+        return thread.invokeSync<SourceState>(&SourceThread::getState);
+    }
+
+private:
+    MockFileSource fileSource;
+    util::Thread<SourceThread> thread;
+};
+
+} // namespace
+
+TEST(Source, ParentPrefetch) {
+    SourceTest test;
+    test.setParentPrefetchLevels({ 2 });
+
+    // The four tiles around the center at z4 have four ancestors at z2.
+    auto state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(4u, state.parents);
+    EXPECT_EQ(8u, state.requests);
+
+    // The ancestors don't take the place of visible tiles once those are loaded.
+    ASSERT_EQ(4u, state.tiles.size());
+    EXPECT_EQ(4u, state.readyTiles);
+    for (const auto& id : state.tiles) {
+        EXPECT_EQ(4, id.z);
+    }
+
+    // They stay loaded while they cover the visible tiles.
+    state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(4u, state.parents);
+    EXPECT_EQ(8u, state.requests);
+
+    // Elsewhere, the four tiles at z4 share a single ancestor, and the others are released.
+    state = test.moveTo({ -60, -135 }, 4);
+    EXPECT_EQ(1u, state.parents);
+    EXPECT_EQ(13u, state.requests);
+
+    // Released ancestors went to the tile cache along with the visible tiles, so that coming back
+    // doesn't load any of them again.
+    const auto cacheHits = state.cacheHits;
+    state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(4u, state.parents);
+    EXPECT_EQ(13u, state.requests);
+    EXPECT_EQ(cacheHits + 8, state.cacheHits);
+}
+
+TEST(Source, ParentPrefetchDisabled) {
+    SourceTest test;
+
+    auto state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(0u, state.parents);
+    EXPECT_EQ(4u, state.requests);
+
+    test.setParentPrefetchLevels({ 2 });
+    state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(4u, state.parents);
+    EXPECT_EQ(8u, state.requests);
+
+    // Turning it off releases the ancestors.
+    test.setParentPrefetchLevels({});
+    state = test.moveTo({ 0, 0 }, 4);
+    EXPECT_EQ(0u, state.parents);
+    EXPECT_EQ(8u, state.requests);
+}
@@ -0,0 +1,100 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class TestTileData : public TileData {
+public:
+    TestTileData(const TileID& id_, std::size_t bytes_)
+        : TileData(id_), bytes(bytes_) {
+        state = State::parsed;
+    }
+
+    void cancel() override {}
+    Bucket* getBucket(const StyleLayer&) override { return nullptr; }
+    std::size_t memoryUsage() const override { return bytes; }
+
+private:
+    const std::size_t bytes;
+};
+
+std::shared_ptr<TileData> makeTile(uint64_t key, std::size_t bytes) {
+    return std::make_shared<TestTileData>(TileID(14, key, 0, 14), bytes);
+}
+
+} // namespace
+
+TEST(TileCache, Count) {
+    TileCache cache(2);
+
+    cache.add(1, makeTile(1, 10));
+    cache.add(2, makeTile(2, 10));
+    cache.add(3, makeTile(3, 10));
+
+    EXPECT_FALSE(cache.has(1));
+    EXPECT_TRUE(cache.has(2));
+    EXPECT_TRUE(cache.has(3));
+    EXPECT_EQ(2u, cache.count());
+    EXPECT_EQ(20u, cache.bytes());
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+}
+
+TEST(TileCache, Bytes) {
+    TileCache cache(10, 100);
+
+    cache.add(1, makeTile(1, 40));
+    cache.add(2, makeTile(2, 40));
+    cache.add(3, makeTile(3, 40));
+
+    EXPECT_FALSE(cache.has(1));
+    EXPECT_EQ(80u, cache.bytes());
+
+    // A tile that's larger than the entire cache evicts everything, including itself.
+    cache.add(4, makeTile(4, 200));
+    EXPECT_EQ(0u, cache.count());
+    EXPECT_EQ(0u, cache.bytes());
+
+    const auto& statistics = cache.getStatistics();
+    EXPECT_EQ(4u, statistics.evictions);
+    EXPECT_EQ(320u, statistics.evictedBytes);
+
+    cache.add(5, makeTile(5, 60));
+    cache.add(6, makeTile(6, 30));
+    cache.setMaxBytes(50);
+    EXPECT_FALSE(cache.has(5));
+    EXPECT_TRUE(cache.has(6));
+}
+
+TEST(TileCache, GetRemoves) {
+    TileCache cache(2);
+
+    const auto tile = makeTile(1, 10);
+    cache.add(1, tile);
+    cache.add(2, makeTile(2, 10));
+
+    EXPECT_EQ(tile, cache.get(1));
+    EXPECT_EQ(nullptr, cache.get(1));
+    EXPECT_FALSE(cache.has(1));
+    EXPECT_EQ(10u, cache.bytes());
+
+    EXPECT_EQ(1u, cache.getStatistics().hits);
+    EXPECT_EQ(1u, cache.getStatistics().misses);
+    EXPECT_EQ(0u, cache.getStatistics().evictions);
+}
+
+TEST(TileCache, ReAddMovesToFront) {
+    TileCache cache(2);
+
+    cache.add(1, makeTile(1, 10));
+    cache.add(2, makeTile(2, 10));
+    cache.add(1, makeTile(1, 20));
+    cache.add(3, makeTile(3, 10));
+
+    EXPECT_TRUE(cache.has(1));
+    EXPECT_FALSE(cache.has(2));
+    EXPECT_TRUE(cache.has(3));
+    EXPECT_EQ(30u, cache.bytes());
+}
@@ -137,3 +137,30 @@ TEST(Transform, PerspectiveProjection) {
     ASSERT_NEAR(point.x, 1000, 0.02);
     ASSERT_NEAR(point.y, 0, 0.02);
 }
+
+TEST(Transform, PrefetchStates) {
+    MockView view;
+    Transform transform(view);
+
+    transform.resize({{ 1000, 1000 }});
+
+    // Changes without animation don't have anything to prefetch.
+    transform.setLatLngZoom({ 0, 0 }, 2);
+    EXPECT_TRUE(transform.takePrefetchStates().empty());
+
+    transform.setLatLngZoom({ 38, -77 }, 10, std::chrono::seconds(1));
+    ASSERT_DOUBLE_EQ(2, transform.getZoom());
+
+    const auto states = transform.takePrefetchStates();
+    ASSERT_EQ(2u, states.size());
+
+    // The destination comes first, followed by the middle of the way.
+    EXPECT_DOUBLE_EQ(10, states[0].getZoom());
+    EXPECT_NEAR(38, states[0].getLatLng().latitude, 0.0001);
+    EXPECT_NEAR(-77, states[0].getLatLng().longitude, 0.0001);
+    EXPECT_LT(2, states[1].getZoom());
+    EXPECT_GT(10, states[1].getZoom());
+
+    // They're only returned once.
+    EXPECT_TRUE(transform.takePrefetchStates().empty());
+}
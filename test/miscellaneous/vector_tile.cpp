@@ -0,0 +1,118 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::string readTile(const std::string& name) {
+    return util::read_file("test/fixtures/tiles/streets/" + name + ".vector.pbf");
+}
+
+VectorTile makeTile(const std::string& data) {
+    return VectorTile(pbf(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+}
+
+} // namespace
+
+TEST(VectorTile, Layers) {
+    const std::string data = readTile("15-17605-10750");
+    const auto tile = makeTile(data);
+
+    ASSERT_EQ(nullptr, tile.getLayer("does-not-exist"));
+
+    const auto road = tile.getLayer("road");
+    ASSERT_NE(nullptr, road);
+    EXPECT_EQ(114u, road->featureCount());
+
+    // Requesting a layer again returns the layer that was parsed first.
+    EXPECT_EQ(road, tile.getLayer("road"));
+
+    const auto building = tile.getLayer("building");
+    ASSERT_NE(nullptr, building);
+    EXPECT_EQ(599u, building->featureCount());
+}
+
+TEST(VectorTile, Features) {
+    const std::string data = readTile("15-17605-10749");
+    const auto tile = makeTile(data);
+
+    const auto road = tile.getLayer("road");
+    ASSERT_NE(nullptr, road);
+
+    std::size_t points = 0;
+    for (std::size_t i = 0; i < road->featureCount(); i++) {
+        const auto& feature = road->getFeature(i);
+        EXPECT_NE(FeatureType::Unknown, feature.getType());
+
+        const auto value = feature.getValue("class");
+        ASSERT_TRUE(bool(value));
+        EXPECT_TRUE(value->is<std::string>());
+
+        EXPECT_FALSE(bool(feature.getValue("does-not-exist")));
+
+        for (const auto& line : feature.getGeometries()) {
+            points += line.size();
+        }
+    }
+    EXPECT_EQ(699u, points);
+
+    // Features are views into the layer and are returned by reference.
+    EXPECT_EQ(&road->getFeature(0), &road->getFeature(0));
+}
+
+TEST(VectorTile, ReadGeometries) {
+    const std::string data = readTile("15-17605-10749");
+    const auto tile = makeTile(data);
+
+    // Reusing the same collection across features must yield the same geometries as decoding
+    // every feature into a fresh collection.
+    GeometryCollection geometries;
+    for (const auto& name : { "building", "road", "water", "poi_label" }) {
+        const auto layer = tile.getLayer(name);
+        ASSERT_NE(nullptr, layer);
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            const auto& feature = layer->getFeature(i);
+            feature.readGeometries(geometries);
+            EXPECT_EQ(feature.getGeometries(), geometries);
+        }
+    }
+}
+
+TEST(VectorTile, CompiledFilter) {
+    const std::string data = readTile("15-17605-10749");
+    const auto tile = makeTile(data);
+
+    const auto road = tile.getLayer("road");
+    ASSERT_NE(nullptr, road);
+
+    const char* filters[] = {
+        R"(["==", "class", "street"])",
+        R"(["!=", "class", "street"])",
+        R"(["in", "class", "main", "street", "service"])",
+        R"(["!in", "class", "main", "street", "service"])",
+        R"(["==", "$type", "LineString"])",
+        R"(["==", "does-not-exist", "street"])",
+        R"(["!=", "does-not-exist", "street"])",
+        R"(["all", ["==", "$type", "LineString"], ["any", ["==", "class", "main"], ["==", "class", "street"]]])",
+        R"(["none", ["==", "class", "main"], ["==", "does-not-exist", 1]])",
+        R"(["all", ["==", "does-not-exist", 1], ["==", "class", "street"]])",
+        R"(["any", ["!in", "does-not-exist", 1], ["==", "class", "street"]])",
+        R"(["in", "class", "a", "b", "c", "d", "e", "f", "g", "main", "street"])",
+    };
+
+    for (const auto json : filters) {
+        rapidjson::Document doc;
+        doc.Parse<0>(json);
+        const FilterExpression filter = parseFilterExpression(doc);
+        const FilterExpression compiled = compileFilterExpression(filter, *road);
+
+        for (std::size_t i = 0; i < road->featureCount(); i++) {
+            GeometryTileFeatureExtractor extractor(road->getFeature(i));
+            EXPECT_EQ(evaluate(filter, extractor), evaluate(compiled, extractor)) << json;
+        }
+    }
+}
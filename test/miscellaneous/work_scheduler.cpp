@@ -0,0 +1,169 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/work_scheduler.hpp>
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace mbgl::util;
+
+namespace {
+
+const ThreadContext context = { "Test", ThreadType::Worker, ThreadPriority::Regular };
+
+// Occupies the only thread of the scheduler until the returned promise is fulfilled.
+std::unique_ptr<mbgl::WorkRequest> block(WorkScheduler& scheduler, std::shared_future<void> release) {
+    std::promise<void> started;
+    auto request = scheduler.invokeWithCallback(WorkPriority::High, [&started, release] (auto after) {
+        started.set_value();
+        release.wait();
+        after();
+    }, [] {});
+    started.get_future().get();
+    return request;
+}
+
+} // namespace
+
+TEST(WorkScheduler, ExecutesAfter) {
+    RunLoop loop(uv_default_loop());
+    WorkScheduler scheduler(context, 2);
+
+    bool didWork = false;
+    bool didAfter = false;
+
+    auto request = scheduler.invokeWithCallback(WorkPriority::Regular, [&] (auto after) {
+        EXPECT_TRUE(ThreadContext::currentlyOn(ThreadType::Worker));
+        didWork = true;
+        after(42);
+    }, [&] (int result) {
+        EXPECT_TRUE(ThreadContext::currentlyOn(ThreadType::Main));
+        EXPECT_EQ(42, result);
+        didAfter = true;
+        loop.stop();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_TRUE(didWork);
+    EXPECT_TRUE(didAfter);
+}
+
+TEST(WorkScheduler, Priorities) {
+    RunLoop loop(uv_default_loop());
+    WorkScheduler scheduler(context, 1);
+
+    std::promise<void> release;
+    auto blocker = block(scheduler, release.get_future().share());
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<std::unique_ptr<mbgl::WorkRequest>> requests;
+
+    auto add = [&] (WorkPriority priority, int id) {
+        requests.push_back(scheduler.invokeWithCallback(priority, [&, id] (auto after) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+            after();
+        }, [] {}));
+    };
+
+    add(WorkPriority::Low, 1);
+    add(WorkPriority::Regular, 2);
+    add(WorkPriority::High, 3);
+    add(WorkPriority::Regular, 4);
+    add(WorkPriority::Low, 5);
+
+    requests.push_back(scheduler.invokeWithCallback(WorkPriority::Low, [] (auto after) {
+        after();
+    }, [&] {
+        loop.stop();
+    }));
+
+    EXPECT_EQ(6u, scheduler.getStatistics().queued);
+
+    release.set_value();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ((std::vector<int>{ 3, 2, 4, 1, 5 }), order);
+
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(0u, statistics.queued);
+    EXPECT_EQ(6u, statistics.maxQueued);
+    EXPECT_EQ(7u, statistics.completed);
+    EXPECT_EQ(0u, statistics.dropped);
+    EXPECT_LE(statistics.maxWait, statistics.totalWait);
+}
+
+TEST(WorkScheduler, DropsCanceledWork) {
+    RunLoop loop(uv_default_loop());
+    WorkScheduler scheduler(context, 1);
+
+    std::promise<void> release;
+    auto blocker = block(scheduler, release.get_future().share());
+
+    auto canceled = scheduler.invokeWithCallback(WorkPriority::High, [] (auto after) {
+        ADD_FAILURE() << "Canceled work should not be invoked";
+        after();
+    }, [] {
+        ADD_FAILURE() << "Canceled callback should not be invoked";
+    });
+
+    auto request = scheduler.invokeWithCallback(WorkPriority::Regular, [] (auto after) {
+        after();
+    }, [&] {
+        loop.stop();
+    });
+
+    canceled.reset();
+    release.set_value();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(2u, statistics.completed);
+    EXPECT_EQ(1u, statistics.dropped);
+}
+
+TEST(WorkScheduler, RaisePriority) {
+    RunLoop loop(uv_default_loop());
+    WorkScheduler scheduler(context, 1);
+
+    std::promise<void> release;
+    auto blocker = block(scheduler, release.get_future().share());
+
+    std::mutex mutex;
+    std::vector<int> order;
+
+    auto add = [&] (WorkPriority priority, int id) {
+        return scheduler.invokeWithCallback(priority, [&, id] (auto after) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+            after();
+        }, [] {});
+    };
+
+    // Tiles that are prefetched are parsed after the visible ones, even if they were queued first.
+    auto prefetched1 = add(WorkPriority::Low, 1);
+    auto prefetched2 = add(WorkPriority::Low, 2);
+    auto visible = add(WorkPriority::Regular, 3);
+    auto placement = add(WorkPriority::High, 4);
+
+    // A prefetched tile became visible; it is parsed in the order it was queued in.
+    scheduler.raisePriority(*prefetched2, WorkPriority::Regular);
+
+    // Priorities are never lowered.
+    scheduler.raisePriority(*placement, WorkPriority::Regular);
+
+    auto last = scheduler.invokeWithCallback(WorkPriority::Low, [] (auto after) {
+        after();
+    }, [&] {
+        loop.stop();
+    });
+
+    release.set_value();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ((std::vector<int>{ 4, 2, 3, 1 }), order);
+}
@@ -2,12 +2,16 @@
 #include "../fixtures/fixture_log_observer.hpp"
 
 #include "sqlite_cache_impl.hpp"
+#include "sqlite3.hpp"
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <sqlite3.h>
 
+#include <random>
+
 TEST_F(Storage, DatabaseDoesNotExist) {
     using namespace mbgl;
 
@@ -318,3 +322,323 @@ TEST_F(Storage, DatabaseInvalid) {
         EXPECT_EQ(1ul, flo->count({ EventSeverity::Warning, Event::Database, -1, "Trashing invalid database" }));
     }
 }
+
+TEST_F(Storage, DatabaseWriteBehind) {
+    using namespace mbgl;
+
+    util::RunLoop loop(uv_default_loop());
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+
+    for (int i = 0; i < 10; i++) {
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>("Demo " + std::to_string(i));
+        response->expires = 100;
+        cache.schedulePut({ Resource::Unknown, "mapbox://test/" + std::to_string(i) }, response);
+    }
+
+    // Writing the same URL again replaces the queued write.
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>("Replaced");
+    cache.schedulePut({ Resource::Unknown, "mapbox://test/0" }, response);
+    cache.scheduleRefresh({ Resource::Unknown, "mapbox://test/1" }, 200);
+
+    auto statistics = cache.getStatistics();
+    EXPECT_EQ(10u, statistics.queued);
+    EXPECT_EQ(10u, statistics.maxQueued);
+    EXPECT_EQ(0u, statistics.commits);
+
+    // Queued writes are visible before they've been committed.
+    cache.get({ Resource::Unknown, "mapbox://test/0" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        ASSERT_TRUE(res->data.get());
+        EXPECT_EQ("Replaced", *res->data);
+    });
+    cache.get({ Resource::Unknown, "mapbox://test/1" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        EXPECT_EQ(200, res->expires);
+    });
+
+    cache.flush();
+
+    statistics = cache.getStatistics();
+    EXPECT_EQ(0u, statistics.queued);
+    EXPECT_EQ(1u, statistics.commits);
+    EXPECT_EQ(10u, statistics.rows);
+    EXPECT_LE(statistics.maxCommitTime, statistics.totalCommitTime);
+
+    // A refresh of a response that has already been committed only updates the expiry date.
+    cache.scheduleRefresh({ Resource::Unknown, "mapbox://test/2" }, 300);
+    cache.get({ Resource::Unknown, "mapbox://test/2" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        ASSERT_TRUE(res->data.get());
+        EXPECT_EQ("Demo 2", *res->data);
+        EXPECT_EQ(300, res->expires);
+    });
+
+    // The queue is committed by a timer when it doesn't fill up.
+    while (cache.getStatistics().commits < 2) {
+        uv_run(uv_default_loop(), UV_RUN_ONCE);
+    }
+
+    cache.get({ Resource::Unknown, "mapbox://test/0" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        ASSERT_TRUE(res->data.get());
+        EXPECT_EQ("Replaced", *res->data);
+    });
+    cache.get({ Resource::Unknown, "mapbox://test/2" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        EXPECT_EQ(300, res->expires);
+    });
+
+    auto observer = Log::removeObserver();
+    EXPECT_EQ(0ul, dynamic_cast<FixtureLogObserver*>(observer.get())->unchecked().size());
+}
+
+TEST_F(Storage, DatabaseWriteBehindBatch) {
+    using namespace mbgl;
+
+    util::RunLoop loop(uv_default_loop());
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+
+    // A full queue is committed right away.
+    const auto count = SQLiteCache::Impl::maxQueuedWrites * 2 + 1;
+    for (std::size_t i = 0; i < count; i++) {
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>("Demo");
+        cache.schedulePut({ Resource::Unknown, "mapbox://test/" + std::to_string(i) }, response);
+    }
+
+    const auto statistics = cache.getStatistics();
+    EXPECT_EQ(1u, statistics.queued);
+    EXPECT_EQ(SQLiteCache::Impl::maxQueuedWrites, statistics.maxQueued);
+    EXPECT_EQ(2u, statistics.commits);
+    EXPECT_EQ(SQLiteCache::Impl::maxQueuedWrites * 2, statistics.rows);
+}
+
+namespace {
+
+// Random data doesn't compress, so every response takes up about as much space as its data.
+std::shared_ptr<mbgl::Response> makeResponse(std::size_t size, int64_t expires = 0) {
+    static std::mt19937 generator;
+    std::string data(size, '\0');
+    for (auto& byte : data) {
+        byte = char(generator());
+    }
+
+    auto response = std::make_shared<mbgl::Response>();
+    response->status = mbgl::Response::Successful;
+    response->data = std::make_shared<std::string>(std::move(data));
+    response->expires = expires;
+    return response;
+}
+
+} // namespace
+
+TEST_F(Storage, DatabaseEviction) {
+    using namespace mbgl;
+
+    util::RunLoop loop(uv_default_loop());
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+    cache.setMaximumSize(0);
+
+    cache.schedulePut({ Resource::Style, "mapbox://style" }, makeResponse(16 * 1024));
+    cache.schedulePut({ Resource::Tile, "mapbox://tiles/expired" }, makeResponse(16 * 1024, 1));
+    for (int i = 0; i < 16; i++) {
+        cache.schedulePut({ Resource::Tile, "mapbox://tiles/" + std::to_string(i) }, makeResponse(16 * 1024));
+    }
+    cache.flush();
+
+    EXPECT_EQ(0u, cache.getStatistics().evictions);
+    const auto size = cache.getUsage().size;
+    EXPECT_LT(18u * 16 * 1024, size);
+
+    // Pretend that the tiles were used in order. Access times are in seconds, so we can't
+    // create them by waiting.
+    {
+        mapbox::sqlite::Database db("test/fixtures/database/cache.db", mapbox::sqlite::ReadWrite);
+        for (int i = 0; i < 16; i++) {
+            db.exec("UPDATE `http_cache` SET `accessed` = " + std::to_string(i + 1) +
+                    " WHERE `url` = 'mapbox://tiles/" + std::to_string(i) + "'");
+        }
+    }
+
+    cache.setMaximumSize(size / 2);
+
+    EXPECT_LE(cache.getUsage().size, size / 2);
+    EXPECT_LT(0u, cache.getStatistics().evictions);
+
+    auto expectCached = [&] (Resource resource, bool cached) {
+        cache.get(resource, [&] (std::unique_ptr<Response> res) {
+            EXPECT_EQ(cached, bool(res)) << resource.url;
+        });
+    };
+
+    // Expired responses are evicted first, then tiles in least recently used order.
+    expectCached({ Resource::Style, "mapbox://style" }, true);
+    expectCached({ Resource::Tile, "mapbox://tiles/expired" }, false);
+    expectCached({ Resource::Tile, "mapbox://tiles/0" }, false);
+    expectCached({ Resource::Tile, "mapbox://tiles/15" }, true);
+}
+
+TEST_F(Storage, DatabaseUsage) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+    cache.put({ Resource::Unknown, "mapbox://test" }, makeResponse(1024));
+
+    cache.get({ Resource::Unknown, "mapbox://test" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_NE(nullptr, res.get());
+    });
+    cache.get({ Resource::Unknown, "mapbox://test" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_NE(nullptr, res.get());
+    });
+    cache.get({ Resource::Unknown, "mapbox://missing" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+
+    const auto usage = cache.getUsage();
+    EXPECT_EQ(2u, usage.hits);
+    EXPECT_EQ(1u, usage.misses);
+    EXPECT_LT(1024u, usage.size);
+}
+
+TEST_F(Storage, DatabaseSchemaUpgrade) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    {
+        // Databases created by older versions don't have an `accessed` column.
+        mapbox::sqlite::Database db("test/fixtures/database/cache.db",
+                                    mapbox::sqlite::ReadWrite | mapbox::sqlite::Create);
+        db.exec("CREATE TABLE `http_cache` (`url` TEXT PRIMARY KEY NOT NULL, `status` INTEGER NOT NULL, "
+                "`kind` INTEGER NOT NULL, `modified` INTEGER, `etag` TEXT, `expires` INTEGER, "
+                "`data` BLOB, `compressed` INTEGER NOT NULL DEFAULT 0);"
+                "INSERT INTO `http_cache` (`url`, `status`, `kind`, `data`) "
+                "VALUES ('mapbox://test', 1, 0, 'Old');");
+    }
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+
+    // The old responses are discarded.
+    cache.get({ Resource::Unknown, "mapbox://test" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>("Demo");
+    cache.put({ Resource::Unknown, "mapbox://test" }, response);
+    cache.get({ Resource::Unknown, "mapbox://test" }, [] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        ASSERT_TRUE(res->data.get());
+        EXPECT_EQ("Demo", *res->data);
+    });
+
+    auto observer = Log::removeObserver();
+    EXPECT_EQ(0ul, dynamic_cast<FixtureLogObserver*>(observer.get())->unchecked().size());
+}
+
+TEST_F(Storage, DatabaseCodecs) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    const auto data = std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10750.vector.pbf"));
+
+    {
+        SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+
+        // Responses stay readable after the codec was changed.
+        for (auto codec : { util::Codec::None, util::Codec::Zlib, util::Codec::Deflate }) {
+            auto response = std::make_shared<Response>();
+            response->data = data;
+            cache.setCodec(codec);
+            cache.put({ Resource::Tile, "mapbox://tiles/" + std::to_string(int(codec)) }, response);
+        }
+
+        for (auto codec : { util::Codec::None, util::Codec::Zlib, util::Codec::Deflate }) {
+            cache.get({ Resource::Tile, "mapbox://tiles/" + std::to_string(int(codec)) }, [&] (std::unique_ptr<Response> res) {
+                ASSERT_NE(nullptr, res.get());
+                ASSERT_TRUE(res->data.get());
+                EXPECT_EQ(*data, *res->data);
+            });
+        }
+    }
+
+    {
+        // Codecs this version doesn't know about are treated as missing responses.
+        mapbox::sqlite::Database db("test/fixtures/database/cache.db", mapbox::sqlite::ReadWrite);
+        db.exec("UPDATE `http_cache` SET `compressed` = 255 WHERE `url` = 'mapbox://tiles/2'");
+
+        // So is data whose size prefix is larger than the compressed data could possibly hold.
+        db.exec("UPDATE `http_cache` SET `compressed` = 2, `data` = X'FFFFFFFF0300' "
+                "WHERE `url` = 'mapbox://tiles/0'");
+    }
+
+    SQLiteCache::Impl cache("test/fixtures/database/cache.db");
+    cache.get({ Resource::Tile, "mapbox://tiles/2" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+    cache.get({ Resource::Tile, "mapbox://tiles/0" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+
+    auto observer = Log::removeObserver();
+    auto flo = dynamic_cast<FixtureLogObserver*>(observer.get());
+    EXPECT_EQ(1ul, flo->count({ EventSeverity::Error, Event::Database, -1, "unknown codec" }));
+    EXPECT_EQ(1ul, flo->count({ EventSeverity::Error, Event::Database, -1, "decompression error" }));
+    EXPECT_EQ(0ul, flo->unchecked().size());
+}
+
+TEST_F(Storage, DatabaseSetCodec) {
+    using namespace mbgl;
+
+    util::RunLoop loop(uv_default_loop());
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/cache.db");
+
+    const auto data = std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10750.vector.pbf"));
+
+    {
+        SQLiteCache cache("test/fixtures/database/cache.db");
+        cache.setCodec(util::Codec::None);
+
+        auto response = std::make_shared<Response>();
+        response->data = data;
+        cache.put({ Resource::Tile, "mapbox://tiles/0" }, response, FileCache::Hint::Full);
+        cache.flush();
+    }
+
+    // The codec is applied on the cache thread.
+    mapbox::sqlite::Database db("test/fixtures/database/cache.db", mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = db.prepare("SELECT `compressed`, length(`data`) FROM `http_cache`");
+    ASSERT_TRUE(stmt.run());
+    EXPECT_EQ(int(util::Codec::None), stmt.get<int>(0));
+    EXPECT_EQ(int64_t(data->size()), stmt.get<int64_t>(1));
+}
@@ -35,4 +35,10 @@ TEST_F(Storage, HTTPTimeout) {
     uv_run(uv_default_loop(), UV_RUN_DEFAULT);
 
     EXPECT_EQ(4, counter);
+
+    // The response was revalidated by the expiry timer, which stopped tracking it when canceled.
+    const auto statistics = fs.getStatistics();
+    EXPECT_LE(1u, statistics.expiry.wakeups);
+    EXPECT_LE(1u, statistics.expiry.revalidations);
+    EXPECT_EQ(0u, statistics.expiry.pending);
 }
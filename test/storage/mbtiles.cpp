@@ -0,0 +1,139 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/map/tile_id.hpp>
+
+#include <rapidjson/document.h>
+
+namespace {
+
+const std::string archive = "mbtiles://test/fixtures/storage/region.mbtiles";
+
+}
+
+TEST_F(Storage, MBTilesTileJSON) {
+    SCOPED_TEST(TileJSON)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    Request* req = fs.request({ Resource::Source, archive }, uv_default_loop(), [&](const Response &res) {
+        fs.cancel(req);
+        EXPECT_EQ(Response::Successful, res.status);
+        ASSERT_TRUE(res.data.get());
+
+        rapidjson::Document doc;
+        doc.Parse<0>(res.data->c_str());
+        ASSERT_FALSE(doc.HasParseError());
+
+        SourceInfo info;
+        info.parseTileJSONProperties(doc);
+        ASSERT_EQ(1u, info.tiles.size());
+        EXPECT_EQ(archive + "/{z}/{x}/{y}", info.tiles[0]);
+        EXPECT_EQ(archive + "/1/0/0", info.tileURL(TileID(1, 0, 0, 1), 1));
+        EXPECT_EQ(0, info.min_zoom);
+        EXPECT_EQ(1, info.max_zoom);
+        EXPECT_EQ("<a href=\"https://example.com\">Example</a>", info.attribution);
+        EXPECT_FLOAT_EQ(-122.5f, info.bounds[0]);
+        EXPECT_FLOAT_EQ(37.8f, info.bounds[3]);
+        EXPECT_FLOAT_EQ(1.0f, info.center[2]);
+        TileJSON.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesTile) {
+    SCOPED_TEST(CompressedTile)
+    SCOPED_TEST(UncompressedTile)
+    SCOPED_TEST(MissingTile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    Request* req1 = fs.request({ Resource::Tile, archive + "/0/0/0" }, uv_default_loop(), [&](const Response &res) {
+        fs.cancel(req1);
+        EXPECT_EQ(Response::Successful, res.status);
+        ASSERT_TRUE(res.data.get());
+        // gzip compression is removed transparently.
+        EXPECT_EQ("compressed tile", *res.data);
+        EXPECT_EQ(0, res.expires);
+        CompressedTile.finish();
+    });
+
+    // Rows are flipped, since MBTiles uses the TMS scheme.
+    Request* req2 = fs.request({ Resource::Tile, archive + "/1/0/0" }, uv_default_loop(), [&](const Response &res) {
+        fs.cancel(req2);
+        EXPECT_EQ(Response::Successful, res.status);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("uncompressed tile", *res.data);
+        UncompressedTile.finish();
+    });
+
+    Request* req3 = fs.request({ Resource::Tile, archive + "/1/0/1" }, uv_default_loop(), [&](const Response &res) {
+        fs.cancel(req3);
+        EXPECT_EQ(Response::NotFound, res.status);
+        EXPECT_FALSE(res.data.get());
+        MissingTile.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesMissingArchive) {
+    SCOPED_TEST(MissingArchive)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    Request* req = fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/missing.mbtiles/0/0/0" },
+                              uv_default_loop(), [&](const Response &res) {
+        fs.cancel(req);
+        EXPECT_EQ(Response::Error, res.status);
+        EXPECT_FALSE(res.data.get());
+        EXPECT_NE("", res.message);
+        MissingArchive.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesInvalidTile) {
+    SCOPED_TEST(InvalidTile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    // Zoom levels out of range, and columns or rows that don't exist at the zoom level.
+    const std::vector<std::string> urls = {
+        archive + "/-1/0/0",
+        archive + "/31/0/0",
+        archive + "/4294967297/0/0",
+        archive + "/1/2/0",
+        archive + "/1/0/-1",
+    };
+
+    std::size_t remaining = urls.size();
+    std::vector<Request*> requests;
+    for (const auto& url : urls) {
+        requests.push_back(fs.request({ Resource::Tile, url }, uv_default_loop(), [&, url](const Response &res) {
+            EXPECT_EQ(Response::Error, res.status) << url;
+            EXPECT_EQ("Invalid MBTiles tile URL", res.message) << url;
+            if (--remaining == 0) {
+                for (auto req : requests) {
+                    fs.cancel(req);
+                }
+                InvalidTile.finish();
+            }
+        }));
+    }
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
@@ -0,0 +1,147 @@
+#include "../fixtures/util.hpp"
+#include "../fixtures/mock_file_source.hpp"
+
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/sqlite_cache.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+// Counts the requests that reach the wrapped file source.
+class CountingFileSource : public FileSource {
+public:
+    explicit CountingFileSource(FileSource& fileSource_) : fileSource(fileSource_) {}
+
+    Request* request(const Resource& resource, uv_loop_t* loop, Callback callback) override {
+        requests++;
+        return fileSource.request(resource, loop, std::move(callback));
+    }
+
+    void cancel(Request* req) override {
+        fileSource.cancel(req);
+    }
+
+    FileSource& fileSource;
+    std::size_t requests = 0;
+};
+
+OfflineRegion makeRegion() {
+    OfflineRegion region;
+    region.styleURL = "test/fixtures/resources/style.json";
+    region.bounds = { { 37.7, -122.5 }, { 37.8, -122.4 } };
+    region.minZoom = 0;
+    region.maxZoom = 2;
+    return region;
+}
+
+OfflineDownload::Progress download(const std::string& pack, FileSource& fileSource, FileCache& cache,
+                                   const OfflineRegion& region = makeRegion()) {
+    util::RunLoop loop(uv_default_loop());
+
+    OfflineDownload::Progress result;
+    OfflineDownload offline(pack, region, fileSource, cache, [&] (const OfflineDownload::Progress& progress) {
+        EXPECT_LE(progress.completedResources + progress.failedResources, progress.requiredResources);
+        result = progress;
+        if (progress.complete) {
+            loop.stop();
+        }
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    return result;
+}
+
+std::vector<std::string> getPack(const std::string& pack, FileCache& cache) {
+    util::RunLoop loop(uv_default_loop());
+
+    std::vector<std::string> result;
+    auto request = cache.getPack(pack, [&] (std::vector<std::string> urls) {
+        result = std::move(urls);
+        std::sort(result.begin(), result.end());
+        loop.stop();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    return result;
+}
+
+} // namespace
+
+TEST(OfflineDownload, Download) {
+    MockFileSource fileSource(MockFileSource::Success, "");
+    SQLiteCache cache(":memory:");
+
+    const auto progress = download("region", fileSource, cache);
+    EXPECT_TRUE(progress.complete);
+    EXPECT_EQ(0u, progress.failedResources);
+    EXPECT_LT(0u, progress.completedBytes);
+
+    // The style, two TileJSON documents, the sprite image and metadata, all glyph ranges of the
+    // only font stack, three vector tiles at z0-2 and three raster tiles at z1-3, since the
+    // raster source has 256px tiles.
+    EXPECT_EQ(1u + 2 + 2 + 256 + 3 + 3, progress.requiredResources);
+    EXPECT_EQ(progress.requiredResources, progress.completedResources);
+
+    // All tiles and glyph ranges of the fixture share the same file.
+    EXPECT_EQ((std::vector<std::string>{
+        "test/fixtures/resources/glyphs.pbf",
+        "test/fixtures/resources/raster.png",
+        "test/fixtures/resources/source_raster.json",
+        "test/fixtures/resources/source_vector.json",
+        "test/fixtures/resources/sprite.json",
+        "test/fixtures/resources/sprite.png",
+        "test/fixtures/resources/style.json",
+        "test/fixtures/resources/vector.pbf",
+    }), getPack("region", cache));
+}
+
+TEST(OfflineDownload, Resume) {
+    SQLiteCache cache(":memory:");
+
+    {
+        MockFileSource fileSource(MockFileSource::Success, "");
+        download("region", fileSource, cache);
+    }
+
+    // Resources that are in the pack already aren't requested again, except for the style and
+    // the TileJSON documents, which have to be parsed.
+    MockFileSource fileSource(MockFileSource::RequestFail, ".pbf");
+    CountingFileSource counter(fileSource);
+
+    auto progress = download("region", counter, cache);
+    EXPECT_TRUE(progress.complete);
+    EXPECT_EQ(0u, progress.failedResources);
+    EXPECT_EQ(progress.requiredResources, progress.completedResources);
+    EXPECT_EQ(3u, counter.requests);
+
+    progress = download("other", fileSource, cache);
+    EXPECT_TRUE(progress.complete);
+    EXPECT_EQ(256u + 3, progress.failedResources);
+    EXPECT_EQ(6u, getPack("other", cache).size());
+
+    cache.removePack("region");
+    EXPECT_EQ(0u, getPack("region", cache).size());
+}
+
+TEST(OfflineDownload, Antimeridian) {
+    MockFileSource fileSource(MockFileSource::Success, "");
+    SQLiteCache cache(":memory:");
+
+    OfflineRegion region = makeRegion();
+    region.bounds = { { -10, 170 }, { 10, -170 } };
+
+    const auto progress = download("region", fileSource, cache, region);
+    EXPECT_TRUE(progress.complete);
+    EXPECT_EQ(0u, progress.failedResources);
+
+    // The region spans one column at z0 and both columns at z1. At higher zoom levels it spans
+    // the last and the first column, each with two rows: 1 + 4 + 4 vector tiles at z0-2 and
+    // 4 + 4 + 4 raster tiles at z1-3.
+    EXPECT_EQ(1u + 2 + 2 + 256 + 9 + 12, progress.requiredResources);
+    EXPECT_EQ(progress.requiredResources, progress.completedResources);
+}
@@ -0,0 +1,123 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/storage/request_scheduler.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+using Category = RequestScheduler::Category;
+
+class Requests {
+public:
+    Requests(std::size_t maxActive, std::size_t maxActivePerHost)
+        : scheduler(maxActive, maxActivePerHost) {}
+
+    void add(int id, const std::string& url, Category category, double rank = 0) {
+        scheduler.add(key(id), url, { category, rank }, [this, id] {
+            started.push_back(id);
+        });
+    }
+
+    void update(int id, Category category, double rank) {
+        scheduler.update(key(id), { category, rank });
+    }
+
+    void finish(int id) {
+        scheduler.finished(key(id));
+    }
+
+    static RequestScheduler::Key key(int id) {
+        return reinterpret_cast<RequestScheduler::Key>(static_cast<uintptr_t>(id));
+    }
+
+    RequestScheduler scheduler;
+    std::vector<int> started;
+};
+
+} // namespace
+
+TEST(RequestScheduler, Priorities) {
+    Requests requests(1, 1);
+
+    requests.add(1, "http://a.com/1", Category::Tile);
+    requests.add(2, "http://a.com/2", Category::Prefetch);
+    requests.add(3, "http://a.com/3", Category::Tile, 2);
+    requests.add(4, "http://a.com/4", Category::Tile, 1);
+    requests.add(5, "http://a.com/5", Category::Resource);
+    requests.add(6, "http://a.com/6", Category::Style);
+    requests.add(7, "http://a.com/7", Category::Tile, 1);
+
+    EXPECT_EQ(std::vector<int>({ 1 }), requests.started);
+    for (int id : { 1, 6, 5, 4, 7, 3 }) {
+        requests.finish(id);
+    }
+    EXPECT_EQ(std::vector<int>({ 1, 6, 5, 4, 7, 3, 2 }), requests.started);
+
+    const auto statistics = requests.scheduler.getStatistics();
+    EXPECT_EQ(0u, statistics.queued);
+    EXPECT_EQ(6u, statistics.maxQueued);
+    EXPECT_EQ(1u, statistics.active);
+    EXPECT_EQ(1u, statistics.style.started);
+    EXPECT_EQ(1u, statistics.resources.started);
+    EXPECT_EQ(4u, statistics.tiles.started);
+    EXPECT_EQ(1u, statistics.prefetch.started);
+    EXPECT_LE(statistics.tiles.max, statistics.tiles.total);
+}
+
+TEST(RequestScheduler, Reprioritize) {
+    Requests requests(1, 1);
+
+    requests.add(1, "http://a.com/1", Category::Tile, 0);
+    requests.add(2, "http://a.com/2", Category::Tile, 1);
+    requests.add(3, "http://a.com/3", Category::Tile, 2);
+
+    // The map moved while the requests were waiting.
+    requests.update(3, Category::Tile, 0);
+    requests.update(2, Category::Prefetch, 1);
+
+    // Neither started or unknown requests are affected.
+    requests.update(1, Category::Prefetch, 5);
+    requests.update(8, Category::Style, 0);
+
+    requests.finish(1);
+    requests.finish(3);
+    EXPECT_EQ(std::vector<int>({ 1, 3, 2 }), requests.started);
+    EXPECT_EQ(0u, requests.scheduler.getStatistics().queued);
+}
+
+TEST(RequestScheduler, HostLimit) {
+    Requests requests(3, 2);
+
+    requests.add(1, "http://a.com/1", Category::Tile);
+    requests.add(2, "http://a.com:8080/2", Category::Tile);
+    requests.add(3, "http://a.com/3", Category::Tile);
+    requests.add(4, "http://a.com/4", Category::Style);
+    requests.add(5, "https://b.com/5", Category::Tile);
+
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), requests.started);
+
+    // The style is more important, but its host has no connection left.
+    requests.finish(2);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3, 5 }), requests.started);
+
+    requests.finish(3);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3, 5, 4 }), requests.started);
+}
+
+TEST(RequestScheduler, Remove) {
+    Requests requests(1, 1);
+
+    requests.add(1, "http://a.com/1", Category::Tile);
+    requests.add(2, "http://a.com/2", Category::Tile);
+    requests.add(3, "http://a.com/3", Category::Tile);
+    EXPECT_EQ(2u, requests.scheduler.getStatistics().queued);
+
+    requests.scheduler.remove(Requests::key(2));
+    EXPECT_EQ(1u, requests.scheduler.getStatistics().queued);
+
+    requests.finish(1);
+    EXPECT_EQ(std::vector<int>({ 1, 3 }), requests.started);
+}
@@ -0,0 +1,134 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/response_cache.hpp>
+#include <mbgl/storage/response.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::shared_ptr<const Response> response(std::size_t size) {
+    auto res = std::make_shared<Response>();
+    res->status = Response::Successful;
+    res->data = std::make_shared<std::string>(size, '\0');
+    return res;
+}
+
+Resource tile(const std::string& path) {
+    return { Resource::Tile, "http://example.com/" + path };
+}
+
+} // namespace
+
+TEST(ResponseCache, LeastRecentlyUsed) {
+    const auto a = response(1000);
+    ResponseCache cache;
+
+    // Room for three responses of the same size.
+    cache.add(tile("a"), a);
+    cache.setMaxBytes(3 * cache.bytes());
+    cache.add(tile("b"), response(1000));
+    cache.add(tile("c"), response(1000));
+    EXPECT_EQ(3u, cache.count());
+
+    // Using "a" makes "b" the least recently used response.
+    EXPECT_EQ(a, cache.get(tile("a")));
+    cache.add(tile("d"), response(1000));
+    EXPECT_EQ(3u, cache.count());
+    EXPECT_EQ(nullptr, cache.get(tile("b")));
+    EXPECT_NE(nullptr, cache.get(tile("c")));
+    EXPECT_NE(nullptr, cache.get(tile("d")));
+
+    // The same URL as a different kind of resource is a different entry.
+    EXPECT_EQ(nullptr, cache.get({ Resource::Source, tile("a").url }));
+
+    const auto usage = cache.getUsage();
+    EXPECT_EQ(cache.bytes(), usage.size);
+    EXPECT_EQ(3u, usage.hits);
+    EXPECT_EQ(2u, usage.misses);
+}
+
+TEST(ResponseCache, Bytes) {
+    ResponseCache cache(100000);
+
+    cache.add(tile("a"), response(40000));
+    cache.add(tile("b"), response(40000));
+    const std::size_t bytes = cache.bytes();
+    EXPECT_LT(80000u, bytes);
+
+    // Replacing a response doesn't count it twice.
+    cache.add(tile("b"), response(40000));
+    EXPECT_EQ(bytes, cache.bytes());
+    EXPECT_EQ(2u, cache.count());
+
+    // Too large to keep both.
+    cache.add(tile("c"), response(50000));
+    EXPECT_EQ(2u, cache.count());
+    EXPECT_EQ(nullptr, cache.get(tile("a")));
+    EXPECT_GE(100000u, cache.bytes());
+
+    // Responses that exceed the limit on their own aren't kept at all.
+    cache.add(tile("d"), response(200000));
+    EXPECT_EQ(0u, cache.count());
+    EXPECT_EQ(0u, cache.bytes());
+
+    cache.add(tile("a"), response(40000));
+    cache.add(tile("b"), response(40000));
+    cache.setMaxBytes(50000);
+    EXPECT_EQ(1u, cache.count());
+    EXPECT_NE(nullptr, cache.get(tile("b")));
+}
+
+TEST_F(Storage, ResponseCacheFileSource) {
+    SCOPED_TEST(Memory)
+
+    DefaultFileSource fs(nullptr);
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/cache" };
+
+    std::shared_ptr<const std::string> data;
+    Request* req2 = nullptr;
+
+    Request* req1 = fs.request(resource, uv_default_loop(), [&](const Response& res) {
+        fs.cancel(req1);
+        EXPECT_EQ(Response::Successful, res.status);
+        data = res.data;
+
+        // The first request is gone, but its response is still in memory. The server would
+        // respond with different data.
+        req2 = fs.request(resource, uv_default_loop(), [&](const Response& res2) {
+            fs.cancel(req2);
+            EXPECT_EQ(Response::Successful, res2.status);
+            EXPECT_EQ(data, res2.data);
+
+            const auto usage = fs.getMemoryCacheUsage();
+            EXPECT_EQ(1u, usage.hits);
+            EXPECT_EQ(1u, usage.misses);
+            EXPECT_LT(data->size(), usage.size);
+            Memory.finish();
+        });
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, ResponseCacheLocalFiles) {
+    SCOPED_TEST(LocalFiles)
+
+    DefaultFileSource fs(nullptr);
+    const Resource resource { Resource::Tile, "mbtiles://test/fixtures/storage/region.mbtiles/0/0/0" };
+
+    Request* req = fs.request(resource, uv_default_loop(), [&](const Response& res) {
+        fs.cancel(req);
+        EXPECT_EQ(Response::Successful, res.status);
+
+        // Archives are on disk already; keeping their tiles in memory as well would only push
+        // out responses that came from the network.
+        EXPECT_EQ(0u, fs.getMemoryCacheUsage().size);
+        LocalFiles.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
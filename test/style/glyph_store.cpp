@@ -110,9 +110,8 @@ TEST_F(GlyphStoreTest, LoadingSuccess) {
         ASSERT_FALSE(store->hasGlyphRanges("Foobar", {{512, 767}}));
         ASSERT_FALSE(store->hasGlyphRanges("Test Stack",  {{512, 767}}));
 
-        auto fontStack = store->getFontStack(params.stack);
-        ASSERT_FALSE(fontStack->getMetrics().empty());
-        ASSERT_FALSE(fontStack->getSDFs().empty());
+        const FontStack& fontStack = store->getFontStack(params.stack);
+        ASSERT_FALSE(fontStack.empty());
 
         stopTest();
     };
@@ -137,9 +136,8 @@ TEST_F(GlyphStoreTest, LoadingFail) {
 
         ASSERT_TRUE(error != nullptr);
 
-        auto fontStack = store->getFontStack(params.stack);
-        ASSERT_TRUE(fontStack->getMetrics().empty());
-        ASSERT_TRUE(fontStack->getSDFs().empty());
+        const FontStack& fontStack = store->getFontStack(params.stack);
+        ASSERT_TRUE(fontStack.empty());
 
         for (const auto& range : params.ranges) {
             ASSERT_FALSE(store->hasGlyphRanges(params.stack, {range}));
@@ -172,9 +170,8 @@ TEST_F(GlyphStoreTest, LoadingCorrupted) {
 
         ASSERT_TRUE(error != nullptr);
 
-        auto fontStack = store->getFontStack(params.stack);
-        ASSERT_TRUE(fontStack->getMetrics().empty());
-        ASSERT_TRUE(fontStack->getSDFs().empty());
+        const FontStack& fontStack = store->getFontStack(params.stack);
+        ASSERT_TRUE(fontStack.empty());
 
         for (const auto& range : params.ranges) {
             ASSERT_FALSE(store->hasGlyphRanges(params.stack, {range}));
@@ -219,9 +216,8 @@ TEST_F(GlyphStoreTest, InvalidURL) {
     auto callback = [this, &params](GlyphStore* store, std::exception_ptr error) {
         ASSERT_TRUE(error != nullptr);
 
-        auto fontStack = store->getFontStack(params.stack);
-        ASSERT_TRUE(fontStack->getMetrics().empty());
-        ASSERT_TRUE(fontStack->getSDFs().empty());
+        const FontStack& fontStack = store->getFontStack(params.stack);
+        ASSERT_TRUE(fontStack.empty());
 
         stopTest();
     };
@@ -229,3 +225,77 @@ TEST_F(GlyphStoreTest, InvalidURL) {
     MockFileSource fileSource(MockFileSource::Success, "");
     runTest(params, &fileSource, callback);
 }
+
+TEST(FontStack, SharesRanges) {
+    SDFGlyph glyph;
+    glyph.id = 'a';
+    glyph.metrics.advance = 10;
+
+    FontStack first;
+    first.insert('a', glyph);
+    first.addRange({0, 255});
+
+    // Inserting into a copy leaves the original untouched.
+    FontStack second = first;
+    glyph.id = 'b';
+    second.insert('b', glyph);
+    glyph.id = 0x100;
+    second.insert(0x100, glyph);
+
+    EXPECT_TRUE(first.getGlyph('a'));
+    EXPECT_FALSE(first.getGlyph('b'));
+    EXPECT_FALSE(first.getGlyph(0x100));
+    EXPECT_TRUE(second.getGlyph('a'));
+    EXPECT_TRUE(second.getGlyph('b'));
+    EXPECT_TRUE(second.getGlyph(0x100));
+
+    EXPECT_TRUE(second.hasRange({0, 255}));
+    EXPECT_FALSE(second.hasRange({256, 511}));
+}
+
+namespace {
+
+class SnapshotThread {
+public:
+    void publish(uint32_t id) {
+        FontStack snapshot = store.getFontStack("Test Stack");
+        SDFGlyph glyph;
+        glyph.id = id;
+        snapshot.insert(id, glyph);
+        snapshot.addRange(getGlyphRange(id));
+        store.setFontStack("Test Stack", std::move(snapshot));
+    }
+
+    GlyphStore* get() {
+        return &store;
+    }
+
+private:
+    GlyphStore store;
+};
+
+} // namespace
+
+TEST(GlyphStore, Snapshots) {
+    const util::ThreadContext context = {"Map", util::ThreadType::Map, util::ThreadPriority::Regular};
+    util::Thread<SnapshotThread> thread(context);
+    GlyphStore& store = *thread.invokeSync<GlyphStore*>(&SnapshotThread::get);
+
+    const FontStack& empty = store.getFontStack("Test Stack");
+    EXPECT_TRUE(empty.empty());
+
+    thread.invokeSync(&SnapshotThread::publish, uint32_t('a'));
+    const FontStack& first = store.getFontStack("Test Stack");
+    EXPECT_TRUE(store.hasGlyphRanges("Test Stack", {{0, 255}}));
+
+    thread.invokeSync(&SnapshotThread::publish, uint32_t(0x100));
+    const FontStack& second = store.getFontStack("Test Stack");
+    EXPECT_TRUE(store.hasGlyphRanges("Test Stack", {{0, 255}, {256, 511}}));
+
+    // Earlier snapshots stay valid and unchanged.
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(first.getGlyph('a'));
+    EXPECT_FALSE(first.getGlyph(0x100));
+    EXPECT_TRUE(second.getGlyph('a'));
+    EXPECT_TRUE(second.getGlyph(0x100));
+}